@@ -166,18 +166,31 @@ void     WIZCHIP_WRITE_BUF(uint32_t AddrSel, uint8_t* pBuf, uint16_t len)
 }
 
 
+// Read a 16-bit big-endian socket register in a single SPI frame, so both
+// bytes come from the same snapshot and each poll costs one CS cycle.
+static uint16_t WIZCHIP_READ_U16(uint32_t AddrSel)
+{
+   uint8_t buf[2];
+   WIZCHIP_READ_BUF(AddrSel, buf, 2);
+   return ((uint16_t)buf[0] << 8) | buf[1];
+}
+
+static void WIZCHIP_WRITE_U16(uint32_t AddrSel, uint16_t val)
+{
+   uint8_t buf[2] = {(uint8_t)(val >> 8), (uint8_t)val};
+   WIZCHIP_WRITE_BUF(AddrSel, buf, 2);
+}
+
 uint16_t getSn_TX_FSR(uint8_t sn)
 {
    uint16_t val=0,val1=0;
 
    do
    {
-      val1 = WIZCHIP_READ(Sn_TX_FSR(sn));
-      val1 = (val1 << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_TX_FSR(sn),1));
+      val1 = WIZCHIP_READ_U16(Sn_TX_FSR(sn));
       if (val1 != 0)
       {
-        val = WIZCHIP_READ(Sn_TX_FSR(sn));
-        val = (val << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_TX_FSR(sn),1));
+        val = WIZCHIP_READ_U16(Sn_TX_FSR(sn));
       }
    }while (val != val1);
    return val;
@@ -190,12 +203,10 @@ uint16_t getSn_RX_RSR(uint8_t sn)
 
    do
    {
-      val1 = WIZCHIP_READ(Sn_RX_RSR(sn));
-      val1 = (val1 << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_RX_RSR(sn),1));
+      val1 = WIZCHIP_READ_U16(Sn_RX_RSR(sn));
       if (val1 != 0)
       {
-        val = WIZCHIP_READ(Sn_RX_RSR(sn));
-        val = (val << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_RX_RSR(sn),1));
+        val = WIZCHIP_READ_U16(Sn_RX_RSR(sn));
       }
    }while (val != val1);
    return val;
@@ -207,7 +218,7 @@ void wiz_send_data(uint8_t sn, uint8_t *wizdata, uint16_t len)
    uint32_t addrsel = 0;
 
    if(len == 0)  return;
-   ptr = getSn_TX_WR(sn);
+   ptr = WIZCHIP_READ_U16(Sn_TX_WR(sn));
    //M20140501 : implict type casting -> explict type casting
    //addrsel = (ptr << 8) + (WIZCHIP_TXBUF_BLOCK(sn) << 3);
    addrsel = ((uint32_t)ptr << 8) + (WIZCHIP_TXBUF_BLOCK(sn) << 3);
@@ -215,7 +226,7 @@ void wiz_send_data(uint8_t sn, uint8_t *wizdata, uint16_t len)
    WIZCHIP_WRITE_BUF(addrsel,wizdata, len);
    
    ptr += len;
-   setSn_TX_WR(sn,ptr);
+   WIZCHIP_WRITE_U16(Sn_TX_WR(sn), ptr);
 }
 
 void wiz_recv_data(uint8_t sn, uint8_t *wizdata, uint16_t len)
@@ -224,15 +235,15 @@ void wiz_recv_data(uint8_t sn, uint8_t *wizdata, uint16_t len)
    uint32_t addrsel = 0;
    
    if(len == 0) return;
-   ptr = getSn_RX_RD(sn);
+   ptr = WIZCHIP_READ_U16(Sn_RX_RD(sn));
    //M20140501 : implict type casting -> explict type casting
    //addrsel = ((ptr << 8) + (WIZCHIP_RXBUF_BLOCK(sn) << 3);
    addrsel = ((uint32_t)ptr << 8) + (WIZCHIP_RXBUF_BLOCK(sn) << 3);
    //
    WIZCHIP_READ_BUF(addrsel, wizdata, len);
    ptr += len;
-   
-   setSn_RX_RD(sn,ptr);
+
+   WIZCHIP_WRITE_U16(Sn_RX_RD(sn), ptr);
 }
 
 
@@ -261,6 +261,111 @@ STATIC void fill_rect(const mp_obj_framebuf_t *fb, int x, int y, int w, int h, u
     formats[fb->format].fill_rect(fb, x, y, xend - x, yend - y, col);
 }
 
+// Row kernels used by blit and scroll.  Horizontally packed formats store
+// each row contiguously, so runs of whole bytes can be moved with memmove
+// rather than through the per-pixel getpixel/setpixel function pointers.
+
+// Returns the number of bits per pixel of a horizontally packed format, or 0
+// for MVLSB, whose pixels are packed vertically.
+STATIC uint8_t horiz_bpp(const mp_obj_framebuf_t *fb) {
+    switch (fb->format) {
+        case FRAMEBUF_RGB565:
+            return 16;
+        case FRAMEBUF_GS8:
+            return 8;
+        case FRAMEBUF_GS4_HMSB:
+            return 4;
+        case FRAMEBUF_GS2_HMSB:
+            return 2;
+        case FRAMEBUF_MHLSB:
+        case FRAMEBUF_MHMSB:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static inline uint8_t *horiz_pixel_ptr(const mp_obj_framebuf_t *fb, int x, int y, uint8_t bpp) {
+    return &((uint8_t*)fb->buf)[(((size_t)y * fb->stride + x) * bpp) >> 3];
+}
+
+// Copy a span of w pixels between two framebuffers of the same horizontally
+// packed format.  The source and destination may be the same row.
+STATIC void copy_span(const mp_obj_framebuf_t *dest, int xd, int yd, const mp_obj_framebuf_t *src, int xs, int ys, int w) {
+    uint8_t bpp = horiz_bpp(dest);
+    int ppb = bpp < 8 ? 8 / bpp : 1;
+    int whole = 0;
+    if (xd % ppb == 0 && xs % ppb == 0) {
+        whole = w - w % ppb;
+    }
+    // Pixels that don't fill a byte are copied one at a time, ordered so that
+    // an overlapping source is read before it is overwritten.
+    if (xd > xs) {
+        for (int i = w - 1; i >= whole; --i) {
+            setpixel(dest, xd + i, yd, getpixel(src, xs + i, ys));
+        }
+        memmove(horiz_pixel_ptr(dest, xd, yd, bpp), horiz_pixel_ptr(src, xs, ys, bpp), (whole * bpp) >> 3);
+    } else {
+        memmove(horiz_pixel_ptr(dest, xd, yd, bpp), horiz_pixel_ptr(src, xs, ys, bpp), (whole * bpp) >> 3);
+        for (int i = whole; i < w; ++i) {
+            setpixel(dest, xd + i, yd, getpixel(src, xs + i, ys));
+        }
+    }
+}
+
+// Convert a span of w pixels from a source with at most 16 colours into
+// RGB565, mapping each colour through lut and skipping the key colour.
+STATIC void convert_span_rgb565(uint16_t *dest, const mp_obj_framebuf_t *src, int xs, int ys, int w, const uint32_t *lut, uint32_t key) {
+    uint32_t col;
+    switch (src->format) {
+        case FRAMEBUF_MVLSB: {
+            const uint8_t *b = &((uint8_t*)src->buf)[(ys >> 3) * src->stride + xs];
+            uint8_t offset = ys & 0x07;
+            for (; w--; ++dest) {
+                col = lut[(*b++ >> offset) & 0x01];
+                if (col != key) {
+                    *dest = col;
+                }
+            }
+            break;
+        }
+        case FRAMEBUF_MHLSB:
+        case FRAMEBUF_MHMSB: {
+            const uint8_t *b = horiz_pixel_ptr(src, 0, ys, 1);
+            bool reverse = src->format == FRAMEBUF_MHMSB;
+            for (; w--; ++xs, ++dest) {
+                int offset = reverse ? xs & 0x07 : 7 - (xs & 0x07);
+                col = lut[(b[xs >> 3] >> offset) & 0x01];
+                if (col != key) {
+                    *dest = col;
+                }
+            }
+            break;
+        }
+        case FRAMEBUF_GS2_HMSB: {
+            const uint8_t *b = horiz_pixel_ptr(src, 0, ys, 2);
+            for (; w--; ++xs, ++dest) {
+                col = lut[(b[xs >> 2] >> ((xs & 0x3) << 1)) & 0x3];
+                if (col != key) {
+                    *dest = col;
+                }
+            }
+            break;
+        }
+        case FRAMEBUF_GS4_HMSB: {
+            const uint8_t *b = horiz_pixel_ptr(src, 0, ys, 4);
+            for (; w--; ++xs, ++dest) {
+                uint8_t pair = b[xs >> 1];
+                col = lut[(xs % 2) ? pair & 0x0f : pair >> 4];
+                if (col != key) {
+                    *dest = col;
+                }
+            }
+            break;
+        }
+    }
+}
+
 STATIC mp_obj_t framebuf_make_new(const mp_obj_type_t *type, size_t n_args, const mp_obj_t *args, mp_map_t *kw_args) {
     mp_arg_check_num(n_args, kw_args, 4, 5, false);
 
@@ -469,6 +574,15 @@ STATIC mp_obj_t framebuf_line(size_t n_args, const mp_obj_t *args) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(framebuf_line_obj, 6, 6, framebuf_line);
 
+// Look up a colour in a palette framebuffer, whose first row holds the
+// colour for each index.
+static inline uint32_t palette_lookup(const mp_obj_framebuf_t *palette, uint32_t col) {
+    if (palette == NULL || col >= palette->width) {
+        return col;
+    }
+    return getpixel(palette, col, 0);
+}
+
 STATIC mp_obj_t framebuf_blit(size_t n_args, const mp_obj_t *args) {
     mp_obj_framebuf_t *self = MP_OBJ_TO_PTR(args[0]);
     mp_obj_framebuf_t *source = MP_OBJ_TO_PTR(args[1]);
@@ -478,6 +592,10 @@ STATIC mp_obj_t framebuf_blit(size_t n_args, const mp_obj_t *args) {
     if (n_args > 4) {
         key = mp_obj_get_int(args[4]);
     }
+    mp_obj_framebuf_t *palette = NULL;
+    if (n_args > 5 && args[5] != mp_const_none) {
+        palette = MP_OBJ_TO_PTR(args[5]);
+    }
 
     if (
         (x >= self->width) ||
@@ -496,53 +614,134 @@ STATIC mp_obj_t framebuf_blit(size_t n_args, const mp_obj_t *args) {
     int y1 = MAX(0, -y);
     int x0end = MIN(self->width, x + source->width);
     int y0end = MIN(self->height, y + source->height);
+    int w = x0end - x0;
+    int h = y0end - y0;
+
+    // When blitting downwards within one buffer, walk the rows bottom-up so
+    // that source rows are read before they are overwritten.
+    int dy = 1;
+    if (source->buf == self->buf && y0 > y1) {
+        y0 += h - 1;
+        y1 += h - 1;
+        dy = -1;
+    }
 
-    for (; y0 < y0end; ++y0) {
-        int cx1 = x1;
-        for (int cx0 = x0; cx0 < x0end; ++cx0) {
-            uint32_t col = getpixel(source, cx1, y1);
-            if (col != (uint32_t)key) {
-                setpixel(self, cx0, y0, col);
+    uint8_t bpp = horiz_bpp(self);
+    if (self->format == source->format && bpp != 0 && key == -1 && palette == NULL) {
+        // Same format, opaque: move whole rows.
+        for (; h--; y0 += dy, y1 += dy) {
+            copy_span(self, x0, y0, source, x1, y1, w);
+        }
+    } else if (self->format == FRAMEBUF_RGB565 && source->format != FRAMEBUF_RGB565 && source->format != FRAMEBUF_GS8) {
+        // At most 16 source colours: resolve the palette once, then convert
+        // each row without going through the per-pixel accessors.
+        uint32_t lut[16];
+        for (uint32_t i = 0; i < MP_ARRAY_SIZE(lut); ++i) {
+            lut[i] = palette_lookup(palette, i);
+        }
+        for (; h--; y0 += dy, y1 += dy) {
+            convert_span_rgb565(&((uint16_t*)self->buf)[x0 + y0 * self->stride], source, x1, y1, w, lut, key);
+        }
+    } else if (self->format == source->format && bpp >= 8 && palette == NULL) {
+        // Same byte-aligned format with a transparent key colour.
+        for (; h--; y0 += dy, y1 += dy) {
+            if (bpp == 16) {
+                uint16_t *d = &((uint16_t*)self->buf)[x0 + y0 * self->stride];
+                const uint16_t *s = &((uint16_t*)source->buf)[x1 + y1 * source->stride];
+                for (int ww = w; ww; --ww, ++d, ++s) {
+                    if (*s != (uint32_t)key) {
+                        *d = *s;
+                    }
+                }
+            } else {
+                uint8_t *d = &((uint8_t*)self->buf)[x0 + y0 * self->stride];
+                const uint8_t *s = &((uint8_t*)source->buf)[x1 + y1 * source->stride];
+                for (int ww = w; ww; --ww, ++d, ++s) {
+                    if (*s != (uint32_t)key) {
+                        *d = *s;
+                    }
+                }
+            }
+        }
+    } else {
+        for (; h--; y0 += dy, y1 += dy) {
+            int cx1 = x1;
+            for (int cx0 = x0; cx0 < x0end; ++cx0) {
+                uint32_t col = palette_lookup(palette, getpixel(source, cx1, y1));
+                if (col != (uint32_t)key) {
+                    setpixel(self, cx0, y0, col);
+                }
+                ++cx1;
             }
-            ++cx1;
         }
-        ++y1;
     }
     return mp_const_none;
 }
-STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(framebuf_blit_obj, 4, 5, framebuf_blit);
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(framebuf_blit_obj, 4, 6, framebuf_blit);
 
-STATIC mp_obj_t framebuf_scroll(mp_obj_t self_in, mp_obj_t xstep_in, mp_obj_t ystep_in) {
-    mp_obj_framebuf_t *self = MP_OBJ_TO_PTR(self_in);
-    mp_int_t xstep = mp_obj_get_int(xstep_in);
-    mp_int_t ystep = mp_obj_get_int(ystep_in);
-    int sx, y, xend, yend, dx, dy;
-    if (xstep < 0) {
-        sx = 0;
-        xend = self->width + xstep;
-        dx = 1;
-    } else {
-        sx = self->width - 1;
-        xend = xstep - 1;
-        dx = -1;
-    }
-    if (ystep < 0) {
-        y = 0;
-        yend = self->height + ystep;
-        dy = 1;
+STATIC mp_obj_t framebuf_scroll(size_t n_args, const mp_obj_t *args) {
+    mp_obj_framebuf_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_int_t xstep = mp_obj_get_int(args[1]);
+    mp_int_t ystep = mp_obj_get_int(args[2]);
+    int w = self->width - (xstep < 0 ? -xstep : xstep);
+    int h = self->height - (ystep < 0 ? -ystep : ystep);
+    if (w <= 0 || h <= 0) {
+        // Everything is scrolled out of view, nothing to move.
+    } else if (horiz_bpp(self) != 0) {
+        int xd = MAX(0, xstep);
+        int xs = MAX(0, -xstep);
+        if (ystep > 0) {
+            for (int y = self->height - 1; y >= ystep; --y) {
+                copy_span(self, xd, y, self, xs, y - ystep, w);
+            }
+        } else {
+            for (int y = 0; y < h; ++y) {
+                copy_span(self, xd, y, self, xs, y - ystep, w);
+            }
+        }
     } else {
-        y = self->height - 1;
-        yend = ystep - 1;
-        dy = -1;
+        int sx, y, xend, yend, dx, dy;
+        if (xstep < 0) {
+            sx = 0;
+            xend = self->width + xstep;
+            dx = 1;
+        } else {
+            sx = self->width - 1;
+            xend = xstep - 1;
+            dx = -1;
+        }
+        if (ystep < 0) {
+            y = 0;
+            yend = self->height + ystep;
+            dy = 1;
+        } else {
+            y = self->height - 1;
+            yend = ystep - 1;
+            dy = -1;
+        }
+        for (; y != yend; y += dy) {
+            for (int x = sx; x != xend; x += dx) {
+                setpixel(self, x, y, getpixel(self, x - xstep, y - ystep));
+            }
+        }
     }
-    for (; y != yend; y += dy) {
-        for (int x = sx; x != xend; x += dx) {
-            setpixel(self, x, y, getpixel(self, x - xstep, y - ystep));
+    if (n_args > 3) {
+        // Fill the area uncovered by the scroll.
+        mp_int_t col = mp_obj_get_int(args[3]);
+        if (xstep > 0) {
+            fill_rect(self, 0, 0, xstep, self->height, col);
+        } else if (xstep < 0) {
+            fill_rect(self, self->width + xstep, 0, -xstep, self->height, col);
+        }
+        if (ystep > 0) {
+            fill_rect(self, 0, 0, self->width, ystep, col);
+        } else if (ystep < 0) {
+            fill_rect(self, 0, self->height + ystep, self->width, -ystep, col);
         }
     }
     return mp_const_none;
 }
-STATIC MP_DEFINE_CONST_FUN_OBJ_3(framebuf_scroll_obj, framebuf_scroll);
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(framebuf_scroll_obj, 3, 4, framebuf_scroll);
 
 STATIC mp_obj_t framebuf_text(size_t n_args, const mp_obj_t *args) {
     // extract arguments
@@ -0,0 +1,653 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "py/builtin.h"
+#include "py/mperrno.h"
+#include "py/mphal.h"
+#include "py/objgenerator.h"
+#include "py/objlist.h"
+#include "py/runtime.h"
+#include "py/smallint.h"
+#include "py/stream.h"
+
+#include "supervisor/shared/translate.h"
+
+#if MICROPY_PY_UASYNCIO
+
+// A native version of the event loop from micropython-lib's uasyncio.core.
+// Coroutines are generators; they yield requests (sleep, wait for a stream to
+// become readable or writable) back to the loop, which resumes them when the
+// request is satisfied. Timers live in a utimeq and streams are waited on with
+// uselect.poll, so the loop blocks in the port's delay or poll between events
+// instead of spinning.
+
+#define TICKS_PERIOD MICROPY_PY_UTIME_TICKS_PERIOD
+
+STATIC mp_uint_t ticks_now(void) {
+    return mp_hal_ticks_ms() & (TICKS_PERIOD - 1);
+}
+
+STATIC mp_uint_t ticks_add(mp_uint_t t, mp_int_t delta) {
+    return (t + delta) & (TICKS_PERIOD - 1);
+}
+
+STATIC mp_int_t ticks_diff(mp_uint_t end, mp_uint_t start) {
+    return ((end - start + TICKS_PERIOD / 2) & (TICKS_PERIOD - 1)) - TICKS_PERIOD / 2;
+}
+
+/******************************************************************************/
+// Requests a coroutine can yield to the loop
+
+enum {
+    REQ_SLEEP_MS,
+    REQ_IOREAD,
+    REQ_IOWRITE,
+};
+
+typedef struct _uasyncio_req_obj_t {
+    mp_obj_base_t base;
+    uint8_t kind;
+    bool yielded;
+    mp_obj_t arg;
+} uasyncio_req_obj_t;
+
+STATIC const mp_obj_type_t uasyncio_req_type;
+
+STATIC mp_obj_t uasyncio_req_new(uint8_t kind, mp_obj_t arg) {
+    uasyncio_req_obj_t *req = m_new_obj(uasyncio_req_obj_t);
+    req->base.type = &uasyncio_req_type;
+    req->kind = kind;
+    req->yielded = false;
+    req->arg = arg;
+    return MP_OBJ_FROM_PTR(req);
+}
+
+// "await req" yields the request itself once, then finishes when the loop
+// resumes the coroutine.
+STATIC mp_obj_t uasyncio_req_iternext(mp_obj_t self_in) {
+    uasyncio_req_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->yielded) {
+        return MP_OBJ_STOP_ITERATION;
+    }
+    self->yielded = true;
+    return self_in;
+}
+
+STATIC const mp_obj_type_t uasyncio_req_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_Request,
+    .getiter = mp_identity_getiter,
+    .iternext = uasyncio_req_iternext,
+};
+
+STATIC mp_obj_t mod_uasyncio_sleep_ms(mp_obj_t ms_in) {
+    return uasyncio_req_new(REQ_SLEEP_MS, MP_OBJ_NEW_SMALL_INT(mp_obj_get_int(ms_in)));
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(mod_uasyncio_sleep_ms_obj, mod_uasyncio_sleep_ms);
+
+STATIC mp_obj_t mod_uasyncio_sleep(mp_obj_t s_in) {
+    #if MICROPY_PY_BUILTINS_FLOAT
+    mp_int_t ms = 1000 * mp_obj_get_float(s_in);
+    #else
+    mp_int_t ms = 1000 * mp_obj_get_int(s_in);
+    #endif
+    return uasyncio_req_new(REQ_SLEEP_MS, MP_OBJ_NEW_SMALL_INT(ms));
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(mod_uasyncio_sleep_obj, mod_uasyncio_sleep);
+
+STATIC mp_obj_t mod_uasyncio_ioread(mp_obj_t stream) {
+    return uasyncio_req_new(REQ_IOREAD, stream);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(mod_uasyncio_ioread_obj, mod_uasyncio_ioread);
+
+STATIC mp_obj_t mod_uasyncio_iowrite(mp_obj_t stream) {
+    return uasyncio_req_new(REQ_IOWRITE, stream);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(mod_uasyncio_iowrite_obj, mod_uasyncio_iowrite);
+
+/******************************************************************************/
+// Event loop
+
+typedef struct _uasyncio_io_t {
+    mp_obj_t stream;
+    mp_obj_t callback;
+    mp_uint_t events;
+} uasyncio_io_t;
+
+typedef struct _uasyncio_loop_obj_t {
+    mp_obj_base_t base;
+    // utimeq of (time, callback, args)
+    mp_obj_t waitq;
+    // uselect.poll, created the first time a coroutine waits on a stream
+    mp_obj_t poller;
+    // coroutine run_until_complete() is waiting for, and its return value
+    mp_obj_t main;
+    mp_obj_t main_ret;
+    bool stop;
+    // circular queue of (callback, args) pairs ready to run
+    size_t runq_alloc;
+    size_t runq_head;
+    size_t runq_len;
+    mp_obj_t *runq;
+    // coroutines waiting on streams
+    size_t io_alloc;
+    size_t io_len;
+    uasyncio_io_t *io;
+} uasyncio_loop_obj_t;
+
+// For a generator args is the value to send into it; for anything else it's
+// a tuple of arguments to call it with.
+STATIC void loop_call_soon(uasyncio_loop_obj_t *self, mp_obj_t callback, mp_obj_t args) {
+    if (self->runq_len == self->runq_alloc) {
+        mp_raise_IndexError(translate("queue overflow"));
+    }
+    size_t i = (self->runq_head + self->runq_len++) % self->runq_alloc;
+    self->runq[2 * i] = callback;
+    self->runq[2 * i + 1] = args;
+}
+
+STATIC void loop_call_later_ms(uasyncio_loop_obj_t *self, mp_int_t delay, mp_obj_t callback, mp_obj_t args) {
+    mp_obj_t dest[5];
+    mp_load_method(self->waitq, MP_QSTR_push, dest);
+    dest[2] = mp_obj_new_int_from_uint(ticks_add(ticks_now(), delay));
+    dest[3] = callback;
+    dest[4] = args;
+    mp_call_method_n_kw(3, 0, dest);
+}
+
+STATIC void loop_io_register(uasyncio_loop_obj_t *self, mp_obj_t stream) {
+    mp_uint_t events = 0;
+    for (size_t i = 0; i < self->io_len; ++i) {
+        if (self->io[i].stream == stream) {
+            events |= self->io[i].events;
+        }
+    }
+    mp_obj_t dest[4];
+    if (events == 0) {
+        mp_load_method(self->poller, MP_QSTR_unregister, dest);
+        dest[2] = stream;
+        mp_call_method_n_kw(1, 0, dest);
+    } else {
+        mp_load_method(self->poller, MP_QSTR_register, dest);
+        dest[2] = stream;
+        dest[3] = MP_OBJ_NEW_SMALL_INT(events);
+        mp_call_method_n_kw(2, 0, dest);
+    }
+}
+
+STATIC void loop_io_wait(uasyncio_loop_obj_t *self, mp_obj_t stream, mp_obj_t callback, mp_uint_t events) {
+    if (self->poller == MP_OBJ_NULL) {
+        mp_obj_t uselect = mp_import_name(MP_QSTR_uselect, mp_const_none, MP_OBJ_NEW_SMALL_INT(0));
+        self->poller = mp_call_function_0(mp_load_attr(uselect, MP_QSTR_poll));
+    }
+    if (self->io_len == self->io_alloc) {
+        self->io = m_renew(uasyncio_io_t, self->io, self->io_alloc, self->io_alloc + 4);
+        self->io_alloc += 4;
+    }
+    uasyncio_io_t *io = &self->io[self->io_len++];
+    io->stream = stream;
+    io->callback = callback;
+    io->events = events;
+    loop_io_register(self, stream);
+}
+
+// Wakes everything waiting on stream for the given poll events.
+STATIC void loop_io_ready(uasyncio_loop_obj_t *self, mp_obj_t stream, mp_uint_t revents) {
+    // Errors and hangups wake both readers and writers so they see them.
+    if (revents & (MP_STREAM_POLL_ERR | MP_STREAM_POLL_HUP)) {
+        revents |= MP_STREAM_POLL_RD | MP_STREAM_POLL_WR;
+    }
+    size_t j = 0;
+    for (size_t i = 0; i < self->io_len; ++i) {
+        uasyncio_io_t *io = &self->io[i];
+        if (io->stream == stream && (io->events & revents)) {
+            loop_call_soon(self, io->callback, mp_const_none);
+        } else {
+            self->io[j++] = *io;
+        }
+    }
+    for (size_t i = j; i < self->io_len; ++i) {
+        self->io[i].stream = self->io[i].callback = MP_OBJ_NULL;
+    }
+    self->io_len = j;
+    loop_io_register(self, stream);
+}
+
+// Sleeps until the earliest of a timer expiring or a stream becoming ready.
+// A negative delay means there are no timers.
+STATIC void loop_wait(uasyncio_loop_obj_t *self, mp_int_t delay) {
+    if (self->io_len == 0) {
+        if (delay > 0) {
+            mp_hal_delay_ms(delay);
+        }
+        return;
+    }
+    mp_obj_t dest[3];
+    mp_load_method(self->poller, MP_QSTR_ipoll, dest);
+    dest[2] = MP_OBJ_NEW_SMALL_INT(delay);
+    mp_obj_t iter = mp_getiter(mp_call_method_n_kw(1, 0, dest), NULL);
+    mp_obj_t item;
+    while ((item = mp_iternext(iter)) != MP_OBJ_STOP_ITERATION) {
+        // ipoll reuses the tuple it returns, so take the values out first.
+        mp_obj_t *ev;
+        mp_obj_get_array_fixed_n(item, 2, &ev);
+        loop_io_ready(self, ev[0], mp_obj_get_int(ev[1]));
+    }
+}
+
+STATIC void loop_run_coro(uasyncio_loop_obj_t *self, mp_obj_t coro, mp_obj_t send_value) {
+    mp_obj_t ret;
+    mp_vm_return_kind_t kind = mp_resume(coro, send_value, MP_OBJ_NULL, &ret);
+    if (kind == MP_VM_RETURN_EXCEPTION) {
+        nlr_raise(ret);
+    }
+    if (kind == MP_VM_RETURN_NORMAL) {
+        if (coro == self->main) {
+            self->main_ret = ret == MP_OBJ_STOP_ITERATION ? mp_const_none : ret;
+            self->stop = true;
+        }
+        return;
+    }
+
+    if (MP_OBJ_IS_TYPE(ret, &uasyncio_req_type)) {
+        uasyncio_req_obj_t *req = MP_OBJ_TO_PTR(ret);
+        if (req->kind == REQ_SLEEP_MS) {
+            loop_call_later_ms(self, MP_OBJ_SMALL_INT_VALUE(req->arg), coro, mp_const_none);
+        } else {
+            loop_io_wait(self, req->arg, coro,
+                req->kind == REQ_IOREAD ? MP_STREAM_POLL_RD : MP_STREAM_POLL_WR);
+        }
+    } else if (MP_OBJ_IS_TYPE(ret, &mp_type_gen_instance)) {
+        // Yielding a coroutine starts it as a new task.
+        loop_call_soon(self, ret, mp_const_none);
+        loop_call_soon(self, coro, mp_const_none);
+    } else if (ret == mp_const_none) {
+        // A bare yield just lets other tasks run.
+        loop_call_soon(self, coro, mp_const_none);
+    } else if (ret != mp_const_false) {
+        // False means the coroutine arranged to be rescheduled itself.
+        mp_raise_TypeError(translate("unsupported yield value"));
+    }
+}
+
+STATIC void loop_run(uasyncio_loop_obj_t *self) {
+    self->stop = false;
+    mp_obj_t popped = mp_obj_new_list(3, NULL);
+    mp_obj_t dest[3];
+    for (;;) {
+        // Lets KeyboardInterrupt and scheduled callbacks in while idle.
+        mp_handle_pending();
+
+        // Move timers that have expired to the run queue.
+        mp_uint_t now = ticks_now();
+        while (MP_OBJ_SMALL_INT_VALUE(mp_obj_len(self->waitq)) > 0) {
+            mp_load_method(self->waitq, MP_QSTR_peektime, dest);
+            if (ticks_diff(mp_obj_get_int_truncated(mp_call_method_n_kw(0, 0, dest)), now) > 0) {
+                break;
+            }
+            mp_load_method(self->waitq, MP_QSTR_pop, dest);
+            dest[2] = popped;
+            mp_call_method_n_kw(1, 0, dest);
+            mp_obj_list_t *entry = MP_OBJ_TO_PTR(popped);
+            loop_call_soon(self, entry->items[1], entry->items[2]);
+        }
+
+        // Run what's ready now; anything it schedules waits for the next pass.
+        for (size_t n = self->runq_len; n > 0 && !self->stop; --n) {
+            size_t i = self->runq_head;
+            mp_obj_t callback = self->runq[2 * i];
+            mp_obj_t args = self->runq[2 * i + 1];
+            self->runq[2 * i] = self->runq[2 * i + 1] = MP_OBJ_NULL;
+            self->runq_head = (i + 1) % self->runq_alloc;
+            --self->runq_len;
+            if (MP_OBJ_IS_TYPE(callback, &mp_type_gen_instance)) {
+                loop_run_coro(self, callback, args);
+            } else {
+                size_t n_args;
+                mp_obj_t *items;
+                mp_obj_get_array(args, &n_args, &items);
+                mp_call_function_n_kw(callback, n_args, 0, items);
+            }
+        }
+        if (self->stop) {
+            return;
+        }
+
+        mp_int_t delay;
+        if (self->runq_len > 0) {
+            delay = 0;
+        } else if (MP_OBJ_SMALL_INT_VALUE(mp_obj_len(self->waitq)) > 0) {
+            mp_load_method(self->waitq, MP_QSTR_peektime, dest);
+            delay = MAX(0, ticks_diff(mp_obj_get_int_truncated(mp_call_method_n_kw(0, 0, dest)), ticks_now()));
+        } else if (self->io_len > 0) {
+            delay = -1;
+        } else {
+            // Nothing is left that could ever run.
+            return;
+        }
+        loop_wait(self, delay);
+    }
+}
+
+STATIC const mp_obj_type_t uasyncio_loop_type;
+
+STATIC mp_obj_t mod_uasyncio_get_event_loop(size_t n_args, const mp_obj_t *args) {
+    if (MP_STATE_VM(uasyncio_loop) == MP_OBJ_NULL) {
+        mp_int_t runq_len = n_args > 0 ? mp_obj_get_int(args[0]) : 16;
+        mp_int_t waitq_len = n_args > 1 ? mp_obj_get_int(args[1]) : 16;
+        if (runq_len <= 0) {
+            mp_raise_ValueError(translate("Invalid argument"));
+        }
+        uasyncio_loop_obj_t *self = m_new_obj(uasyncio_loop_obj_t);
+        self->base.type = &uasyncio_loop_type;
+        mp_obj_t utimeq = mp_load_attr(MP_OBJ_FROM_PTR(&mp_module_utimeq), MP_QSTR_utimeq);
+        self->waitq = mp_call_function_1(utimeq, MP_OBJ_NEW_SMALL_INT(waitq_len));
+        self->poller = MP_OBJ_NULL;
+        self->main = MP_OBJ_NULL;
+        self->main_ret = mp_const_none;
+        self->stop = false;
+        self->runq_alloc = runq_len;
+        self->runq_head = 0;
+        self->runq_len = 0;
+        self->runq = m_new0(mp_obj_t, 2 * runq_len);
+        self->io_alloc = 0;
+        self->io_len = 0;
+        self->io = NULL;
+        MP_STATE_VM(uasyncio_loop) = MP_OBJ_FROM_PTR(self);
+    }
+    return MP_STATE_VM(uasyncio_loop);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_uasyncio_get_event_loop_obj, 0, 2, mod_uasyncio_get_event_loop);
+
+STATIC mp_obj_t uasyncio_loop_create_task(mp_obj_t self_in, mp_obj_t coro) {
+    loop_call_soon(MP_OBJ_TO_PTR(self_in), coro, mp_const_none);
+    return coro;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(uasyncio_loop_create_task_obj, uasyncio_loop_create_task);
+
+STATIC mp_obj_t uasyncio_loop_call_soon(size_t n_args, const mp_obj_t *args) {
+    loop_call_soon(MP_OBJ_TO_PTR(args[0]), args[1], mp_obj_new_tuple(n_args - 2, args + 2));
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR(uasyncio_loop_call_soon_obj, 2, uasyncio_loop_call_soon);
+
+STATIC mp_obj_t uasyncio_loop_call_later_ms(size_t n_args, const mp_obj_t *args) {
+    loop_call_later_ms(MP_OBJ_TO_PTR(args[0]), mp_obj_get_int(args[1]), args[2], mp_obj_new_tuple(n_args - 3, args + 3));
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR(uasyncio_loop_call_later_ms_obj, 3, uasyncio_loop_call_later_ms);
+
+STATIC mp_obj_t uasyncio_loop_call_later(size_t n_args, const mp_obj_t *args) {
+    #if MICROPY_PY_BUILTINS_FLOAT
+    mp_int_t delay = 1000 * mp_obj_get_float(args[1]);
+    #else
+    mp_int_t delay = 1000 * mp_obj_get_int(args[1]);
+    #endif
+    loop_call_later_ms(MP_OBJ_TO_PTR(args[0]), delay, args[2], mp_obj_new_tuple(n_args - 3, args + 3));
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR(uasyncio_loop_call_later_obj, 3, uasyncio_loop_call_later);
+
+STATIC mp_obj_t uasyncio_loop_run_forever(mp_obj_t self_in) {
+    uasyncio_loop_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    self->main = MP_OBJ_NULL;
+    loop_run(self);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(uasyncio_loop_run_forever_obj, uasyncio_loop_run_forever);
+
+STATIC mp_obj_t uasyncio_loop_run_until_complete(mp_obj_t self_in, mp_obj_t coro) {
+    uasyncio_loop_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    loop_call_soon(self, coro, mp_const_none);
+    self->main = coro;
+    self->main_ret = mp_const_none;
+    loop_run(self);
+    self->main = MP_OBJ_NULL;
+    return self->main_ret;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(uasyncio_loop_run_until_complete_obj, uasyncio_loop_run_until_complete);
+
+STATIC mp_obj_t uasyncio_loop_stop(mp_obj_t self_in) {
+    uasyncio_loop_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    self->stop = true;
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(uasyncio_loop_stop_obj, uasyncio_loop_stop);
+
+STATIC mp_obj_t uasyncio_loop_close(mp_obj_t self_in) {
+    (void)self_in;
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(uasyncio_loop_close_obj, uasyncio_loop_close);
+
+STATIC mp_obj_t uasyncio_loop_time(mp_obj_t self_in) {
+    (void)self_in;
+    return mp_obj_new_int_from_uint(ticks_now());
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(uasyncio_loop_time_obj, uasyncio_loop_time);
+
+STATIC const mp_rom_map_elem_t uasyncio_loop_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_create_task), MP_ROM_PTR(&uasyncio_loop_create_task_obj) },
+    { MP_ROM_QSTR(MP_QSTR_call_soon), MP_ROM_PTR(&uasyncio_loop_call_soon_obj) },
+    { MP_ROM_QSTR(MP_QSTR_call_later), MP_ROM_PTR(&uasyncio_loop_call_later_obj) },
+    { MP_ROM_QSTR(MP_QSTR_call_later_ms), MP_ROM_PTR(&uasyncio_loop_call_later_ms_obj) },
+    { MP_ROM_QSTR(MP_QSTR_run_forever), MP_ROM_PTR(&uasyncio_loop_run_forever_obj) },
+    { MP_ROM_QSTR(MP_QSTR_run_until_complete), MP_ROM_PTR(&uasyncio_loop_run_until_complete_obj) },
+    { MP_ROM_QSTR(MP_QSTR_stop), MP_ROM_PTR(&uasyncio_loop_stop_obj) },
+    { MP_ROM_QSTR(MP_QSTR_close), MP_ROM_PTR(&uasyncio_loop_close_obj) },
+    { MP_ROM_QSTR(MP_QSTR_time), MP_ROM_PTR(&uasyncio_loop_time_obj) },
+};
+STATIC MP_DEFINE_CONST_DICT(uasyncio_loop_locals_dict, uasyncio_loop_locals_dict_table);
+
+STATIC const mp_obj_type_t uasyncio_loop_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_EventLoop,
+    .locals_dict = (mp_obj_dict_t*)&uasyncio_loop_locals_dict,
+};
+
+STATIC mp_obj_t mod_uasyncio_run(mp_obj_t coro) {
+    return uasyncio_loop_run_until_complete(mod_uasyncio_get_event_loop(0, NULL), coro);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(mod_uasyncio_run_obj, mod_uasyncio_run);
+
+/******************************************************************************/
+// Streams
+
+// An awaitable for one stream operation. It yields an IORead/IOWrite request
+// whenever the stream would block and finishes by raising StopIteration with
+// the result, which "await" turns into the value of the expression. It uses a
+// __next__ method rather than iternext because only the former can return a
+// value to the awaiting coroutine.
+
+enum {
+    OP_READ,
+    OP_READLINE,
+    OP_WRITE,
+};
+
+typedef struct _uasyncio_stream_op_obj_t {
+    mp_obj_base_t base;
+    mp_obj_t stream;
+    mp_obj_t buf;
+    mp_int_t off;
+    mp_int_t len;
+    uint8_t kind;
+    bool waited;
+} uasyncio_stream_op_obj_t;
+
+STATIC mp_obj_t uasyncio_stream_op_next(mp_obj_t self_in) {
+    uasyncio_stream_op_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_obj_t dest[5];
+    if (self->kind == OP_WRITE) {
+        // Write straight away and only wait when the stream pushes back.
+        while (self->len > 0) {
+            mp_load_method(self->stream, MP_QSTR_write, dest);
+            dest[2] = self->buf;
+            dest[3] = MP_OBJ_NEW_SMALL_INT(self->off);
+            dest[4] = MP_OBJ_NEW_SMALL_INT(self->len);
+            mp_obj_t res = mp_call_method_n_kw(3, 0, dest);
+            if (res == mp_const_none) {
+                return uasyncio_req_new(REQ_IOWRITE, self->stream);
+            }
+            mp_int_t n = mp_obj_get_int(res);
+            self->off += n;
+            self->len -= n;
+        }
+        nlr_raise(mp_obj_new_exception_arg1(&mp_type_StopIteration, mp_const_none));
+    }
+
+    // Reads wait for the stream to be readable first, like uasyncio.core.
+    if (!self->waited) {
+        self->waited = true;
+        return uasyncio_req_new(REQ_IOREAD, self->stream);
+    }
+    mp_obj_t res;
+    if (self->kind == OP_READLINE) {
+        mp_load_method(self->stream, MP_QSTR_readline, dest);
+        res = mp_call_method_n_kw(0, 0, dest);
+    } else {
+        mp_load_method(self->stream, MP_QSTR_read, dest);
+        dest[2] = MP_OBJ_NEW_SMALL_INT(self->len);
+        res = mp_call_method_n_kw(1, 0, dest);
+    }
+    if (res == mp_const_none) {
+        // Spurious wakeup; wait again.
+        return uasyncio_req_new(REQ_IOREAD, self->stream);
+    }
+    nlr_raise(mp_obj_new_exception_arg1(&mp_type_StopIteration, res));
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(uasyncio_stream_op_next_obj, uasyncio_stream_op_next);
+
+STATIC const mp_rom_map_elem_t uasyncio_stream_op_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___next__), MP_ROM_PTR(&uasyncio_stream_op_next_obj) },
+};
+STATIC MP_DEFINE_CONST_DICT(uasyncio_stream_op_locals_dict, uasyncio_stream_op_locals_dict_table);
+
+STATIC const mp_obj_type_t uasyncio_stream_op_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_StreamOp,
+    .getiter = mp_identity_getiter,
+    .locals_dict = (mp_obj_dict_t*)&uasyncio_stream_op_locals_dict,
+};
+
+typedef struct _uasyncio_stream_obj_t {
+    mp_obj_base_t base;
+    mp_obj_t stream;
+} uasyncio_stream_obj_t;
+
+STATIC mp_obj_t uasyncio_stream_op_new(mp_obj_t self_in, uint8_t kind, mp_obj_t buf, mp_int_t off, mp_int_t len) {
+    uasyncio_stream_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    uasyncio_stream_op_obj_t *op = m_new_obj(uasyncio_stream_op_obj_t);
+    op->base.type = &uasyncio_stream_op_type;
+    op->stream = self->stream;
+    op->buf = buf;
+    op->off = off;
+    op->len = len;
+    op->kind = kind;
+    op->waited = false;
+    return MP_OBJ_FROM_PTR(op);
+}
+
+STATIC mp_obj_t uasyncio_stream_make_new(const mp_obj_type_t *type, size_t n_args, const mp_obj_t *args, mp_map_t *kw_args) {
+    mp_arg_check_num(n_args, kw_args, 1, 2, false);
+    uasyncio_stream_obj_t *self = m_new_obj(uasyncio_stream_obj_t);
+    self->base.type = type;
+    self->stream = args[0];
+    return MP_OBJ_FROM_PTR(self);
+}
+
+STATIC mp_obj_t uasyncio_stream_read(size_t n_args, const mp_obj_t *args) {
+    mp_int_t n = n_args > 1 ? mp_obj_get_int(args[1]) : -1;
+    return uasyncio_stream_op_new(args[0], OP_READ, mp_const_none, 0, n);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(uasyncio_stream_read_obj, 1, 2, uasyncio_stream_read);
+
+STATIC mp_obj_t uasyncio_stream_readline(mp_obj_t self_in) {
+    return uasyncio_stream_op_new(self_in, OP_READLINE, mp_const_none, 0, 0);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(uasyncio_stream_readline_obj, uasyncio_stream_readline);
+
+STATIC mp_obj_t uasyncio_stream_awrite(size_t n_args, const mp_obj_t *args) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[1], &bufinfo, MP_BUFFER_READ);
+    mp_int_t off = n_args > 2 ? mp_obj_get_int(args[2]) : 0;
+    mp_int_t len = n_args > 3 ? mp_obj_get_int(args[3]) : -1;
+    off = MIN(MAX(off, 0), (mp_int_t)bufinfo.len);
+    if (len < 0 || len > (mp_int_t)bufinfo.len - off) {
+        len = bufinfo.len - off;
+    }
+    return uasyncio_stream_op_new(args[0], OP_WRITE, args[1], off, len);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(uasyncio_stream_awrite_obj, 2, 4, uasyncio_stream_awrite);
+
+STATIC mp_obj_t uasyncio_stream_aclose(mp_obj_t self_in) {
+    uasyncio_stream_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_obj_t dest[2];
+    mp_load_method(self->stream, MP_QSTR_close, dest);
+    mp_call_method_n_kw(0, 0, dest);
+    // Awaiting the request returned here finishes straight away.
+    uasyncio_req_obj_t *req = MP_OBJ_TO_PTR(uasyncio_req_new(REQ_SLEEP_MS, MP_OBJ_NEW_SMALL_INT(0)));
+    req->yielded = true;
+    return MP_OBJ_FROM_PTR(req);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(uasyncio_stream_aclose_obj, uasyncio_stream_aclose);
+
+STATIC const mp_rom_map_elem_t uasyncio_stream_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_read), MP_ROM_PTR(&uasyncio_stream_read_obj) },
+    { MP_ROM_QSTR(MP_QSTR_readline), MP_ROM_PTR(&uasyncio_stream_readline_obj) },
+    { MP_ROM_QSTR(MP_QSTR_awrite), MP_ROM_PTR(&uasyncio_stream_awrite_obj) },
+    { MP_ROM_QSTR(MP_QSTR_aclose), MP_ROM_PTR(&uasyncio_stream_aclose_obj) },
+};
+STATIC MP_DEFINE_CONST_DICT(uasyncio_stream_locals_dict, uasyncio_stream_locals_dict_table);
+
+STATIC const mp_obj_type_t uasyncio_stream_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_Stream,
+    .make_new = uasyncio_stream_make_new,
+    .locals_dict = (mp_obj_dict_t*)&uasyncio_stream_locals_dict,
+};
+
+STATIC const mp_rom_map_elem_t mp_module_uasyncio_globals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_uasyncio) },
+    { MP_ROM_QSTR(MP_QSTR_get_event_loop), MP_ROM_PTR(&mod_uasyncio_get_event_loop_obj) },
+    { MP_ROM_QSTR(MP_QSTR_run), MP_ROM_PTR(&mod_uasyncio_run_obj) },
+    { MP_ROM_QSTR(MP_QSTR_sleep), MP_ROM_PTR(&mod_uasyncio_sleep_obj) },
+    { MP_ROM_QSTR(MP_QSTR_sleep_ms), MP_ROM_PTR(&mod_uasyncio_sleep_ms_obj) },
+    { MP_ROM_QSTR(MP_QSTR_IORead), MP_ROM_PTR(&mod_uasyncio_ioread_obj) },
+    { MP_ROM_QSTR(MP_QSTR_IOWrite), MP_ROM_PTR(&mod_uasyncio_iowrite_obj) },
+    { MP_ROM_QSTR(MP_QSTR_Stream), MP_ROM_PTR(&uasyncio_stream_type) },
+    { MP_ROM_QSTR(MP_QSTR_StreamReader), MP_ROM_PTR(&uasyncio_stream_type) },
+    { MP_ROM_QSTR(MP_QSTR_StreamWriter), MP_ROM_PTR(&uasyncio_stream_type) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(mp_module_uasyncio_globals, mp_module_uasyncio_globals_table);
+
+const mp_obj_module_t mp_module_uasyncio = {
+    .base = { &mp_type_module },
+    .globals = (mp_obj_dict_t*)&mp_module_uasyncio_globals,
+};
+
+#endif // MICROPY_PY_UASYNCIO
@@ -0,0 +1,338 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+
+#include "py/bc.h"
+#include "py/builtin.h"
+#include "py/gc.h"
+#include "py/objfun.h"
+#include "py/runtime.h"
+#include "extmod/moduheap.h"
+#include "extmod/sampletable.h"
+
+#if MICROPY_PY_UHEAP
+
+// Allocation tracing. While tracing, every Nth gc_alloc() is attributed to
+// the bytecode function running on the current thread and the offset of its
+// last saved ip, together with its size and the type of object it became.
+// Allocations that had to run a collection first are always recorded, so the
+// code paths that keep the collector busy show up even with a coarse period.
+//
+// The type is not known inside gc_alloc(), because the caller fills in the
+// object afterwards, so a sample is held back until the next allocation and
+// its type read then.
+
+// Distinct types counted by types() before the rest are lumped under None.
+#define UHEAP_MAX_TYPES (64)
+
+// The values kept for each site in the sample table, in the order the sites
+// are sorted by.
+enum {
+    UHEAP_BYTES,
+    UHEAP_COLLECTS,
+    UHEAP_COUNT,
+    UHEAP_N_VALUES
+};
+
+typedef struct _uheap_t {
+    uint32_t period;
+    uint32_t countdown;
+    bool running;
+    uint32_t allocs;
+    uint32_t samples;
+    // The sample waiting for its type. The allocation is kept as an offset
+    // into the heap so that it is not kept alive by this table.
+    bool pending;
+    bool pending_sampled;
+    bool pending_collected;
+    size_t pending_offset;
+    size_t pending_bytes;
+    const mp_obj_fun_bc_t *pending_fun_bc;
+    uint32_t pending_ip;
+    // Keyed by the type allocated.
+    sampletable_t *table;
+} uheap_t;
+
+// The type of the object at ptr, or NULL if it doesn't start with one we can
+// recognise safely. Only builtin types and classes on the heap are known:
+// anything else in the first word may not be a readable pointer.
+STATIC const mp_obj_type_t *uheap_type_of(const void *ptr) {
+    const mp_obj_type_t *type = ((const mp_obj_base_t*)ptr)->type;
+    static const mp_obj_type_t *const known[] = {
+        &mp_type_type, &mp_type_object, &mp_type_tuple, &mp_type_list,
+        &mp_type_dict, &mp_type_str, &mp_type_bytes, &mp_type_int,
+        &mp_type_fun_bc, &mp_type_gen_instance, &mp_type_module,
+        #if MICROPY_PY_BUILTINS_SET
+        &mp_type_set,
+        #endif
+        #if MICROPY_PY_BUILTINS_BYTEARRAY
+        &mp_type_bytearray,
+        #endif
+        #if MICROPY_PY_ARRAY
+        &mp_type_array,
+        #endif
+        #if MICROPY_PY_BUILTINS_MEMORYVIEW
+        &mp_type_memoryview,
+        #endif
+        #if MICROPY_PY_BUILTINS_FLOAT
+        &mp_type_float,
+        #endif
+    };
+    for (size_t i = 0; i < MP_ARRAY_SIZE(known); i++) {
+        if (type == known[i]) {
+            return type;
+        }
+    }
+    if (gc_nbytes(type) >= sizeof(mp_obj_type_t) && type->base.type == &mp_type_type) {
+        return type;
+    }
+    return NULL;
+}
+
+STATIC void uheap_record(uheap_t *h) {
+    h->pending = false;
+    const void *ptr = MP_STATE_MEM(gc_pool_start) + h->pending_offset;
+    const mp_obj_type_t *type = NULL;
+    if (gc_nbytes(ptr) != 0) {
+        type = uheap_type_of(ptr);
+    }
+    size_t *values = sampletable_lookup(h->table, h->pending_fun_bc, h->pending_ip, type);
+    if (values == NULL) {
+        return;
+    }
+    if (h->pending_collected) {
+        values[UHEAP_COLLECTS] += 1;
+    }
+    if (h->pending_sampled) {
+        values[UHEAP_COUNT] += 1;
+        values[UHEAP_BYTES] += h->pending_bytes;
+    }
+}
+
+void uheap_trace_alloc(void *ptr, size_t n_bytes, bool collected) {
+    uheap_t *h = MP_STATE_VM(uheap);
+    if (!h->running) {
+        return;
+    }
+    if (h->pending) {
+        uheap_record(h);
+    }
+    h->allocs += 1;
+    bool sampled = --h->countdown == 0;
+    if (sampled) {
+        h->countdown = h->period;
+        h->samples += 1;
+    }
+    if (!sampled && !collected) {
+        return;
+    }
+    mp_code_state_t *code_state = MP_STATE_THREAD(current_code_state);
+    h->pending = true;
+    h->pending_sampled = sampled;
+    h->pending_collected = collected;
+    h->pending_offset = (byte*)ptr - MP_STATE_MEM(gc_pool_start);
+    h->pending_bytes = n_bytes;
+    h->pending_fun_bc = code_state == NULL ? NULL : code_state->fun_bc;
+    h->pending_ip = code_state == NULL ? 0 : code_state->ip - code_state->fun_bc->bytecode;
+}
+
+void uheap_reset(void) {
+    MP_STATE_VM(uheap) = NULL;
+}
+
+STATIC uheap_t *get_trace(void) {
+    uheap_t *h = MP_STATE_VM(uheap);
+    if (h == NULL) {
+        mp_raise_RuntimeError(translate("Tracing not started"));
+    }
+    return h;
+}
+
+STATIC mp_obj_t uheap_start(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_period, ARG_size };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_period, MP_ARG_INT, {.u_int = 1} },
+        { MP_QSTR_size, MP_ARG_INT, {.u_int = 64} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    if (args[ARG_period].u_int < 1 || args[ARG_size].u_int < 1) {
+        mp_raise_ValueError(NULL);
+    }
+
+    uheap_reset();
+    uheap_t *h = m_new0(uheap_t, 1);
+    h->table = sampletable_new(args[ARG_size].u_int, UHEAP_N_VALUES);
+    h->period = args[ARG_period].u_int;
+    h->countdown = h->period;
+    h->running = true;
+    MP_STATE_VM(uheap) = h;
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(uheap_start_obj, 0, uheap_start);
+
+STATIC mp_obj_t uheap_stop(void) {
+    uheap_t *h = get_trace();
+    if (h->pending) {
+        uheap_record(h);
+    }
+    h->running = false;
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(uheap_stop_obj, uheap_stop);
+
+STATIC mp_obj_t uheap_info(void) {
+    uheap_t *h = get_trace();
+    mp_obj_t items[3] = {
+        mp_obj_new_int_from_uint(h->allocs),
+        mp_obj_new_int_from_uint(h->samples),
+        mp_obj_new_int_from_uint(h->table->dropped),
+    };
+    return mp_obj_new_tuple(3, items);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(uheap_info_obj, uheap_info);
+
+STATIC mp_obj_t uheap_type_name(const mp_obj_type_t *type) {
+    return type == NULL ? mp_const_none : MP_OBJ_NEW_QSTR(type->name);
+}
+
+// Return a list of (samples, bytes, collections, file, line, function, type)
+// merged by source line and type, the sites that allocated most first.
+STATIC mp_obj_t uheap_sites(void) {
+    uheap_t *h = get_trace();
+    bool was_running = h->running;
+    h->running = false;
+    if (h->pending) {
+        uheap_record(h);
+    }
+    sampletable_line_t *sites = m_new(sampletable_line_t, h->table->size);
+    size_t n = sampletable_lines(h->table, sites);
+    h->running = was_running;
+
+    mp_obj_t list = mp_obj_new_list(0, NULL);
+    for (size_t i = 0; i < n; i++) {
+        mp_obj_t items[7] = {
+            mp_obj_new_int_from_uint(sites[i].values[UHEAP_COUNT]),
+            mp_obj_new_int_from_uint(sites[i].values[UHEAP_BYTES]),
+            mp_obj_new_int_from_uint(sites[i].values[UHEAP_COLLECTS]),
+            MP_OBJ_NEW_QSTR(sites[i].source_file),
+            MP_OBJ_NEW_SMALL_INT(sites[i].line),
+            MP_OBJ_NEW_QSTR(sites[i].block_name),
+            uheap_type_name(sites[i].key),
+        };
+        mp_obj_list_append(list, mp_obj_new_tuple(7, items));
+    }
+    m_del(sampletable_line_t, sites, h->table->size);
+    return list;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(uheap_sites_obj, uheap_sites);
+
+typedef struct _uheap_type_count_t {
+    const mp_obj_type_t *type;
+    size_t count;
+    size_t n_bytes;
+} uheap_type_count_t;
+
+typedef struct _uheap_histogram_t {
+    size_t len;
+    uheap_type_count_t *types;
+} uheap_histogram_t;
+
+STATIC void uheap_count_type(void *ptr, size_t n_bytes, void *arg) {
+    uheap_histogram_t *hist = arg;
+    const mp_obj_type_t *type = uheap_type_of(ptr);
+    size_t i;
+    for (i = 0; i < hist->len; i++) {
+        if (hist->types[i].type == type) {
+            break;
+        }
+    }
+    if (i == hist->len) {
+        if (hist->len == UHEAP_MAX_TYPES) {
+            // Slot 0 is always the untyped bucket.
+            i = 0;
+        } else {
+            hist->types[hist->len++].type = type;
+        }
+    }
+    hist->types[i].count += 1;
+    hist->types[i].n_bytes += n_bytes;
+}
+
+// Collect, then return a dict mapping type name (None for anything that isn't
+// a recognisable object) to (count, bytes) of what is still live. Doesn't
+// need tracing to be running.
+STATIC mp_obj_t uheap_types(void) {
+    gc_collect();
+    uheap_histogram_t hist;
+    hist.types = m_new0(uheap_type_count_t, UHEAP_MAX_TYPES);
+    hist.types[0].type = NULL;
+    hist.len = 1;
+    gc_walk(uheap_count_type, &hist);
+    mp_obj_t dict = mp_obj_new_dict(hist.len);
+    for (size_t i = 0; i < hist.len; i++) {
+        if (hist.types[i].count == 0) {
+            continue;
+        }
+        // Different types with the same name are merged.
+        mp_obj_t key = uheap_type_name(hist.types[i].type);
+        size_t count = hist.types[i].count;
+        size_t n_bytes = hist.types[i].n_bytes;
+        mp_map_elem_t *elem = mp_map_lookup(mp_obj_dict_get_map(dict), key, MP_MAP_LOOKUP);
+        if (elem != NULL) {
+            size_t len;
+            mp_obj_t *prev;
+            mp_obj_tuple_get(elem->value, &len, &prev);
+            count += mp_obj_get_int(prev[0]);
+            n_bytes += mp_obj_get_int(prev[1]);
+        }
+        mp_obj_t items[2] = { mp_obj_new_int_from_uint(count), mp_obj_new_int_from_uint(n_bytes) };
+        mp_obj_dict_store(dict, key, mp_obj_new_tuple(2, items));
+    }
+    m_del(uheap_type_count_t, hist.types, UHEAP_MAX_TYPES);
+    return dict;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(uheap_types_obj, uheap_types);
+
+STATIC const mp_rom_map_elem_t mp_module_uheap_globals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_uheap) },
+    { MP_ROM_QSTR(MP_QSTR_start), MP_ROM_PTR(&uheap_start_obj) },
+    { MP_ROM_QSTR(MP_QSTR_stop), MP_ROM_PTR(&uheap_stop_obj) },
+    { MP_ROM_QSTR(MP_QSTR_info), MP_ROM_PTR(&uheap_info_obj) },
+    { MP_ROM_QSTR(MP_QSTR_sites), MP_ROM_PTR(&uheap_sites_obj) },
+    { MP_ROM_QSTR(MP_QSTR_types), MP_ROM_PTR(&uheap_types_obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(mp_module_uheap_globals, mp_module_uheap_globals_table);
+
+const mp_obj_module_t mp_module_uheap = {
+    .base = { &mp_type_module },
+    .globals = (mp_obj_dict_t*)&mp_module_uheap_globals,
+};
+
+#endif // MICROPY_PY_UHEAP
@@ -0,0 +1,216 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+
+#include "py/bc.h"
+#include "py/builtin.h"
+#include "py/objfun.h"
+#include "py/runtime.h"
+#include "py/stream.h"
+#include "extmod/moduprofile.h"
+#include "extmod/sampletable.h"
+
+#if MICROPY_PY_UPROFILE
+
+// A sampling profiler. Each time the port calls uprofile_tick() (from its
+// millisecond tick on boards, from SIGPROF on unix) the bytecode function
+// running on the current thread and the offset of its last saved ip are
+// counted in a sample table. Nothing is decoded in the interrupt: results()
+// maps the offsets to source lines afterwards using the line number tables in
+// the bytecode.
+//
+// The VM only saves ip before operations that can raise or call, so a sample
+// is attributed to the most recent such operation, which is nearly always on
+// the same line.
+
+#ifndef MICROPY_UPROFILE_START_TIMER
+#define MICROPY_UPROFILE_START_TIMER()
+#define MICROPY_UPROFILE_STOP_TIMER()
+#endif
+
+typedef struct _uprofile_t {
+    uint32_t period;
+    uint32_t countdown;
+    volatile bool running;
+    uint32_t samples;
+    // Samples taken while no bytecode was running.
+    uint32_t idle;
+    // Each entry holds its sample count.
+    sampletable_t *table;
+} uprofile_t;
+
+void uprofile_tick(void) {
+    uprofile_t *p = MP_STATE_VM(uprofile);
+    if (p == NULL || !p->running) {
+        return;
+    }
+    if (--p->countdown > 0) {
+        return;
+    }
+    p->countdown = p->period;
+    p->samples += 1;
+
+    mp_code_state_t *code_state = MP_STATE_THREAD(current_code_state);
+    if (code_state == NULL) {
+        p->idle += 1;
+        return;
+    }
+    const mp_obj_fun_bc_t *fun_bc = code_state->fun_bc;
+    size_t *count = sampletable_lookup(p->table, fun_bc, code_state->ip - fun_bc->bytecode, NULL);
+    if (count != NULL) {
+        *count += 1;
+    }
+}
+
+void uprofile_reset(void) {
+    if (MP_STATE_VM(uprofile) != NULL) {
+        MP_STATE_VM(uprofile)->running = false;
+        MICROPY_UPROFILE_STOP_TIMER();
+        MP_STATE_VM(uprofile) = NULL;
+    }
+}
+
+STATIC uprofile_t *get_profile(void) {
+    uprofile_t *p = MP_STATE_VM(uprofile);
+    if (p == NULL) {
+        mp_raise_RuntimeError(translate("Profiler not started"));
+    }
+    return p;
+}
+
+STATIC mp_obj_t uprofile_start(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_period, ARG_size };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_period, MP_ARG_INT, {.u_int = 1} },
+        { MP_QSTR_size, MP_ARG_INT, {.u_int = 64} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    if (args[ARG_period].u_int < 1 || args[ARG_size].u_int < 1) {
+        mp_raise_ValueError(NULL);
+    }
+
+    uprofile_reset();
+    uprofile_t *p = m_new0(uprofile_t, 1);
+    p->table = sampletable_new(args[ARG_size].u_int, 1);
+    p->period = args[ARG_period].u_int;
+    p->countdown = p->period;
+    p->running = true;
+    MP_STATE_VM(uprofile) = p;
+    MICROPY_UPROFILE_START_TIMER();
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(uprofile_start_obj, 0, uprofile_start);
+
+STATIC mp_obj_t uprofile_stop(void) {
+    uprofile_t *p = get_profile();
+    p->running = false;
+    MICROPY_UPROFILE_STOP_TIMER();
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(uprofile_stop_obj, uprofile_stop);
+
+STATIC mp_obj_t uprofile_info(void) {
+    uprofile_t *p = get_profile();
+    mp_obj_t items[3] = {
+        mp_obj_new_int_from_uint(p->samples),
+        mp_obj_new_int_from_uint(p->idle),
+        mp_obj_new_int_from_uint(p->table->dropped),
+    };
+    return mp_obj_new_tuple(3, items);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(uprofile_info_obj, uprofile_info);
+
+// Merge the samples by source line, most sampled first. Returns the number of
+// lines filled in.
+STATIC size_t uprofile_collect(uprofile_t *p, sampletable_line_t *lines) {
+    bool was_running = p->running;
+    p->running = false;
+    size_t n = sampletable_lines(p->table, lines);
+    p->running = was_running;
+    return n;
+}
+
+STATIC mp_obj_t uprofile_results(void) {
+    uprofile_t *p = get_profile();
+    sampletable_line_t *lines = m_new(sampletable_line_t, p->table->size);
+    size_t n = uprofile_collect(p, lines);
+    mp_obj_t list = mp_obj_new_list(0, NULL);
+    for (size_t i = 0; i < n; i++) {
+        mp_obj_t items[4] = {
+            mp_obj_new_int_from_uint(lines[i].values[0]),
+            MP_OBJ_NEW_QSTR(lines[i].source_file),
+            MP_OBJ_NEW_SMALL_INT(lines[i].line),
+            MP_OBJ_NEW_QSTR(lines[i].block_name),
+        };
+        mp_obj_list_append(list, mp_obj_new_tuple(4, items));
+    }
+    m_del(sampletable_line_t, lines, p->table->size);
+    return list;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(uprofile_results_obj, uprofile_results);
+
+STATIC mp_obj_t uprofile_dump(size_t n_args, const mp_obj_t *args) {
+    uprofile_t *p = get_profile();
+    mp_print_t stream_print;
+    const mp_print_t *print = MP_PYTHON_PRINTER;
+    if (n_args > 0 && args[0] != mp_const_none) {
+        mp_get_stream_raise(args[0], MP_STREAM_OP_WRITE);
+        stream_print.data = MP_OBJ_TO_PTR(args[0]);
+        stream_print.print_strn = mp_stream_write_adaptor;
+        print = &stream_print;
+    }
+    sampletable_line_t *lines = m_new(sampletable_line_t, p->table->size);
+    size_t n = uprofile_collect(p, lines);
+    mp_printf(print, "%u samples, %u idle, %u dropped\n", (uint)p->samples, (uint)p->idle, (uint)p->table->dropped);
+    for (size_t i = 0; i < n; i++) {
+        mp_printf(print, "%8u %q:%u %q\n", (uint)lines[i].values[0], lines[i].source_file,
+            (uint)lines[i].line, lines[i].block_name);
+    }
+    m_del(sampletable_line_t, lines, p->table->size);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(uprofile_dump_obj, 0, 1, uprofile_dump);
+
+STATIC const mp_rom_map_elem_t mp_module_uprofile_globals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_uprofile) },
+    { MP_ROM_QSTR(MP_QSTR_start), MP_ROM_PTR(&uprofile_start_obj) },
+    { MP_ROM_QSTR(MP_QSTR_stop), MP_ROM_PTR(&uprofile_stop_obj) },
+    { MP_ROM_QSTR(MP_QSTR_info), MP_ROM_PTR(&uprofile_info_obj) },
+    { MP_ROM_QSTR(MP_QSTR_results), MP_ROM_PTR(&uprofile_results_obj) },
+    { MP_ROM_QSTR(MP_QSTR_dump), MP_ROM_PTR(&uprofile_dump_obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(mp_module_uprofile_globals, mp_module_uprofile_globals_table);
+
+const mp_obj_module_t mp_module_uprofile = {
+    .base = { &mp_type_module },
+    .globals = (mp_obj_dict_t*)&mp_module_uprofile_globals,
+};
+
+#endif // MICROPY_PY_UPROFILE
@@ -37,6 +37,11 @@
 #include "py/mperrno.h"
 #include "py/mphal.h"
 
+// Ports without their own way to wait for events idle for a tick between polls.
+#ifndef MICROPY_EVENT_POLL_HOOK
+#define MICROPY_EVENT_POLL_HOOK mp_hal_delay_ms(1); mp_handle_pending();
+#endif
+
 // Flags for poll()
 #define FLAG_ONESHOT (1)
 
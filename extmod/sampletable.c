@@ -0,0 +1,130 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+
+#include "py/bc.h"
+#include "py/runtime.h"
+#include "extmod/sampletable.h"
+
+#if MICROPY_PY_UPROFILE || MICROPY_PY_UHEAP
+
+// How many slots to try before counting a sample as dropped.
+#define SAMPLETABLE_MAX_PROBE (8)
+
+STATIC size_t sampletable_stride(size_t n_values) {
+    return sizeof(sampletable_entry_t) + n_values * sizeof(size_t);
+}
+
+STATIC sampletable_entry_t *sampletable_entry(const sampletable_t *t, size_t i) {
+    return (sampletable_entry_t*)((byte*)t->entries + i * sampletable_stride(t->n_values));
+}
+
+sampletable_t *sampletable_new(size_t size, size_t n_values) {
+    assert(n_values <= SAMPLETABLE_MAX_VALUES);
+    size_t n = 1;
+    while (n < size) {
+        n <<= 1;
+    }
+    sampletable_t *t = m_malloc0(sizeof(sampletable_t) + n * sampletable_stride(n_values), false);
+    t->size = n;
+    t->n_values = n_values;
+    return t;
+}
+
+size_t *sampletable_lookup(sampletable_t *t, const mp_obj_fun_bc_t *fun_bc, uint32_t offset, const void *key) {
+    size_t mask = t->size - 1;
+    size_t i = (((uintptr_t)fun_bc >> 3) ^ ((uintptr_t)key >> 2) ^ (offset * 31)) & mask;
+    for (size_t probe = 0; probe < SAMPLETABLE_MAX_PROBE; probe++) {
+        sampletable_entry_t *e = sampletable_entry(t, (i + probe) & mask);
+        if (!e->used) {
+            e->fun_bc = fun_bc;
+            e->key = key;
+            e->offset = offset;
+            e->used = true;
+            return e->values;
+        }
+        if (e->fun_bc == fun_bc && e->key == key && e->offset == offset) {
+            return e->values;
+        }
+    }
+    t->dropped += 1;
+    return NULL;
+}
+
+STATIC bool sampletable_line_before(const sampletable_line_t *a, const sampletable_line_t *b, size_t n_values) {
+    for (size_t i = 0; i < n_values; i++) {
+        if (a->values[i] != b->values[i]) {
+            return a->values[i] > b->values[i];
+        }
+    }
+    if (a->source_file != b->source_file) {
+        return a->source_file < b->source_file;
+    }
+    return a->line < b->line;
+}
+
+size_t sampletable_lines(const sampletable_t *t, sampletable_line_t *lines) {
+    size_t n = 0;
+    for (size_t i = 0; i < t->size; i++) {
+        const sampletable_entry_t *e = sampletable_entry(t, i);
+        if (!e->used) {
+            continue;
+        }
+        sampletable_line_t l = { MP_QSTR_, MP_QSTR_, 0, e->key, { 0 } };
+        if (e->fun_bc != NULL) {
+            l.line = mp_bytecode_get_source_line(e->fun_bc->bytecode, e->fun_bc->bytecode + e->offset,
+                &l.block_name, &l.source_file);
+        }
+        size_t j;
+        for (j = 0; j < n; j++) {
+            if (lines[j].line == l.line && lines[j].source_file == l.source_file
+                && lines[j].block_name == l.block_name && lines[j].key == l.key) {
+                break;
+            }
+        }
+        if (j == n) {
+            lines[n++] = l;
+        }
+        for (size_t k = 0; k < t->n_values; k++) {
+            lines[j].values[k] += e->values[k];
+        }
+    }
+
+    // Insertion sort, as there are only ever a few dozen lines.
+    for (size_t i = 1; i < n; i++) {
+        sampletable_line_t l = lines[i];
+        size_t j = i;
+        while (j > 0 && sampletable_line_before(&l, &lines[j - 1], t->n_values)) {
+            lines[j] = lines[j - 1];
+            j--;
+        }
+        lines[j] = l;
+    }
+    return n;
+}
+
+#endif // MICROPY_PY_UPROFILE || MICROPY_PY_UHEAP
@@ -0,0 +1,81 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MICROPY_INCLUDED_EXTMOD_SAMPLETABLE_H
+#define MICROPY_INCLUDED_EXTMOD_SAMPLETABLE_H
+
+#include "py/objfun.h"
+
+// The sample table shared by uprofile and uheap. Samples are counted per
+// bytecode offset in a small open addressed table, which needs no allocation
+// and so can be updated from an interrupt, and only mapped to source lines
+// when the results are asked for. The table lives on the GC heap and is
+// scanned, so the functions it refers to stay alive until it is dropped.
+
+// Most values an entry can hold.
+#define SAMPLETABLE_MAX_VALUES (3)
+
+typedef struct _sampletable_entry_t {
+    const mp_obj_fun_bc_t *fun_bc;
+    // Separates samples taken at the same offset, such as by the type that was
+    // allocated. May be NULL.
+    const void *key;
+    uint32_t offset;
+    bool used;
+    size_t values[];
+} sampletable_entry_t;
+
+typedef struct _sampletable_t {
+    size_t size;
+    size_t n_values;
+    // Samples that found no free slot.
+    uint32_t dropped;
+    size_t entries[];
+} sampletable_t;
+
+typedef struct _sampletable_line_t {
+    qstr source_file;
+    qstr block_name;
+    size_t line;
+    const void *key;
+    size_t values[SAMPLETABLE_MAX_VALUES];
+} sampletable_line_t;
+
+// Allocate a table of at least size entries of n_values each.
+sampletable_t *sampletable_new(size_t size, size_t n_values);
+
+// Return the values of the entry for this sample, claiming a free one if it
+// is new, or NULL if there is no room for it.
+size_t *sampletable_lookup(sampletable_t *t, const mp_obj_fun_bc_t *fun_bc, uint32_t offset, const void *key);
+
+// Merge the entries by source line and key into lines, which must have room
+// for t->size of them, and return how many there are. They are sorted by
+// their values, largest first, comparing values[0] before values[1] and so on,
+// then by file and line so the order is stable. Entries without a function
+// are merged into line 0 of an empty file name.
+size_t sampletable_lines(const sampletable_t *t, sampletable_line_t *lines);
+
+#endif // MICROPY_INCLUDED_EXTMOD_SAMPLETABLE_H
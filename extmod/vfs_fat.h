@@ -73,6 +73,10 @@ MP_DECLARE_CONST_FUN_OBJ_3(fat_vfs_open_obj);
 
 mp_obj_t fat_vfs_ilistdir2(struct _fs_user_mount_t *vfs, const char *path, bool is_str_type);
 
+// Returns an object exposing at least len bytes of the block device, starting
+// at the given sector, or MP_OBJ_NULL if the device can't be read in place.
+mp_obj_t disk_get_buffer(void *pdrv, DWORD sector, size_t len, mp_buffer_info_t *bufinfo);
+
 MP_DECLARE_CONST_FUN_OBJ_KW(fsuser_mount_obj);
 MP_DECLARE_CONST_FUN_OBJ_1(fsuser_umount_obj);
 MP_DECLARE_CONST_FUN_OBJ_KW(fsuser_mkfs_obj);
@@ -243,4 +243,21 @@ DRESULT disk_ioctl (
     }
 }
 
+#if MICROPY_PERSISTENT_CODE_LOAD_XIP
+mp_obj_t disk_get_buffer(bdev_t pdrv, DWORD sector, size_t len, mp_buffer_info_t *bufinfo) {
+    fs_user_mount_t *vfs = disk_get_device(pdrv);
+    if (vfs == NULL || !(vfs->flags & FSUSER_HAVE_IOCTL)) {
+        return MP_OBJ_NULL;
+    }
+    vfs->u.ioctl[2] = MP_OBJ_NEW_SMALL_INT(BP_IOCTL_BUFFER);
+    vfs->u.ioctl[3] = MP_OBJ_NEW_SMALL_INT(sector);
+    mp_obj_t ret = mp_call_method_n_kw(2, 0, vfs->u.ioctl);
+    if (ret == mp_const_none || MP_OBJ_IS_SMALL_INT(ret)
+        || !mp_get_buffer(ret, bufinfo, MP_BUFFER_READ) || bufinfo->len < len) {
+        return MP_OBJ_NULL;
+    }
+    return ret;
+}
+#endif
+
 #endif // MICROPY_VFS && MICROPY_VFS_FAT
@@ -141,6 +141,35 @@ STATIC mp_uint_t file_obj_ioctl(mp_obj_t o_in, mp_uint_t request, uintptr_t arg,
         }
         return 0;
 
+    #if MICROPY_PERSISTENT_CODE_LOAD_XIP
+    } else if (request == MP_STREAM_GET_MMAP) {
+        // The file is only mapped if nothing can change it while the mapping
+        // is in use: it must be marked read-only, be stored in one run of
+        // clusters (fast seek reports a single fragment) and the USB host
+        // must not be able to write to the filesystem.
+        struct mp_stream_mmap_t *m = (struct mp_stream_mmap_t*)(uintptr_t)arg;
+        FIL *fp = &self->fp;
+        FATFS *fs = fp->obj.fs;
+        if ((fp->obj.attr & AM_RDO) == 0 || fp->cltbl == NULL || fp->cltbl[0] != 4
+            || fp->obj.objsize == 0 || filesystem_is_writable_by_usb(fs->drv)) {
+            *errcode = MP_EINVAL;
+            return MP_STREAM_ERROR;
+        }
+        DWORD sector = fs->database + (fp->cltbl[2] - 2) * fs->csize;
+        mp_buffer_info_t bufinfo;
+        mp_obj_t buf = disk_get_buffer(fs->drv, sector, fp->obj.objsize, &bufinfo);
+        if (buf == MP_OBJ_NULL) {
+            *errcode = MP_EINVAL;
+            return MP_STREAM_ERROR;
+        }
+        m->buf = bufinfo.buf;
+        m->len = fp->obj.objsize;
+        m->writable = false;
+        m->release = NULL;
+        m->owner = buf;
+        return 0;
+    #endif
+
     } else {
         *errcode = MP_EINVAL;
         return MP_STREAM_ERROR;
@@ -32,6 +32,9 @@
 #if defined(MICROPY_VFS_POSIX) && MICROPY_VFS_POSIX
 
 #include <fcntl.h>
+#if MICROPY_PERSISTENT_CODE_LOAD_XIP && MICROPY_READER_POSIX
+#include "py/reader.h"
+#endif
 
 #ifdef _WIN32
 #define fsync _commit
@@ -195,6 +198,19 @@ STATIC mp_uint_t vfs_posix_file_ioctl(mp_obj_t o_in, mp_uint_t request, uintptr_
             o->fd = -1;
             #endif
             return 0;
+        #if MICROPY_PERSISTENT_CODE_LOAD_XIP && MICROPY_READER_POSIX
+        case MP_STREAM_GET_MMAP: {
+            struct mp_stream_mmap_t *m = (struct mp_stream_mmap_t*)arg;
+            m->buf = mp_reader_posix_snapshot(o->fd, &m->len);
+            if (m->buf == NULL) {
+                *errcode = MP_EINVAL;
+                return MP_STREAM_ERROR;
+            }
+            m->writable = true;
+            m->release = mp_reader_posix_release;
+            return 0;
+        }
+        #endif
         default:
             *errcode = EINVAL;
             return MP_STREAM_ERROR;
@@ -38,31 +38,52 @@ typedef struct _mp_reader_vfs_t {
     mp_obj_t file;
     uint16_t len;
     uint16_t pos;
-    byte buf[24];
+    byte buf[MICROPY_READER_BUF_SIZE];
 } mp_reader_vfs_t;
 
-STATIC mp_uint_t mp_reader_vfs_readbyte(void *data) {
-    mp_reader_vfs_t *reader = (mp_reader_vfs_t*)data;
+// Refills the buffer once it has been consumed; returns false at end of file.
+STATIC bool mp_reader_vfs_fill(mp_reader_vfs_t *reader) {
     if (reader->pos >= reader->len) {
         if (reader->len < sizeof(reader->buf)) {
-            return MP_READER_EOF;
+            return false;
         } else {
             int errcode;
             reader->len = mp_stream_rw(reader->file, reader->buf, sizeof(reader->buf),
                 &errcode, MP_STREAM_RW_READ | MP_STREAM_RW_ONCE);
             if (errcode != 0) {
                 // TODO handle errors properly
-                return MP_READER_EOF;
+                reader->len = 0;
+                return false;
             }
             if (reader->len == 0) {
-                return MP_READER_EOF;
+                return false;
             }
             reader->pos = 0;
         }
     }
+    return true;
+}
+
+STATIC mp_uint_t mp_reader_vfs_readbyte(void *data) {
+    mp_reader_vfs_t *reader = (mp_reader_vfs_t*)data;
+    if (!mp_reader_vfs_fill(reader)) {
+        return MP_READER_EOF;
+    }
     return reader->buf[reader->pos++];
 }
 
+STATIC const byte *mp_reader_vfs_readchunk(void *data, size_t *len) {
+    mp_reader_vfs_t *reader = (mp_reader_vfs_t*)data;
+    if (!mp_reader_vfs_fill(reader)) {
+        *len = 0;
+        return NULL;
+    }
+    const byte *chunk = reader->buf + reader->pos;
+    *len = reader->len - reader->pos;
+    reader->pos = reader->len;
+    return chunk;
+}
+
 STATIC void mp_reader_vfs_close(void *data) {
     mp_reader_vfs_t *reader = (mp_reader_vfs_t*)data;
     mp_stream_close(reader->file);
@@ -81,7 +102,35 @@ void mp_reader_new_file(mp_reader_t *reader, const char *filename) {
     rf->pos = 0;
     reader->data = rf;
     reader->readbyte = mp_reader_vfs_readbyte;
+    reader->readchunk = mp_reader_vfs_readchunk;
     reader->close = mp_reader_vfs_close;
 }
 
+#if MICROPY_PERSISTENT_CODE_LOAD_XIP
+bool mp_reader_new_file_xip(mp_reader_t *reader, const char *filename) {
+    mp_reader_image_t *image = mp_reader_image_new();
+    mp_obj_t arg = mp_obj_new_str(filename, strlen(filename));
+    mp_obj_t file = mp_vfs_open(1, &arg, (mp_map_t*)&mp_const_empty_map);
+    const mp_stream_p_t *stream_p = mp_get_stream(file);
+    mp_uint_t res = MP_STREAM_ERROR;
+    if (stream_p->ioctl != NULL) {
+        int errcode;
+        res = stream_p->ioctl(file, MP_STREAM_GET_MMAP, (uintptr_t)&image->map, &errcode);
+    }
+    mp_stream_close(file);
+    if (res == MP_STREAM_ERROR || image->map.buf == NULL) {
+        image->map.buf = NULL;
+        return false;
+    }
+    if (image->map.release == NULL && image->map.owner == MP_OBJ_NULL) {
+        // It is never freed, so it doesn't need the image.
+        mp_reader_new_mem_xip(reader, image->map.buf, image->map.len, image->map.writable);
+        image->map.buf = NULL;
+    } else {
+        mp_reader_new_image(reader, image);
+    }
+    return true;
+}
+#endif
+
 #endif // MICROPY_READER_VFS
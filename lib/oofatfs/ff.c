@@ -3283,6 +3283,7 @@ FRESULT f_open (
                 fp->obj.sclust = ld_clust(fs, dj.dir);              /* Get allocation info */
                 fp->obj.objsize = ld_dword(dj.dir + DIR_FileSize);
             }
+            fp->obj.attr = dj.obj.attr;     /* Keep the attribute for the application */
 #if _USE_FASTSEEK
             fp->cltbl = 0;          /* Disable fast seek mode */
 #endif
@@ -74,6 +74,14 @@
 #include "supervisor/shared/bluetooth.h"
 #endif
 
+#if MICROPY_PY_UPROFILE
+#include "extmod/moduprofile.h"
+#endif
+
+#if MICROPY_PY_UHEAP
+#include "extmod/moduheap.h"
+#endif
+
 void do_str(const char *src, mp_parse_input_kind_t input_kind) {
     mp_lexer_t *lex = mp_lexer_new_from_str_len(MP_QSTR__lt_stdin_gt_, src, strlen(src), 0);
     if (lex == NULL) {
@@ -190,6 +198,13 @@ void cleanup_after_vm(supervisor_allocation* heap) {
     reset_displays();
     #endif
     filesystem_flush();
+    // Stop sampling into the profile tables before the heap they live on goes away.
+    #if MICROPY_PY_UPROFILE
+    uprofile_reset();
+    #endif
+    #if MICROPY_PY_UHEAP
+    uheap_reset();
+    #endif
     stop_mp();
     free_memory(heap);
     supervisor_move_memory();
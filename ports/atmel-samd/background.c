@@ -33,6 +33,7 @@
 
 #include "py/runtime.h"
 #include "shared-module/network/__init__.h"
+#include "supervisor/shared/background_profile.h"
 #include "supervisor/shared/stack.h"
 
 #ifdef CIRCUITPY_DISPLAYIO
@@ -62,6 +63,15 @@ STATIC void start_background_task(void) {}
 STATIC void finish_background_task(void) {}
 #endif
 
+#if CIRCUITPY_BACKGROUND_PROFILE
+uint64_t background_profile_ticks_us(void) {
+    uint64_t ms;
+    uint32_t us_until_ms;
+    current_tick(&ms, &us_until_ms);
+    return ms * 1000 + (1000 - us_until_ms);
+}
+#endif
+
 void background_tasks_reset(void) {
     running_background_tasks = false;
 }
@@ -76,19 +86,21 @@ void run_background_tasks(void) {
 
     assert_heap_ok();
     running_background_tasks = true;
+    BACKGROUND_TASK_START(BACKGROUND_TASK_ALL);
 
     #if CIRCUITPY_AUDIOIO || CIRCUITPY_AUDIOBUSIO
-    audio_dma_background();
+    BACKGROUND_TASK(BACKGROUND_TASK_AUDIO, audio_dma_background());
     #endif
     #if CIRCUITPY_DISPLAYIO
-    displayio_background();
+    BACKGROUND_TASK(BACKGROUND_TASK_DISPLAYIO, displayio_background());
     #endif
 
     #if CIRCUITPY_NETWORK
-    network_module_background();
+    BACKGROUND_TASK(BACKGROUND_TASK_NETWORK, network_module_background());
     #endif
-    filesystem_background();
-    usb_background();
+    BACKGROUND_TASK(BACKGROUND_TASK_FILESYSTEM, filesystem_background());
+    BACKGROUND_TASK(BACKGROUND_TASK_USB, usb_background());
+    BACKGROUND_TASK_END(BACKGROUND_TASK_ALL);
     running_background_tasks = false;
     assert_heap_ok();
 
@@ -37,9 +37,19 @@ ifndef CIRCUITPY_TOUCHIO_USE_NATIVE
 CIRCUITPY_TOUCHIO_USE_NATIVE = 1
 endif
 
+# The event loop and async/await don't fit alongside everything else in 256kB.
+ifndef CIRCUITPY_UASYNCIO
+CIRCUITPY_UASYNCIO = 0
+endif
+
 # SAMD21 needs separate endpoint pairs for MSC BULK IN and BULK OUT, otherwise it's erratic.
 USB_MSC_EP_NUM_OUT = 1
 
+# Keep the MSC transfer buffer to a single block to save RAM.
+ifndef USB_MSC_BUFSIZE
+USB_MSC_BUFSIZE = 512
+endif
+
 endif # samd21
 
 # Put samd51-only choices here.
@@ -45,6 +45,7 @@
 #include "mpconfigboard.h"
 #include "mphalport.h"
 #include "reset.h"
+#include "supervisor/port.h"
 #include "supervisor/shared/tick.h"
 
 extern uint32_t common_hal_mcu_processor_get_frequency(void);
@@ -60,7 +61,10 @@ void mp_hal_delay_ms(mp_uint_t delay) {
             break;
         }
         duration = (supervisor_ticks_ms64() - start_tick);
-        // TODO(tannewt): Go to sleep for a little while while we wait.
+        if (duration < delay) {
+            // Sleep until the next tick, or another interrupt, instead of spinning.
+            port_sleep_until_interrupt();
+        }
     }
 }
 
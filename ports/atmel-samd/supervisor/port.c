@@ -347,6 +347,10 @@ uint32_t port_get_saved_word(void) {
     return *safe_word;
 }
 
+void port_sleep_until_interrupt(void) {
+    __WFI();
+}
+
 /**
  * \brief Default interrupt handler for unused IRQs.
  */
@@ -28,10 +28,19 @@
 
 #include "supervisor/usb.h"
 #include "supervisor/filesystem.h"
+#include "supervisor/shared/background_profile.h"
 #include "supervisor/shared/stack.h"
+#include "supervisor/shared/tick.h"
 
 static bool running_background_tasks = false;
 
+#if CIRCUITPY_BACKGROUND_PROFILE
+// There is no sub-millisecond tick here, so durations are only as fine as the supervisor tick.
+uint64_t background_profile_ticks_us(void) {
+    return supervisor_ticks_ms64() * 1000;
+}
+#endif
+
 void background_tasks_reset(void) {
     running_background_tasks = false;
 }
@@ -44,10 +53,12 @@ void run_background_tasks(void) {
 
     assert_heap_ok();
     running_background_tasks = true;
+    BACKGROUND_TASK_START(BACKGROUND_TASK_ALL);
 
-    usb_background();
-    filesystem_background();
+    BACKGROUND_TASK(BACKGROUND_TASK_USB, usb_background());
+    BACKGROUND_TASK(BACKGROUND_TASK_FILESYSTEM, filesystem_background());
 
+    BACKGROUND_TASK_END(BACKGROUND_TASK_ALL);
     running_background_tasks = false;
     assert_heap_ok();
 }
@@ -95,3 +95,8 @@ void port_set_saved_word(uint32_t value) {
 uint32_t port_get_saved_word(void) {
     return _ebss;
 }
+
+void port_sleep_until_interrupt(void) {
+    // The tick comes from a NuttX timer hook rather than an interrupt we own,
+    // so keep polling.
+}
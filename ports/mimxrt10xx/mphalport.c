@@ -29,6 +29,7 @@
 #include "py/smallint.h"
 
 #include "shared-bindings/microcontroller/__init__.h"
+#include "supervisor/port.h"
 #include "supervisor/shared/tick.h"
 
 #include "fsl_common.h"
@@ -44,7 +45,10 @@ void mp_hal_delay_ms(mp_uint_t delay) {
             break;
         }
         duration = (supervisor_ticks_ms64() - start_tick);
-        // TODO(tannewt): Go to sleep for a little while while we wait.
+        if (duration < delay) {
+            // Sleep until the next tick, or another interrupt, instead of spinning.
+            port_sleep_until_interrupt();
+        }
     }
 }
 
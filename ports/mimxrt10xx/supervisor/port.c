@@ -156,6 +156,10 @@ uint32_t port_get_saved_word(void) {
     return __bss_end__;
 }
 
+void port_sleep_until_interrupt(void) {
+    __WFI();
+}
+
 /**
  * \brief Default interrupt handler for unused IRQs.
  */
@@ -43,13 +43,9 @@
 #include "common-hal/_bleio/CharacteristicBuffer.h"
 
 STATIC void write_to_ringbuf(bleio_characteristic_buffer_obj_t *self, uint8_t *data, uint16_t len) {
-    // Push all the data onto the ring buffer.
-    uint8_t is_nested_critical_region;
-    sd_nvic_critical_region_enter(&is_nested_critical_region);
-    for (size_t i = 0; i < len; i++) {
-        ringbuf_put(&self->ringbuf, data[i]);
-    }
-    sd_nvic_critical_region_exit(is_nested_critical_region);
+    // Push as much of the data as fits onto the ring buffer. The reader only
+    // ever takes from the other end, so it doesn't need to be locked out.
+    ringbuf_put_n(&self->ringbuf, data, len);
 }
 
 STATIC bool characteristic_buffer_on_ble_evt(ble_evt_t *ble_evt, void *param) {
@@ -92,7 +88,6 @@ void common_hal_bleio_characteristic_buffer_construct(bleio_characteristic_buffe
 
     self->characteristic = characteristic;
     self->timeout_ms = timeout * 1000;
-    // This is a macro.
     // true means long-lived, so it won't be moved.
     ringbuf_alloc(&self->ringbuf, buffer_size, true);
 
@@ -112,35 +107,16 @@ int common_hal_bleio_characteristic_buffer_read(bleio_characteristic_buffer_obj_
         }
     }
 
-    // Copy received data. Lock out write interrupt handler while copying.
-    uint8_t is_nested_critical_region;
-    sd_nvic_critical_region_enter(&is_nested_critical_region);
-
-    size_t rx_bytes = MIN(ringbuf_count(&self->ringbuf), len);
-    for ( size_t i = 0; i < rx_bytes; i++ ) {
-        data[i] = ringbuf_get(&self->ringbuf);
-    }
-
-    // Writes now OK.
-    sd_nvic_critical_region_exit(is_nested_critical_region);
-
-    return rx_bytes;
+    // Copy received data.
+    return ringbuf_get_n(&self->ringbuf, data, len);
 }
 
 uint32_t common_hal_bleio_characteristic_buffer_rx_characters_available(bleio_characteristic_buffer_obj_t *self) {
-    uint8_t is_nested_critical_region;
-    sd_nvic_critical_region_enter(&is_nested_critical_region);
-    uint16_t count = ringbuf_count(&self->ringbuf);
-    sd_nvic_critical_region_exit(is_nested_critical_region);
-    return count;
+    return ringbuf_count(&self->ringbuf);
 }
 
 void common_hal_bleio_characteristic_buffer_clear_rx_buffer(bleio_characteristic_buffer_obj_t *self) {
-    // prevent conflict with uart irq
-    uint8_t is_nested_critical_region;
-    sd_nvic_critical_region_enter(&is_nested_critical_region);
     ringbuf_clear(&self->ringbuf);
-    sd_nvic_critical_region_exit(is_nested_critical_region);
 }
 
 bool common_hal_bleio_characteristic_buffer_deinited(bleio_characteristic_buffer_obj_t *self) {
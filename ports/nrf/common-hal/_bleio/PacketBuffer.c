@@ -51,12 +51,12 @@ STATIC void write_to_ringbuf(bleio_packet_buffer_obj_t *self, uint8_t *data, uin
     uint8_t is_nested_critical_region;
     sd_nvic_critical_region_enter(&is_nested_critical_region);
     // Make room for the new value by dropping the oldest packets first.
-    while (self->ringbuf.size - ringbuf_count(&self->ringbuf) < (int) (len + sizeof(uint16_t))) {
+    // This takes from the consumer's end, so unlike a plain append it has to
+    // happen inside the critical region.
+    while (ringbuf_free(&self->ringbuf) < len + sizeof(uint16_t)) {
         uint16_t packet_length;
         ringbuf_get_n(&self->ringbuf, (uint8_t*) &packet_length, sizeof(uint16_t));
-        for (uint16_t i = 0; i < packet_length; i++) {
-            ringbuf_get(&self->ringbuf);
-        }
+        ringbuf_get_commit(&self->ringbuf, packet_length);
         // set an overflow flag?
     }
     ringbuf_put_n(&self->ringbuf, (uint8_t*) &len, sizeof(uint16_t));
@@ -195,10 +195,7 @@ void common_hal_bleio_packet_buffer_construct(
     }
 
     if (incoming) {
-        // This is a macro.
-        ringbuf_alloc(&self->ringbuf, buffer_size * (sizeof(uint16_t) + characteristic->max_length), false);
-
-        if (self->ringbuf.buf == NULL) {
+        if (!ringbuf_alloc(&self->ringbuf, buffer_size * (sizeof(uint16_t) + characteristic->max_length), false)) {
             mp_raise_ValueError(translate("Buffer too large and unable to allocate"));
         }
     }
@@ -247,19 +244,24 @@ int common_hal_bleio_packet_buffer_readinto(bleio_packet_buffer_obj_t *self, uin
         return 0;
     }
 
-    uint16_t packet_length;
-    ringbuf_get_n(&self->ringbuf, (uint8_t*) &packet_length, sizeof(uint16_t));
-
-    // Copy received data. Lock out write interrupt handler while copying.
+    // Copy received data. Lock out write interrupt handler while copying
+    // because it may drop the oldest packet to make room.
     uint8_t is_nested_critical_region;
     sd_nvic_critical_region_enter(&is_nested_critical_region);
 
+    uint16_t packet_length;
+    ringbuf_get_n(&self->ringbuf, (uint8_t*) &packet_length, sizeof(uint16_t));
+
+    size_t extra = 0;
     if (packet_length > len) {
         // TODO: raise an exception.
+        extra = packet_length - len;
         packet_length = len;
     }
 
     ringbuf_get_n(&self->ringbuf, data, packet_length);
+    // Skip what didn't fit so the next read starts at a packet boundary.
+    ringbuf_get_commit(&self->ringbuf, extra);
 
     // Writes now OK.
     sd_nvic_critical_region_exit(is_nested_critical_region);
@@ -181,10 +181,7 @@ void common_hal_busio_uart_construct (busio_uart_obj_t *self,
         // self->buffer, so do it manually.  (However, as long as internal
         // pointers like this are NOT moved, allocating the buffer
         // in the long-lived pool is not strictly necessary)
-        // (This is a macro.)
-        ringbuf_alloc(&self->rbuf, receiver_buffer_size, true);
-
-        if ( !self->rbuf.buf ) {
+        if ( !ringbuf_alloc(&self->rbuf, receiver_buffer_size, true) ) {
             nrfx_uarte_uninit(self->uarte);
             mp_raise_msg(&mp_type_MemoryError, translate("Failed to allocate RX buffer"));
         }
@@ -243,17 +240,8 @@ size_t common_hal_busio_uart_read(busio_uart_obj_t *self, uint8_t *data, size_t
         }
     }
 
-    // prevent conflict with uart irq
-    NVIC_DisableIRQ(nrfx_get_irq_number(self->uarte->p_reg));
-
-    // copy received data
-    rx_bytes = ringbuf_count(&self->rbuf);
-    rx_bytes = MIN(rx_bytes, len);
-    for ( uint16_t i = 0; i < rx_bytes; i++ ) {
-        data[i] = ringbuf_get(&self->rbuf);
-    }
-
-    NVIC_EnableIRQ(nrfx_get_irq_number(self->uarte->p_reg));
+    // copy received data; the irq only ever appends so no need to lock it out
+    rx_bytes = ringbuf_get_n(&self->rbuf, data, len);
 
     return rx_bytes;
 }
@@ -312,10 +300,7 @@ uint32_t common_hal_busio_uart_rx_characters_available(busio_uart_obj_t *self) {
 }
 
 void common_hal_busio_uart_clear_rx_buffer(busio_uart_obj_t *self) {
-    // prevent conflict with uart irq
-    NVIC_DisableIRQ(nrfx_get_irq_number(self->uarte->p_reg));
     ringbuf_clear(&self->rbuf);
-    NVIC_EnableIRQ(nrfx_get_irq_number(self->uarte->p_reg));
 }
 
 bool common_hal_busio_uart_ready_to_tx(busio_uart_obj_t *self) {
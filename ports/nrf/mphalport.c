@@ -31,6 +31,7 @@
 #include "py/mphal.h"
 #include "py/mpstate.h"
 #include "py/gc.h"
+#include "supervisor/port.h"
 #include "supervisor/shared/tick.h"
 
 /*------------------------------------------------------------------*/
@@ -47,6 +48,9 @@ void mp_hal_delay_ms(mp_uint_t delay) {
             break;
         }
         duration = (supervisor_ticks_ms64() - start_tick);
-        // TODO(tannewt): Go to sleep for a little while while we wait.
+        if (duration < delay) {
+            // Sleep until the next tick, or another interrupt, instead of spinning.
+            port_sleep_until_interrupt();
+        }
     }
 }
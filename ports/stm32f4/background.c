@@ -27,7 +27,9 @@
 #include "py/runtime.h"
 #include "supervisor/filesystem.h"
 #include "supervisor/usb.h"
+#include "supervisor/shared/background_profile.h"
 #include "supervisor/shared/stack.h"
+#include "tick.h"
 
 #if CIRCUITPY_DISPLAYIO
 #include "shared-module/displayio/__init__.h"
@@ -35,6 +37,15 @@
 
 static bool running_background_tasks = false;
 
+#if CIRCUITPY_BACKGROUND_PROFILE
+uint64_t background_profile_ticks_us(void) {
+    uint64_t ms;
+    uint32_t us_until_ms;
+    current_tick(&ms, &us_until_ms);
+    return ms * 1000 + (1000 - us_until_ms);
+}
+#endif
+
 void background_tasks_reset(void) {
     running_background_tasks = false;
 }
@@ -45,15 +56,17 @@ void run_background_tasks(void) {
         return;
     }
     running_background_tasks = true;
-    filesystem_background();
+    BACKGROUND_TASK_START(BACKGROUND_TASK_ALL);
+    BACKGROUND_TASK(BACKGROUND_TASK_FILESYSTEM, filesystem_background());
 
     #if USB_AVAILABLE
-    usb_background();
+    BACKGROUND_TASK(BACKGROUND_TASK_USB, usb_background());
     #endif
 
     #if CIRCUITPY_DISPLAYIO
-    displayio_background();
+    BACKGROUND_TASK(BACKGROUND_TASK_DISPLAYIO, displayio_background());
     #endif
+    BACKGROUND_TASK_END(BACKGROUND_TASK_ALL);
     running_background_tasks = false;
 
     assert_heap_ok();
@@ -89,6 +89,10 @@ uint32_t port_get_saved_word(void) {
     return _ebss;
 }
 
+void port_sleep_until_interrupt(void) {
+    __WFI();
+}
+
 void HardFault_Handler(void) {
     reset_into_safe_mode(HARD_CRASH);
     while (true) {
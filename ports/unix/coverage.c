@@ -13,6 +13,7 @@
 #include "py/stream.h"
 #include "py/binary.h"
 #include "py/bc.h"
+#include "py/ringbuf.h"
 
 #if defined(MICROPY_UNIX_COVERAGE)
 
@@ -420,6 +421,48 @@ STATIC mp_obj_t extra_coverage(void) {
         }
     }
 
+    // ringbuf
+    {
+        mp_printf(&mp_plat_print, "# ringbuf\n");
+
+        // any size can be used
+        ringbuf_t rb;
+        ringbuf_alloc(&rb, 6, false);
+        size_t n;
+        mp_printf(&mp_plat_print, "%d %d %d\n", (int)rb.size, (int)ringbuf_count(&rb), (int)ringbuf_free(&rb));
+
+        // single bytes, including empty
+        int v = ringbuf_get(&rb);
+        mp_printf(&mp_plat_print, "%d\n", v);
+        v = ringbuf_put(&rb, 0x12);
+        mp_printf(&mp_plat_print, "%d %d\n", v, ringbuf_get(&rb));
+
+        // bulk put drops what doesn't fit, and wraps around the end
+        uint8_t data[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+        uint8_t out[10] = {0};
+        n = ringbuf_put_n(&rb, data, 10);
+        mp_printf(&mp_plat_print, "%d %d\n", (int)n, ringbuf_put(&rb, 0));
+        n = ringbuf_get_n(&rb, out, 3);
+        mp_printf(&mp_plat_print, "%d %d %d %d\n", (int)n, out[0], out[2], (int)ringbuf_count(&rb));
+        mp_printf(&mp_plat_print, "%d\n", (int)ringbuf_put_n(&rb, data, 2));
+        n = ringbuf_get_n(&rb, out, 10);
+        mp_printf(&mp_plat_print, "%d %d %d %d\n", (int)n, out[0], out[6], (int)ringbuf_count(&rb));
+
+        // zero-copy access only sees up to the end of the buffer
+        uint8_t *ptr;
+        n = ringbuf_put_peek(&rb, &ptr);
+        mp_printf(&mp_plat_print, "%d\n", (int)n);
+        memset(ptr, 0x55, n);
+        ringbuf_put_commit(&rb, n);
+        n = ringbuf_get_peek(&rb, &ptr);
+        mp_printf(&mp_plat_print, "%d %d\n", (int)n, ptr[0]);
+        ringbuf_get_commit(&rb, 2);
+
+        // high-water mark survives clearing
+        ringbuf_clear(&rb);
+        mp_printf(&mp_plat_print, "%d %d\n", (int)ringbuf_count(&rb), (int)ringbuf_high_water(&rb));
+    }
+
     mp_obj_streamtest_t *s = m_new_obj(mp_obj_streamtest_t);
     s->base.type = &mp_type_stest_fileio;
     s->buf = NULL;
@@ -0,0 +1,104 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// audiocore without WaveFile, plus audiosim, which pulls buffers from a
+// sample the way an audio output's DMA does. Together with audiomixer they let
+// mixing be tested and timed on the host.
+
+#include "py/mperrno.h"
+#include "py/runtime.h"
+#include "shared-bindings/audiocore/RawSample.h"
+#include "shared-module/audiocore/__init__.h"
+
+#if CIRCUITPY_AUDIOCORE
+
+// WaveFile is left out because it reads FAT files directly and unix files are
+// not FAT files.
+STATIC const mp_rom_map_elem_t audiocore_module_globals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_audiocore) },
+    { MP_ROM_QSTR(MP_QSTR_RawSample), MP_ROM_PTR(&audioio_rawsample_type) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(audiocore_module_globals, audiocore_module_globals_table);
+
+const mp_obj_module_t mp_module_audiocore = {
+    .base = { &mp_type_module },
+    .globals = (mp_obj_dict_t*)&audiocore_module_globals,
+};
+
+STATIC const mp_arg_t audiosim_allowed_args[] = {
+    { MP_QSTR_sample, MP_ARG_REQUIRED | MP_ARG_OBJ },
+    { MP_QSTR_single_channel, MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = false} },
+    { MP_QSTR_channel, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0} },
+};
+enum { ARG_sample, ARG_single_channel, ARG_channel };
+
+// reset(sample, *, single_channel=False, channel=0)
+// Start the sample again from the beginning, as an output does before playing.
+STATIC mp_obj_t audiosim_reset(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    mp_arg_val_t args[MP_ARRAY_SIZE(audiosim_allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(audiosim_allowed_args), audiosim_allowed_args, args);
+    audiosample_reset_buffer(args[ARG_sample].u_obj, args[ARG_single_channel].u_bool, args[ARG_channel].u_int);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(audiosim_reset_obj, 1, audiosim_reset);
+
+// read(sample, *, single_channel=False, channel=0)
+// Return the next buffer of the sample as a memoryview, which is only valid
+// until the next read, and whether more buffers follow it. Like an output,
+// the caller should stop or reset once more is False.
+STATIC mp_obj_t audiosim_read(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    mp_arg_val_t args[MP_ARRAY_SIZE(audiosim_allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(audiosim_allowed_args), audiosim_allowed_args, args);
+    uint8_t *buffer;
+    uint32_t buffer_length;
+    audioio_get_buffer_result_t result = audiosample_get_buffer(args[ARG_sample].u_obj,
+        args[ARG_single_channel].u_bool, args[ARG_channel].u_int, &buffer, &buffer_length);
+    if (result == GET_BUFFER_ERROR) {
+        mp_raise_OSError(MP_EIO);
+    }
+    mp_obj_t tuple[2] = {
+        mp_obj_new_memoryview('B', buffer_length, buffer),
+        mp_obj_new_bool(result == GET_BUFFER_MORE_DATA),
+    };
+    return mp_obj_new_tuple(2, tuple);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(audiosim_read_obj, 1, audiosim_read);
+
+STATIC const mp_rom_map_elem_t audiosim_module_globals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_audiosim) },
+    { MP_ROM_QSTR(MP_QSTR_reset), MP_ROM_PTR(&audiosim_reset_obj) },
+    { MP_ROM_QSTR(MP_QSTR_read), MP_ROM_PTR(&audiosim_read_obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(audiosim_module_globals, audiosim_module_globals_table);
+
+const mp_obj_module_t mp_module_audiosim = {
+    .base = { &mp_type_module },
+    .globals = (mp_obj_dict_t*)&audiosim_module_globals,
+};
+
+#endif // CIRCUITPY_AUDIOCORE
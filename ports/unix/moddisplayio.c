@@ -0,0 +1,172 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// The parts of displayio that don't need a display, plus displaysim, which
+// renders a Group into a buffer the way a Display refresh does. Together they
+// let rendering be tested and timed on the host.
+
+#include <string.h>
+
+#include "py/runtime.h"
+#include "shared-bindings/displayio/Bitmap.h"
+#include "shared-bindings/displayio/ColorConverter.h"
+#include "shared-bindings/displayio/Group.h"
+#include "shared-bindings/displayio/OnDiskBitmap.h"
+#include "shared-bindings/displayio/Palette.h"
+#include "shared-bindings/displayio/Shape.h"
+#include "shared-bindings/displayio/TileGrid.h"
+#include "shared-module/displayio/area.h"
+#include "supervisor/shared/translate.h"
+
+#if CIRCUITPY_DISPLAYIO
+
+// OnDiskBitmap is left out because it reads FAT files directly and unix
+// files are not FAT files. TileGrid still checks for its type, so there is
+// one here that can't be instantiated.
+const mp_obj_type_t displayio_ondiskbitmap_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_OnDiskBitmap,
+};
+
+uint32_t common_hal_displayio_ondiskbitmap_get_pixel(displayio_ondiskbitmap_t *self,
+    int16_t x, int16_t y) {
+    (void)self;
+    (void)x;
+    (void)y;
+    return 0;
+}
+
+STATIC const mp_rom_map_elem_t displayio_module_globals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_displayio) },
+    { MP_ROM_QSTR(MP_QSTR_Bitmap), MP_ROM_PTR(&displayio_bitmap_type) },
+    { MP_ROM_QSTR(MP_QSTR_ColorConverter), MP_ROM_PTR(&displayio_colorconverter_type) },
+    { MP_ROM_QSTR(MP_QSTR_Group), MP_ROM_PTR(&displayio_group_type) },
+    { MP_ROM_QSTR(MP_QSTR_Palette), MP_ROM_PTR(&displayio_palette_type) },
+    { MP_ROM_QSTR(MP_QSTR_Shape), MP_ROM_PTR(&displayio_shape_type) },
+    { MP_ROM_QSTR(MP_QSTR_TileGrid), MP_ROM_PTR(&displayio_tilegrid_type) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(displayio_module_globals, displayio_module_globals_table);
+
+const mp_obj_module_t mp_module_displayio = {
+    .base = { &mp_type_module },
+    .globals = (mp_obj_dict_t*)&displayio_module_globals,
+};
+
+// Same size as the buffer Display uses to refresh, in uint32_ts.
+#define DISPLAYSIM_BUFFER_SIZE (128)
+
+// refresh(group, buffer, width, height, depth=16)
+// Render every pixel of group into buffer as a width x height display with
+// the given color depth, one row-aligned chunk at a time. Pixels no layer
+// covers are left as zero. Returns nothing; buffer holds the frame.
+STATIC mp_obj_t displaysim_refresh(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_group, ARG_buffer, ARG_width, ARG_height, ARG_depth };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_group, MP_ARG_REQUIRED | MP_ARG_OBJ },
+        { MP_QSTR_buffer, MP_ARG_REQUIRED | MP_ARG_OBJ },
+        { MP_QSTR_width, MP_ARG_REQUIRED | MP_ARG_INT },
+        { MP_QSTR_height, MP_ARG_REQUIRED | MP_ARG_INT },
+        { MP_QSTR_depth, MP_ARG_INT, {.u_int = 16} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    displayio_group_t *group = native_group(args[ARG_group].u_obj);
+    mp_int_t width = args[ARG_width].u_int;
+    mp_int_t height = args[ARG_height].u_int;
+    mp_int_t depth = args[ARG_depth].u_int;
+    if (width <= 0 || height <= 0 || width > 0x7fff || height > 0x7fff ||
+        (depth != 1 && depth != 2 && depth != 4 && depth != 8 && depth != 16 && depth != 24 && depth != 32) ||
+        (width * depth) % 8 != 0) {
+        mp_raise_ValueError(NULL);
+    }
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[ARG_buffer].u_obj, &bufinfo, MP_BUFFER_WRITE);
+    size_t row_bytes = width * depth / 8;
+    if (bufinfo.len < row_bytes * height) {
+        mp_raise_ValueError(translate("Buffer is too small"));
+    }
+
+    _displayio_colorspace_t colorspace;
+    memset(&colorspace, 0, sizeof(colorspace));
+    colorspace.depth = depth;
+    colorspace.grayscale = depth < 16;
+    colorspace.bytes_per_cell = 1;
+    colorspace.pixels_in_byte_share_row = true;
+
+    displayio_buffer_transform_t transform;
+    memset(&transform, 0, sizeof(transform));
+    transform.dx = 1;
+    transform.dy = 1;
+    transform.scale = 1;
+    transform.width = width;
+    transform.height = height;
+    displayio_group_update_transform(group, &transform);
+
+    uint8_t pixels_per_word = (sizeof(uint32_t) * 8) / depth;
+    mp_int_t rows_per_buffer = DISPLAYSIM_BUFFER_SIZE * pixels_per_word / width;
+    if (rows_per_buffer == 0) {
+        rows_per_buffer = 1;
+    }
+    size_t pixels_per_buffer = rows_per_buffer * width;
+    size_t buffer_size = (pixels_per_buffer + pixels_per_word - 1) / pixels_per_word;
+    uint32_t buffer[buffer_size];
+    uint32_t mask_length = (pixels_per_buffer / 32) + 1;
+    uint32_t mask[mask_length];
+
+    for (mp_int_t y = 0; y < height; y += rows_per_buffer) {
+        displayio_area_t subrectangle = {
+            .x1 = 0,
+            .y1 = y,
+            .x2 = width,
+            .y2 = y + rows_per_buffer < height ? y + rows_per_buffer : height,
+            .next = NULL,
+        };
+        memset(mask, 0, mask_length * sizeof(mask[0]));
+        memset(buffer, 0, buffer_size * sizeof(buffer[0]));
+        displayio_group_fill_area(group, &colorspace, &subrectangle, mask, buffer);
+        memcpy((uint8_t*)bufinfo.buf + y * row_bytes, buffer,
+            (subrectangle.y2 - subrectangle.y1) * row_bytes);
+    }
+    displayio_group_finish_refresh(group);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(displaysim_refresh_obj, 4, displaysim_refresh);
+
+STATIC const mp_rom_map_elem_t displaysim_module_globals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_displaysim) },
+    { MP_ROM_QSTR(MP_QSTR_refresh), MP_ROM_PTR(&displaysim_refresh_obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(displaysim_module_globals, displaysim_module_globals_table);
+
+const mp_obj_module_t mp_module_displaysim = {
+    .base = { &mp_type_module },
+    .globals = (mp_obj_dict_t*)&displaysim_module_globals,
+};
+
+#endif // CIRCUITPY_DISPLAYIO
@@ -0,0 +1,363 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// A RAM backed NOR flash that can be used as a block device, either directly
+// or through the flash translation layer used for external flash. It counts
+// what the flash is asked to do so write amplification and wear can be
+// compared, and it can cut power part way through an operation to check that
+// the filesystem survives.
+
+#include <stddef.h>
+#include <string.h>
+
+#include "py/runtime.h"
+#include "py/mperrno.h"
+#include "extmod/vfs.h"
+#include "supervisor/shared/background_profile.h"
+#include "supervisor/shared/flash_translation.h"
+#include "supervisor/shared/translate.h"
+
+#if MICROPY_PY_FLASHSIM
+
+#define SECTOR_SIZE FLASH_TRANSLATION_SECTOR_SIZE
+#define BLOCK_SIZE FLASH_TRANSLATION_BLOCK_SIZE
+
+typedef struct _flashsim_obj_t {
+    mp_obj_base_t base;
+    flash_translation_t translation;
+    uint8_t* flash;
+    uint32_t* erase_counts;
+    void* translation_ram;
+    uint16_t sector_count;
+    bool translate;
+    bool powered;
+    // Number of program and erase operations left before power is lost, or -1.
+    mp_int_t power_budget;
+    uint32_t host_writes;
+    uint32_t programmed;
+    uint32_t erases;
+} flashsim_obj_t;
+
+STATIC flashsim_obj_t* sim_from_translation(flash_translation_t* translation) {
+    return (flashsim_obj_t*) ((uint8_t*) translation - offsetof(flashsim_obj_t, translation));
+}
+
+// Returns false if power is off. When the budget runs out the current operation
+// only gets half done.
+STATIC bool use_power(flashsim_obj_t* self, bool* torn) {
+    *torn = false;
+    if (!self->powered) {
+        return false;
+    }
+    if (self->power_budget > 0) {
+        self->power_budget--;
+        if (self->power_budget == 0) {
+            self->powered = false;
+            *torn = true;
+        }
+    }
+    return true;
+}
+
+STATIC bool sim_program(flashsim_obj_t* self, uint32_t address, const uint8_t* data, uint32_t length) {
+    bool torn;
+    if (!use_power(self, &torn) || address + length > self->sector_count * SECTOR_SIZE) {
+        return false;
+    }
+    if (torn) {
+        length /= 2;
+    }
+    // NOR flash can only clear bits.
+    for (uint32_t i = 0; i < length; i++) {
+        self->flash[address + i] &= data[i];
+    }
+    self->programmed += length;
+    return !torn;
+}
+
+STATIC bool sim_erase(flashsim_obj_t* self, uint32_t sector_address) {
+    bool torn;
+    if (!use_power(self, &torn) || sector_address % SECTOR_SIZE != 0 ||
+        sector_address >= self->sector_count * SECTOR_SIZE) {
+        return false;
+    }
+    memset(self->flash + sector_address, 0xff, torn ? SECTOR_SIZE / 2 : SECTOR_SIZE);
+    self->erases++;
+    self->erase_counts[sector_address / SECTOR_SIZE]++;
+    return !torn;
+}
+
+STATIC bool sim_read(flashsim_obj_t* self, uint32_t address, uint8_t* data, uint32_t length) {
+    if (!self->powered || address + length > self->sector_count * SECTOR_SIZE) {
+        return false;
+    }
+    memcpy(data, self->flash + address, length);
+    return true;
+}
+
+STATIC bool translation_read(flash_translation_t* translation, uint32_t address, uint8_t* data, uint32_t length) {
+    return sim_read(sim_from_translation(translation), address, data, length);
+}
+
+STATIC bool translation_program(flash_translation_t* translation, uint32_t address, const uint8_t* data, uint32_t length) {
+    return sim_program(sim_from_translation(translation), address, data, length);
+}
+
+STATIC bool translation_erase(flash_translation_t* translation, uint32_t sector_address) {
+    return sim_erase(sim_from_translation(translation), sector_address);
+}
+
+STATIC const flash_translation_ops_t translation_ops = {
+    .read = translation_read,
+    .program = translation_program,
+    .erase = translation_erase,
+};
+
+// Without translation a block is programmed in place when that only clears
+// bits, otherwise its whole sector is read, erased and written back.
+STATIC bool raw_write_block(flashsim_obj_t* self, const uint8_t* data, uint32_t block) {
+    uint32_t address = block * BLOCK_SIZE;
+    bool programmable = true;
+    for (uint32_t i = 0; i < BLOCK_SIZE; i++) {
+        if ((self->flash[address + i] & data[i]) != data[i]) {
+            programmable = false;
+            break;
+        }
+    }
+    if (programmable) {
+        return sim_program(self, address, data, BLOCK_SIZE);
+    }
+    uint32_t sector_address = address - address % SECTOR_SIZE;
+    uint8_t sector[SECTOR_SIZE];
+    memcpy(sector, self->flash + sector_address, SECTOR_SIZE);
+    memcpy(sector + address % SECTOR_SIZE, data, BLOCK_SIZE);
+    return sim_erase(self, sector_address) && sim_program(self, sector_address, sector, SECTOR_SIZE);
+}
+
+STATIC bool flashsim_mount(flashsim_obj_t* self) {
+    if (!self->translate) {
+        return true;
+    }
+    flash_translation_init(&self->translation, &translation_ops, self->sector_count, self->translation_ram);
+    return flash_translation_mount(&self->translation);
+}
+
+STATIC uint32_t flashsim_block_count(flashsim_obj_t* self) {
+    if (self->translate) {
+        return self->translation.block_count;
+    }
+    return self->sector_count * (SECTOR_SIZE / BLOCK_SIZE);
+}
+
+// FlashSim(sectors, *, translate=True) creates a flash of 4096 byte erase
+// sectors. With translate the blocks are stored through the flash translation
+// layer, otherwise they map directly onto the flash.
+STATIC mp_obj_t flashsim_make_new(const mp_obj_type_t *type, size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_sectors, ARG_translate };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_sectors, MP_ARG_REQUIRED | MP_ARG_INT },
+        { MP_QSTR_translate, MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = true} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_int_t sectors = args[ARG_sectors].u_int;
+    if (sectors < 3 || sectors > 0xffff) {
+        mp_raise_ValueError(translate("Invalid argument"));
+    }
+
+    flashsim_obj_t *self = m_new_obj(flashsim_obj_t);
+    self->base.type = type;
+    self->sector_count = sectors;
+    self->translate = args[ARG_translate].u_bool;
+    self->flash = m_new(uint8_t, sectors * SECTOR_SIZE);
+    memset(self->flash, 0xff, sectors * SECTOR_SIZE);
+    self->erase_counts = m_new0(uint32_t, sectors);
+    self->translation_ram = NULL;
+    if (self->translate) {
+        self->translation_ram = m_new(uint8_t, flash_translation_ram_size(sectors));
+    }
+    self->powered = true;
+    self->power_budget = -1;
+    self->host_writes = 0;
+    self->programmed = 0;
+    self->erases = 0;
+    if (!flashsim_mount(self)) {
+        mp_raise_OSError(MP_EIO);
+    }
+    return MP_OBJ_FROM_PTR(self);
+}
+
+STATIC mp_obj_t flashsim_readblocks(mp_obj_t self_in, mp_obj_t block_num, mp_obj_t buf_in) {
+    flashsim_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_WRITE);
+    uint32_t block = mp_obj_get_int(block_num);
+    uint32_t count = bufinfo.len / BLOCK_SIZE;
+    bool ok;
+    if (self->translate) {
+        ok = self->powered && flash_translation_read_blocks(&self->translation, bufinfo.buf, block, count);
+    } else {
+        ok = block + count <= flashsim_block_count(self) &&
+            sim_read(self, block * BLOCK_SIZE, bufinfo.buf, count * BLOCK_SIZE);
+    }
+    if (!ok) {
+        mp_raise_OSError(MP_EIO);
+    }
+    return MP_OBJ_NEW_SMALL_INT(0);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_3(flashsim_readblocks_obj, flashsim_readblocks);
+
+STATIC mp_obj_t flashsim_writeblocks(mp_obj_t self_in, mp_obj_t block_num, mp_obj_t buf_in) {
+    flashsim_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_READ);
+    uint32_t block = mp_obj_get_int(block_num);
+    uint32_t count = bufinfo.len / BLOCK_SIZE;
+    self->host_writes += count;
+    bool ok;
+    if (self->translate) {
+        ok = self->powered && flash_translation_write_blocks(&self->translation, bufinfo.buf, block, count);
+    } else {
+        ok = self->powered && block + count <= flashsim_block_count(self);
+        for (uint32_t i = 0; ok && i < count; i++) {
+            ok = raw_write_block(self, (const uint8_t*) bufinfo.buf + i * BLOCK_SIZE, block + i);
+        }
+    }
+    if (!ok) {
+        mp_raise_OSError(MP_EIO);
+    }
+    return MP_OBJ_NEW_SMALL_INT(0);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_3(flashsim_writeblocks_obj, flashsim_writeblocks);
+
+STATIC mp_obj_t flashsim_ioctl(mp_obj_t self_in, mp_obj_t cmd_in, mp_obj_t arg_in) {
+    flashsim_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    (void)arg_in;
+    switch (mp_obj_get_int(cmd_in)) {
+        case BP_IOCTL_SEC_COUNT: return MP_OBJ_NEW_SMALL_INT(flashsim_block_count(self));
+        case BP_IOCTL_SEC_SIZE: return MP_OBJ_NEW_SMALL_INT(BLOCK_SIZE);
+        default: return MP_OBJ_NEW_SMALL_INT(0);
+    }
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_3(flashsim_ioctl_obj, flashsim_ioctl);
+
+// Runs one step of the translation layer's idle time garbage collection and
+// wear leveling. Returns True if there was anything to do.
+STATIC mp_obj_t flashsim_background(mp_obj_t self_in) {
+    flashsim_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if (!self->translate || !self->powered) {
+        return mp_const_false;
+    }
+    bool did_work;
+    BACKGROUND_TASK(BACKGROUND_TASK_FILESYSTEM, did_work = flash_translation_background(&self->translation));
+    return mp_obj_new_bool(did_work);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(flashsim_background_obj, flashsim_background);
+
+// Loses power during the given program or erase operation from now, leaving it
+// half done. Everything fails afterwards until power_cycle.
+STATIC mp_obj_t flashsim_cut_power(mp_obj_t self_in, mp_obj_t operations) {
+    flashsim_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    self->power_budget = mp_obj_get_int(operations);
+    if (self->power_budget <= 0) {
+        self->powered = false;
+    }
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(flashsim_cut_power_obj, flashsim_cut_power);
+
+// Restores power and forgets everything that was only held in RAM, as after a
+// reset.
+STATIC mp_obj_t flashsim_power_cycle(mp_obj_t self_in) {
+    flashsim_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    self->powered = true;
+    self->power_budget = -1;
+    if (!flashsim_mount(self)) {
+        mp_raise_OSError(MP_EIO);
+    }
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(flashsim_power_cycle_obj, flashsim_power_cycle);
+
+// Returns the blocks written by the host, the bytes programmed into the flash,
+// the sector erases, the range of erase counts across sectors and the blocks
+// moved by garbage collection since the last mount.
+STATIC mp_obj_t flashsim_stats(mp_obj_t self_in) {
+    flashsim_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    uint32_t min_erase = self->erase_counts[0];
+    uint32_t max_erase = self->erase_counts[0];
+    for (uint16_t i = 1; i < self->sector_count; i++) {
+        min_erase = MIN(min_erase, self->erase_counts[i]);
+        max_erase = MAX(max_erase, self->erase_counts[i]);
+    }
+    uint32_t relocations = 0;
+    if (self->translate) {
+        flash_translation_stats_t stats;
+        flash_translation_get_stats(&self->translation, &stats);
+        relocations = stats.relocations;
+    }
+    mp_obj_t dict = mp_obj_new_dict(6);
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_host_writes), mp_obj_new_int_from_uint(self->host_writes));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_programmed), mp_obj_new_int_from_uint(self->programmed));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_erases), mp_obj_new_int_from_uint(self->erases));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_min_erase), mp_obj_new_int_from_uint(min_erase));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_max_erase), mp_obj_new_int_from_uint(max_erase));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_relocations), mp_obj_new_int_from_uint(relocations));
+    return dict;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(flashsim_stats_obj, flashsim_stats);
+
+STATIC const mp_rom_map_elem_t flashsim_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_readblocks), MP_ROM_PTR(&flashsim_readblocks_obj) },
+    { MP_ROM_QSTR(MP_QSTR_writeblocks), MP_ROM_PTR(&flashsim_writeblocks_obj) },
+    { MP_ROM_QSTR(MP_QSTR_ioctl), MP_ROM_PTR(&flashsim_ioctl_obj) },
+    { MP_ROM_QSTR(MP_QSTR_background), MP_ROM_PTR(&flashsim_background_obj) },
+    { MP_ROM_QSTR(MP_QSTR_cut_power), MP_ROM_PTR(&flashsim_cut_power_obj) },
+    { MP_ROM_QSTR(MP_QSTR_power_cycle), MP_ROM_PTR(&flashsim_power_cycle_obj) },
+    { MP_ROM_QSTR(MP_QSTR_stats), MP_ROM_PTR(&flashsim_stats_obj) },
+};
+STATIC MP_DEFINE_CONST_DICT(flashsim_locals_dict, flashsim_locals_dict_table);
+
+STATIC const mp_obj_type_t flashsim_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_FlashSim,
+    .make_new = flashsim_make_new,
+    .locals_dict = (mp_obj_dict_t*)&flashsim_locals_dict,
+};
+
+STATIC const mp_rom_map_elem_t mp_module_flashsim_globals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_flashsim) },
+    { MP_ROM_QSTR(MP_QSTR_FlashSim), MP_ROM_PTR(&flashsim_type) },
+};
+STATIC MP_DEFINE_CONST_DICT(mp_module_flashsim_globals, mp_module_flashsim_globals_table);
+
+const mp_obj_module_t mp_module_flashsim = {
+    .base = { &mp_type_module },
+    .globals = (mp_obj_dict_t*)&mp_module_flashsim_globals,
+};
+
+#endif // MICROPY_PY_FLASHSIM
@@ -0,0 +1,63 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// The parts of the CircuitPython supervisor module that make sense on the unix
+// port, so that background task timing can be reported off the board too.
+
+#include "py/runtime.h"
+#include "py/mphal.h"
+#include "supervisor/shared/background_profile.h"
+
+#if CIRCUITPY_BACKGROUND_PROFILE
+
+uint64_t background_profile_ticks_us(void) {
+    return mp_hal_ticks_us();
+}
+
+STATIC mp_obj_t supervisor_background_stats(void) {
+    return background_profile_stats();
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(supervisor_background_stats_obj, supervisor_background_stats);
+
+STATIC mp_obj_t supervisor_reset_background_stats(void) {
+    background_profile_reset();
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(supervisor_reset_background_stats_obj, supervisor_reset_background_stats);
+
+STATIC const mp_rom_map_elem_t mp_module_supervisor_globals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_supervisor) },
+    { MP_ROM_QSTR(MP_QSTR_background_stats), MP_ROM_PTR(&supervisor_background_stats_obj) },
+    { MP_ROM_QSTR(MP_QSTR_reset_background_stats), MP_ROM_PTR(&supervisor_reset_background_stats_obj) },
+};
+STATIC MP_DEFINE_CONST_DICT(mp_module_supervisor_globals, mp_module_supervisor_globals_table);
+
+const mp_obj_module_t mp_module_supervisor = {
+    .base = { &mp_type_module },
+    .globals = (mp_obj_dict_t*)&mp_module_supervisor_globals,
+};
+
+#endif // CIRCUITPY_BACKGROUND_PROFILE
@@ -68,6 +68,7 @@ STATIC int get_fd(mp_obj_t fdlike) {
     int fd;
     // Shortcut for fdfile compatible types
     if (MP_OBJ_IS_TYPE(fdlike, &mp_type_fileio)
+        || MP_OBJ_IS_TYPE(fdlike, &mp_type_textio)
         #if MICROPY_PY_SOCKET
         || MP_OBJ_IS_TYPE(fdlike, &mp_type_socket)
         #endif
@@ -28,6 +28,7 @@
 
 #define MICROPY_ALLOC_PATH_MAX      (PATH_MAX)
 #define MICROPY_PERSISTENT_CODE_LOAD (1)
+#define MICROPY_PERSISTENT_CODE_LOAD_XIP (1)
 #if !defined(MICROPY_EMIT_X64) && defined(__x86_64__)
     #define MICROPY_EMIT_X64        (1)
 #endif
@@ -70,6 +71,10 @@
 #ifndef MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE
 #define MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE (1)
 #endif
+#ifndef MICROPY_OPT_SUPERINSTRUCTIONS
+#define MICROPY_OPT_SUPERINSTRUCTIONS (1)
+#endif
+#define MICROPY_OPT_VM_FAST_BINARY_OP (1)
 #define MICROPY_CAN_OVERRIDE_BUILTINS (1)
 #define MICROPY_PY_FUNCTION_ATTRS   (1)
 #define MICROPY_PY_DESCRIPTORS      (1)
@@ -124,6 +129,7 @@
 #define MICROPY_PY_URE              (1)
 #define MICROPY_PY_UHEAPQ           (1)
 #define MICROPY_PY_UTIMEQ           (1)
+#define MICROPY_PY_UASYNCIO         (1)
 #define MICROPY_PY_UHASHLIB         (1)
 #if MICROPY_PY_USSL
 #define MICROPY_PY_UHASHLIB_SHA1    (1)
@@ -131,6 +137,21 @@
 #define MICROPY_PY_UBINASCII        (1)
 #define MICROPY_PY_UBINASCII_CRC32  (1)
 #define MICROPY_PY_URANDOM          (1)
+// Simulated NOR flash for exercising the flash translation layer
+#ifndef MICROPY_PY_FLASHSIM
+#define MICROPY_PY_FLASHSIM         (0)
+#endif
+// The parts of displayio and audio that don't need hardware, with displaysim
+// and audiosim to drive them, for tests and benchmarks
+#ifndef CIRCUITPY_DISPLAYIO
+#define CIRCUITPY_DISPLAYIO         (1)
+#endif
+#ifndef CIRCUITPY_AUDIOCORE
+#define CIRCUITPY_AUDIOCORE         (1)
+#endif
+#ifndef CIRCUITPY_AUDIOMIXER
+#define CIRCUITPY_AUDIOMIXER        (CIRCUITPY_AUDIOCORE)
+#endif
 #ifndef MICROPY_PY_USELECT_POSIX
 #define MICROPY_PY_USELECT_POSIX    (1)
 #endif
@@ -179,6 +200,13 @@ extern const struct _mp_obj_module_t mp_module_termios;
 extern const struct _mp_obj_module_t mp_module_socket;
 extern const struct _mp_obj_module_t mp_module_ffi;
 extern const struct _mp_obj_module_t mp_module_jni;
+extern const struct _mp_obj_module_t mp_module_flashsim;
+extern const struct _mp_obj_module_t mp_module_supervisor;
+extern const struct _mp_obj_module_t mp_module_displayio;
+extern const struct _mp_obj_module_t mp_module_displaysim;
+extern const struct _mp_obj_module_t mp_module_audiocore;
+extern const struct _mp_obj_module_t mp_module_audiosim;
+extern const struct _mp_obj_module_t audiomixer_module;
 
 #if MICROPY_PY_UOS_VFS
 #define MICROPY_PY_UOS_DEF { MP_ROM_QSTR(MP_QSTR_uos), MP_ROM_PTR(&mp_module_uos_vfs) },
@@ -210,6 +238,35 @@ extern const struct _mp_obj_module_t mp_module_jni;
 #else
 #define MICROPY_PY_SOCKET_DEF
 #endif
+#if MICROPY_PY_FLASHSIM
+#define MICROPY_PY_FLASHSIM_DEF { MP_ROM_QSTR(MP_QSTR_flashsim), MP_ROM_PTR(&mp_module_flashsim) },
+#else
+#define MICROPY_PY_FLASHSIM_DEF
+#endif
+#if CIRCUITPY_BACKGROUND_PROFILE
+#define MICROPY_PY_SUPERVISOR_DEF { MP_ROM_QSTR(MP_QSTR_supervisor), MP_ROM_PTR(&mp_module_supervisor) },
+#else
+#define MICROPY_PY_SUPERVISOR_DEF
+#endif
+#if CIRCUITPY_DISPLAYIO
+#define MICROPY_PY_DISPLAYIO_DEF \
+    { MP_ROM_QSTR(MP_QSTR_displayio), MP_ROM_PTR(&mp_module_displayio) }, \
+    { MP_ROM_QSTR(MP_QSTR_displaysim), MP_ROM_PTR(&mp_module_displaysim) },
+#else
+#define MICROPY_PY_DISPLAYIO_DEF
+#endif
+#if CIRCUITPY_AUDIOCORE
+#define MICROPY_PY_AUDIOCORE_DEF \
+    { MP_ROM_QSTR(MP_QSTR_audiocore), MP_ROM_PTR(&mp_module_audiocore) }, \
+    { MP_ROM_QSTR(MP_QSTR_audiosim), MP_ROM_PTR(&mp_module_audiosim) },
+#else
+#define MICROPY_PY_AUDIOCORE_DEF
+#endif
+#if CIRCUITPY_AUDIOMIXER
+#define MICROPY_PY_AUDIOMIXER_DEF { MP_ROM_QSTR(MP_QSTR_audiomixer), MP_ROM_PTR(&audiomixer_module) },
+#else
+#define MICROPY_PY_AUDIOMIXER_DEF
+#endif
 #if MICROPY_PY_USELECT_POSIX
 #define MICROPY_PY_USELECT_DEF { MP_ROM_QSTR(MP_QSTR_uselect), MP_ROM_PTR(&mp_module_uselect) },
 #else
@@ -225,6 +282,11 @@ extern const struct _mp_obj_module_t mp_module_jni;
     MICROPY_PY_UOS_DEF \
     MICROPY_PY_USELECT_DEF \
     MICROPY_PY_TERMIOS_DEF \
+    MICROPY_PY_FLASHSIM_DEF \
+    MICROPY_PY_SUPERVISOR_DEF \
+    MICROPY_PY_DISPLAYIO_DEF \
+    MICROPY_PY_AUDIOCORE_DEF \
+    MICROPY_PY_AUDIOMIXER_DEF \
 
 // type definitions for the specific machine
 
@@ -254,6 +316,13 @@ typedef long mp_off_t;
 void mp_unix_alloc_exec(size_t min_size, void** ptr, size_t *size);
 void mp_unix_free_exec(void *ptr, size_t size);
 void mp_unix_mark_exec(void);
+
+#if MICROPY_PY_UPROFILE
+// uprofile samples from a SIGPROF interval timer rather than a tick interrupt.
+void mp_unix_uprofile_timer(int enable);
+#define MICROPY_UPROFILE_START_TIMER() mp_unix_uprofile_timer(1)
+#define MICROPY_UPROFILE_STOP_TIMER() mp_unix_uprofile_timer(0)
+#endif
 #define MP_PLAT_ALLOC_EXEC(min_size, ptr, size) mp_unix_alloc_exec(min_size, ptr, size)
 #define MP_PLAT_FREE_EXEC(ptr, size) mp_unix_free_exec(ptr, size)
 #ifndef MICROPY_FORCE_PLAT_ALLOC_EXEC
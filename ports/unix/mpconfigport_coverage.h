@@ -29,12 +29,19 @@
 
 #define MICROPY_VFS                    (1)
 #define MICROPY_PY_UOS_VFS             (1)
+#define MICROPY_PY_FLASHSIM            (1)
+#define CIRCUITPY_BACKGROUND_PROFILE   (1)
+#define MICROPY_PY_UPROFILE            (1)
+#define MICROPY_PY_UHEAP               (1)
 
 #include <mpconfigport.h>
 
 #define MICROPY_FLOAT_HIGH_QUALITY_HASH (1)
 #define MICROPY_ENABLE_SCHEDULER       (1)
+#define MICROPY_SCHEDULER_PRIORITY     (1)
 #define MICROPY_READER_VFS             (1)
+#define MICROPY_PERSISTENT_CODE_SAVE   (1)
+#define MICROPY_PERSISTENT_CODE_CACHE  (1)
 #define MICROPY_PY_DELATTR_SETATTR     (1)
 #define MICROPY_PY_REVERSE_SPECIAL_METHODS (1)
 #define MICROPY_PY_BUILTINS_RANGE_BINOP (1)
@@ -43,6 +50,7 @@
 #define MICROPY_PY_SYS_GETSIZEOF       (1)
 #define MICROPY_PY_URANDOM_EXTRA_FUNCS (1)
 #define MICROPY_PY_IO_BUFFEREDWRITER (1)
+#define MICROPY_PY_IO_BUFFEREDREADER (1)
 #define MICROPY_PY_IO_RESOURCE_STREAM (1)
 #define MICROPY_VFS_POSIX              (1)
 #undef MICROPY_VFS_FAT
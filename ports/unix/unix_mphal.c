@@ -81,6 +81,35 @@ void mp_hal_set_interrupt_char(char c) {
     }
 }
 
+#if MICROPY_PY_UPROFILE && !defined(_WIN32)
+
+#include "extmod/moduprofile.h"
+
+STATIC void uprofile_sighandler(int signum) {
+    (void)signum;
+    uprofile_tick();
+}
+
+void mp_unix_uprofile_timer(int enable) {
+    // Sample every millisecond of CPU time, like the tick on a board.
+    struct itimerval timer = {0};
+    struct sigaction sa;
+    sa.sa_flags = SA_RESTART;
+    sa.sa_handler = enable ? uprofile_sighandler : SIG_DFL;
+    sigemptyset(&sa.sa_mask);
+    if (enable) {
+        sigaction(SIGPROF, &sa, NULL);
+        timer.it_interval.tv_usec = 1000;
+        timer.it_value.tv_usec = 1000;
+        setitimer(ITIMER_PROF, &timer, NULL);
+    } else {
+        setitimer(ITIMER_PROF, &timer, NULL);
+        sigaction(SIGPROF, &sa, NULL);
+    }
+}
+
+#endif
+
 #if MICROPY_USE_READLINE == 1
 
 #include <termios.h>
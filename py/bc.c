@@ -72,6 +72,57 @@ const byte *mp_decode_uint_skip(const byte *ptr) {
     return ptr;
 }
 
+// Returns the source line of the instruction ending just before ip, as saved in
+// mp_code_state_t, and sets the name and file of the function that bytecode
+// starts.
+size_t mp_bytecode_get_source_line(const byte *bytecode, const byte *ip_in, qstr *block_name, qstr *source_file) {
+    const byte *ip = bytecode;
+    ip = mp_decode_uint_skip(ip); // skip n_state
+    ip = mp_decode_uint_skip(ip); // skip n_exc_stack
+    ip++; // skip scope_params
+    ip++; // skip n_pos_args
+    ip++; // skip n_kwonly_args
+    ip++; // skip n_def_pos_args
+    size_t bc = ip_in - ip;
+    size_t code_info_size = mp_decode_uint_value(ip);
+    ip = mp_decode_uint_skip(ip); // skip code_info_size
+    bc -= code_info_size;
+    #if MICROPY_PERSISTENT_CODE
+    *block_name = ip[0] | (ip[1] << 8);
+    *source_file = ip[2] | (ip[3] << 8);
+    ip += 4;
+    #else
+    *block_name = mp_decode_uint_value(ip);
+    ip = mp_decode_uint_skip(ip);
+    *source_file = mp_decode_uint_value(ip);
+    ip = mp_decode_uint_skip(ip);
+    #endif
+    size_t source_line = 1;
+    size_t c;
+    while ((c = *ip)) {
+        size_t b, l;
+        if ((c & 0x80) == 0) {
+            // 0b0LLBBBBB encoding
+            b = c & 0x1f;
+            l = c >> 5;
+            ip += 1;
+        } else {
+            // 0b1LLLBBBB 0bLLLLLLLL encoding (l's LSB in second byte)
+            b = c & 0xf;
+            l = ((c << 4) & 0x700) | ip[1];
+            ip += 2;
+        }
+        if (bc >= b) {
+            bc -= b;
+            source_line += l;
+        } else {
+            // found source line corresponding to bytecode offset
+            break;
+        }
+    }
+    return source_line;
+}
+
 STATIC NORETURN void fun_pos_args_mismatch(mp_obj_fun_bc_t *f, size_t expected, size_t given) {
 #if MICROPY_ERROR_REPORTING == MICROPY_ERROR_REPORTING_TERSE
     // generic message, used also for other argument issues
@@ -307,6 +358,8 @@ continue2:;
 //     MP_BC_LOAD_GLOBAL
 //     MP_BC_LOAD_ATTR
 //     MP_BC_STORE_ATTR
+// The superinstructions have a fixed number of extra bytes, see
+// mp_opcode_extra_bytes below.
 #define OC4(a, b, c, d) (a | (b << 2) | (c << 4) | (d << 6))
 #define U (0) // undefined opcode
 #define B (MP_OPCODE_BYTE) // single byte
@@ -332,8 +385,8 @@ STATIC const byte opcode_format_table[64] = {
     OC4(U, O, B, O), // 0x3c-0x3f
     OC4(O, B, B, O), // 0x40-0x43
     OC4(B, B, O, B), // 0x44-0x47
-    OC4(U, U, U, U), // 0x48-0x4b
-    OC4(U, U, U, U), // 0x4c-0x4f
+    OC4(B, B, B, O), // 0x48-0x4b
+    OC4(O, U, U, U), // 0x4c-0x4f
     OC4(V, V, U, V), // 0x50-0x53
     OC4(B, U, V, V), // 0x54-0x57
     OC4(V, V, V, B), // 0x58-0x5b
@@ -392,23 +445,38 @@ STATIC const byte opcode_format_table[64] = {
 #undef V
 #undef O
 
+STATIC size_t mp_opcode_extra_bytes(byte op) {
+    switch (op) {
+        case MP_BC_LOAD_FAST_LOAD_FAST:
+        case MP_BC_BINARY_OP_POP_JUMP_IF_FALSE:
+        case MP_BC_BINARY_OP_POP_JUMP_IF_TRUE:
+            return 1;
+        case MP_BC_BINARY_OP_FAST_IMM:
+            return 3;
+        case MP_BC_BINARY_OP_FAST_IMM_STORE:
+            return 4;
+        default:
+            return (
+                op == MP_BC_RAISE_VARARGS
+                || op == MP_BC_MAKE_CLOSURE
+                || op == MP_BC_MAKE_CLOSURE_DEFARGS
+                #if MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE
+                || op == MP_BC_LOAD_NAME
+                || op == MP_BC_LOAD_GLOBAL
+                || op == MP_BC_LOAD_ATTR
+                || op == MP_BC_STORE_ATTR
+                #endif
+            );
+    }
+}
+
 uint mp_opcode_format(const byte *ip, size_t *opcode_size) {
     uint f = (opcode_format_table[*ip >> 2] >> (2 * (*ip & 3))) & 3;
     const byte *ip_start = ip;
     if (f == MP_OPCODE_QSTR) {
         ip += 3;
     } else {
-        int extra_byte = (
-            *ip == MP_BC_RAISE_VARARGS
-            || *ip == MP_BC_MAKE_CLOSURE
-            || *ip == MP_BC_MAKE_CLOSURE_DEFARGS
-            #if MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE
-            || *ip == MP_BC_LOAD_NAME
-            || *ip == MP_BC_LOAD_GLOBAL
-            || *ip == MP_BC_LOAD_ATTR
-            || *ip == MP_BC_STORE_ATTR
-            #endif
-        );
+        size_t extra_byte = mp_opcode_extra_bytes(*ip);
         ip += 1;
         if (f == MP_OPCODE_VAR_UINT) {
             while ((*ip++ & 0x80) != 0) {
@@ -82,6 +82,14 @@
 #define MP_BC_UNWIND_JUMP        (0x46) // rel byte code offset, 16-bit signed, in excess; then a byte
 #define MP_BC_GET_ITER_STACK     (0x47)
 
+// Superinstructions, emitted in place of common sequences of the above when
+// MICROPY_OPT_SUPERINSTRUCTIONS is enabled.  Their arguments are fixed bytes.
+#define MP_BC_LOAD_FAST_LOAD_FAST          (0x48) // byte: 2 local nums (<16), low nibble first
+#define MP_BC_BINARY_OP_FAST_IMM           (0x49) // 3 bytes: local num, op, signed small int
+#define MP_BC_BINARY_OP_FAST_IMM_STORE     (0x4a) // 4 bytes: local num, op, signed small int, dest local num
+#define MP_BC_BINARY_OP_POP_JUMP_IF_FALSE  (0x4b) // rel byte code offset, 16-bit signed, in excess; then op byte
+#define MP_BC_BINARY_OP_POP_JUMP_IF_TRUE   (0x4c) // rel byte code offset, 16-bit signed, in excess; then op byte
+
 #define MP_BC_BUILD_TUPLE        (0x50) // uint
 #define MP_BC_BUILD_LIST         (0x51) // uint
 #define MP_BC_BUILD_MAP          (0x53) // uint
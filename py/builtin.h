@@ -111,6 +111,9 @@ extern const mp_obj_module_t mp_module_urandom;
 extern const mp_obj_module_t mp_module_uselect;
 extern const mp_obj_module_t mp_module_ussl;
 extern const mp_obj_module_t mp_module_utimeq;
+extern const mp_obj_module_t mp_module_uasyncio;
+extern const mp_obj_module_t mp_module_uprofile;
+extern const mp_obj_module_t mp_module_uheap;
 extern const mp_obj_module_t mp_module_machine;
 extern const mp_obj_module_t mp_module_lwip;
 extern const mp_obj_module_t mp_module_websocket;
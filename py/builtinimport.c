@@ -40,6 +40,11 @@
 
 #include "supervisor/shared/translate.h"
 
+#if MICROPY_PERSISTENT_CODE_CACHE
+#include "py/stream.h"
+#include "extmod/vfs.h"
+#endif
+
 #if MICROPY_DEBUG_VERBOSE // print debugging info
 #define DEBUG_PRINT (1)
 #define DEBUG_printf DEBUG_printf
@@ -191,6 +196,162 @@ STATIC void do_execute_raw_code(mp_obj_t module_obj, mp_raw_code_t *raw_code, co
 }
 #endif
 
+#if MICROPY_PERSISTENT_CODE_CACHE
+// The bytecode compiled from "dir/name.py" is cached in "dir/.mpycache/name.mpy"
+// when the "dir/.mpycache" directory exists. The cache file is a header holding
+// the size, mtime and a hash of the contents of the source it was compiled
+// from, followed by the .mpy image. It is used for as long as they all stay the
+// same. The size and mtime alone aren't enough: FAT mtimes only change every 2
+// seconds, and boards without a clock stamp every file they write the same, so
+// an edit that keeps the size would keep the stale bytecode. Reading the source
+// to hash it costs far less than compiling it.
+#define CACHE_DIR ".mpycache"
+#define CACHE_KEY_SIZE (12)
+
+// Fills key with the size, mtime and content hash of the file. Returns false if
+// they can't be found.
+STATIC bool cache_key(const char *file_str, byte *key) {
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        mp_obj_t *items;
+        mp_obj_get_array_fixed_n(mp_vfs_stat(mp_obj_new_str(file_str, strlen(file_str))), 10, &items);
+        mp_uint_t size = mp_obj_get_int_truncated(items[6]);
+        mp_uint_t mtime = mp_obj_get_int_truncated(items[8]);
+        // 32-bit FNV-1a of the contents.
+        uint32_t hash = 2166136261;
+        mp_reader_t reader;
+        mp_reader_new_file(&reader, file_str);
+        size_t len;
+        const byte *chunk;
+        while ((chunk = reader.readchunk(reader.data, &len)), len > 0) {
+            for (size_t i = 0; i < len; i++) {
+                hash = (hash ^ chunk[i]) * 16777619;
+            }
+        }
+        reader.close(reader.data);
+        for (int i = 0; i < 4; i++) {
+            key[i] = size >> (8 * i);
+            key[4 + i] = mtime >> (8 * i);
+            key[8 + i] = hash >> (8 * i);
+        }
+        nlr_pop();
+        return true;
+    }
+    return false;
+}
+
+// Sets cache to the cache file name of the source file, or just its directory.
+STATIC void cache_path(vstr_t *cache, const char *file_str, size_t file_len, bool dir_only) {
+    const char *base = file_str + file_len;
+    while (base > file_str && base[-1] != PATH_SEP_CHAR) {
+        base--;
+    }
+    vstr_add_strn(cache, file_str, base - file_str);
+    vstr_add_str(cache, CACHE_DIR);
+    if (!dir_only) {
+        vstr_add_char(cache, PATH_SEP_CHAR);
+        // Swap the .py extension for .mpy.
+        vstr_add_strn(cache, base, file_str + file_len - base - 2);
+        vstr_add_str(cache, "mpy");
+    }
+}
+
+// Loads the cached bytecode if it was compiled from a source with the given
+// key. Returns NULL if there isn't a usable cache file.
+STATIC mp_raw_code_t *cache_load(const char *cache_file, const byte *key) {
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        mp_reader_t reader;
+        #if MICROPY_PERSISTENT_CODE_LOAD_XIP
+        if (!mp_reader_new_file_xip(&reader, cache_file))
+        #endif
+        {
+            mp_reader_new_file(&reader, cache_file);
+        }
+        for (size_t i = 0; i < CACHE_KEY_SIZE; i++) {
+            if (reader.readbyte(reader.data) != key[i]) {
+                reader.close(reader.data);
+                nlr_pop();
+                return NULL;
+            }
+        }
+        mp_raw_code_t *raw_code = mp_raw_code_load(&reader);
+        nlr_pop();
+        return raw_code;
+    }
+    // The cache file is missing, corrupt or from another version.
+    return NULL;
+}
+
+STATIC void cache_save(const char *file_str, size_t file_len, const byte *key, mp_raw_code_t *raw_code) {
+    vstr_t data;
+    mp_print_t print;
+    vstr_init_print(&data, 256, &print);
+    vstr_t cache;
+    vstr_init(&cache, file_len + sizeof(CACHE_DIR) + 6);
+    // Set inside the nlr block and read after a jump out of it.
+    volatile mp_obj_t tmp = MP_OBJ_NULL;
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        vstr_add_strn(&data, (const char*)key, CACHE_KEY_SIZE);
+        mp_raw_code_save(raw_code, &print);
+
+        // The new cache is written next to the old one and then renamed over
+        // it, so that nothing ever loads a partly written file.
+        cache_path(&cache, file_str, file_len, false);
+        mp_obj_t cache_obj = mp_obj_new_str(cache.buf, cache.len);
+        vstr_add_str(&cache, ".tmp");
+        tmp = mp_obj_new_str(cache.buf, cache.len);
+        mp_obj_t args[2] = { tmp, MP_OBJ_NEW_QSTR(MP_QSTR_wb) };
+        mp_obj_t file = mp_vfs_open(2, args, (mp_map_t*)&mp_const_empty_map);
+        mp_obj_t written = mp_stream_write(file, data.buf, data.len, MP_STREAM_RW_WRITE);
+        mp_stream_close(file);
+        if ((size_t)mp_obj_get_int(written) != data.len) {
+            mp_raise_OSError(MP_EIO);
+        }
+        mp_vfs_rename(tmp, cache_obj);
+        nlr_pop();
+    } else if (tmp != MP_OBJ_NULL) {
+        nlr_buf_t nlr2;
+        if (nlr_push(&nlr2) == 0) {
+            mp_vfs_remove(tmp);
+            nlr_pop();
+        }
+    }
+    // Failing to write the cache, for example because the filesystem is
+    // read-only or the code is native, only means compiling again next time.
+    vstr_clear(&cache);
+    vstr_clear(&data);
+}
+
+// Loads a .py file from its bytecode cache, or compiles it and updates the
+// cache. Returns false if the file isn't cached.
+STATIC bool do_load_cached(mp_obj_t module_obj, const char *file_str, size_t file_len) {
+    vstr_t cache;
+    vstr_init(&cache, file_len + sizeof(CACHE_DIR) + 2);
+    cache_path(&cache, file_str, file_len, true);
+    byte key[CACHE_KEY_SIZE];
+    if (mp_import_stat(vstr_null_terminated_str(&cache)) != MP_IMPORT_STAT_DIR ||
+        !cache_key(file_str, key)) {
+        vstr_clear(&cache);
+        return false;
+    }
+    vstr_reset(&cache);
+    cache_path(&cache, file_str, file_len, false);
+    mp_raw_code_t *raw_code = cache_load(vstr_null_terminated_str(&cache), key);
+    vstr_clear(&cache);
+    if (raw_code == NULL) {
+        mp_lexer_t *lex = mp_lexer_new_from_file(file_str);
+        qstr source_name = lex->source_name;
+        mp_parse_tree_t parse_tree = mp_parse(lex, MP_PARSE_FILE_INPUT);
+        raw_code = mp_compile_to_raw_code(&parse_tree, source_name, MP_EMIT_OPT_NONE, false);
+        cache_save(file_str, file_len, key, raw_code);
+    }
+    do_execute_raw_code(module_obj, raw_code, file_str);
+    return true;
+}
+#endif
+
 STATIC void do_load(mp_obj_t module_obj, vstr_t *file) {
     #if MICROPY_MODULE_FROZEN || MICROPY_PERSISTENT_CODE_LOAD || MICROPY_ENABLE_COMPILER
     char *file_str = vstr_null_terminated_str(file);
@@ -241,6 +402,11 @@ STATIC void do_load(mp_obj_t module_obj, vstr_t *file) {
     // If we can compile scripts then load the file and compile and execute it.
     #if MICROPY_ENABLE_COMPILER
     {
+        #if MICROPY_PERSISTENT_CODE_CACHE
+        if (do_load_cached(module_obj, file_str, file->len)) {
+            return;
+        }
+        #endif
         mp_lexer_t *lex = mp_lexer_new_from_file(file_str);
         do_load_from_lexer(module_obj, lex);
         return;
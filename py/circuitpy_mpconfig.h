@@ -74,11 +74,13 @@
 #define MICROPY_MEM_STATS                (0)
 #define MICROPY_NONSTANDARD_TYPECODES    (0)
 #define MICROPY_OPT_COMPUTED_GOTO        (1)
+#define MICROPY_OPT_VM_FAST_BINARY_OP    (CIRCUITPY_FULL_BUILD)
 #define MICROPY_PERSISTENT_CODE_LOAD     (1)
+#define MICROPY_PERSISTENT_CODE_LOAD_XIP (CIRCUITPY_FULL_BUILD)
 
 #define MICROPY_PY_ARRAY                 (1)
 #define MICROPY_PY_ARRAY_SLICE_ASSIGN    (1)
-#define MICROPY_PY_ASYNC_AWAIT           (0)
+#define MICROPY_PY_ASYNC_AWAIT           (CIRCUITPY_UASYNCIO)
 #define MICROPY_PY_ATTRTUPLE             (1)
 
 #define MICROPY_PY_BUILTINS_BYTEARRAY    (1)
@@ -190,6 +192,8 @@ typedef long mp_off_t;
 #define MICROPY_PY_BUILTINS_STR_CENTER        (CIRCUITPY_FULL_BUILD)
 #define MICROPY_PY_BUILTINS_STR_PARTITION     (CIRCUITPY_FULL_BUILD)
 #define MICROPY_PY_BUILTINS_STR_SPLITLINES    (CIRCUITPY_FULL_BUILD)
+#define MICROPY_PY_IO_BUFFEREDREADER          (CIRCUITPY_FULL_BUILD)
+#define MICROPY_PY_IO_BUFFEREDWRITER          (CIRCUITPY_FULL_BUILD)
 #define MICROPY_PY_UERRNO                     (CIRCUITPY_FULL_BUILD)
 // Opposite setting is deliberate.
 #define MICROPY_PY_UERRNO_ERRORCODE           (!CIRCUITPY_FULL_BUILD)
@@ -199,6 +203,12 @@ typedef long mp_off_t;
 #define MICROPY_PY_URE_MATCH_GROUPS           (CIRCUITPY_FULL_BUILD)
 #define MICROPY_PY_URE_MATCH_SPAN_START_END   (CIRCUITPY_FULL_BUILD)
 #define MICROPY_PY_URE_SUB                    (CIRCUITPY_FULL_BUILD)
+// Sampled from supervisor_tick().
+#define MICROPY_PY_UPROFILE                   (CIRCUITPY_UPROFILE)
+#define MICROPY_PY_UHEAP                      (CIRCUITPY_UHEAP)
+#define MICROPY_PY_UASYNCIO                   (CIRCUITPY_UASYNCIO)
+#define MICROPY_PY_UTIMEQ                     (CIRCUITPY_UASYNCIO)
+#define MICROPY_PY_USELECT                    (CIRCUITPY_UASYNCIO)
 
 // LONGINT_IMPL_xxx are defined in the Makefile.
 //
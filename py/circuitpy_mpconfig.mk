@@ -276,7 +276,7 @@ CIRCUITPY_TOUCHIO = $(CIRCUITPY_DEFAULT_BUILD)
 endif
 CFLAGS += -DCIRCUITPY_TOUCHIO=$(CIRCUITPY_TOUCHIO)
 
-# For debugging.
+# For debugging: allocation tracing (uheap module). Costs a check on every allocation.
 ifndef CIRCUITPY_UHEAP
 CIRCUITPY_UHEAP = 0
 endif
@@ -327,3 +327,27 @@ ifndef CIRCUITPY_ENABLE_MPY_NATIVE
 CIRCUITPY_ENABLE_MPY_NATIVE = 0
 endif
 CFLAGS += -DCIRCUITPY_ENABLE_MPY_NATIVE=$(CIRCUITPY_ENABLE_MPY_NATIVE)
+
+# Decode translated messages with a 512 byte lookup table instead of a bit at a time.
+ifndef CIRCUITPY_TRANSLATE_DECODE_TABLE
+CIRCUITPY_TRANSLATE_DECODE_TABLE = $(CIRCUITPY_FULL_BUILD)
+endif
+CFLAGS += -DCIRCUITPY_TRANSLATE_DECODE_TABLE=$(CIRCUITPY_TRANSLATE_DECODE_TABLE)
+
+# Time each background task for supervisor.background_stats().
+ifndef CIRCUITPY_BACKGROUND_PROFILE
+CIRCUITPY_BACKGROUND_PROFILE = $(CIRCUITPY_FULL_BUILD)
+endif
+CFLAGS += -DCIRCUITPY_BACKGROUND_PROFILE=$(CIRCUITPY_BACKGROUND_PROFILE)
+
+# Sampling profiler for Python code (uprofile module). Costs a store on every call.
+ifndef CIRCUITPY_UPROFILE
+CIRCUITPY_UPROFILE = 0
+endif
+CFLAGS += -DCIRCUITPY_UPROFILE=$(CIRCUITPY_UPROFILE)
+
+# Native event loop (uasyncio module), with the utimeq and uselect modules it uses.
+ifndef CIRCUITPY_UASYNCIO
+CIRCUITPY_UASYNCIO = $(CIRCUITPY_FULL_BUILD)
+endif
+CFLAGS += -DCIRCUITPY_UASYNCIO=$(CIRCUITPY_UASYNCIO)
@@ -39,6 +39,14 @@
 #define BYTES_FOR_INT ((BYTES_PER_WORD * 8 + 6) / 7)
 #define DUMMY_DATA_SIZE (BYTES_FOR_INT)
 
+// What the last opcodes emitted were, as far as superinstruction fusion goes.
+// Any other opcode, a label or a new source line resets this to FUSE_NONE.
+#define FUSE_NONE (0)
+#define FUSE_LOAD_FAST (1) // LOAD_FAST fuse_local
+#define FUSE_LOAD_FAST_INT (2) // LOAD_FAST fuse_local; LOAD_CONST_SMALL_INT fuse_int
+#define FUSE_FAST_IMM (3) // BINARY_OP_FAST_IMM fuse_local fuse_op fuse_int
+#define FUSE_BINARY_OP (4) // BINARY_OP fuse_op
+
 struct _emit_t {
     // Accessed as mp_obj_t, so must be aligned as such, and we rely on the
     // memory allocator returning a suitably aligned pointer.
@@ -48,6 +56,12 @@ struct _emit_t {
     pass_kind_t pass : 8;
     mp_uint_t last_emit_was_return_value : 8;
 
+    byte fuse_kind;
+    byte fuse_local;
+    byte fuse_op;
+    int8_t fuse_int;
+    size_t fuse_offset; // bytecode offset of the first opcode of the sequence
+
     int stack_size;
 
     scope_t *scope;
@@ -171,6 +185,7 @@ STATIC void emit_write_code_info_bytes_lines(emit_t *emit, mp_uint_t bytes_to_sk
 // all functions must go through this one to emit byte code
 STATIC byte *emit_get_cur_to_write_bytecode(emit_t *emit, int num_bytes_to_write) {
     //printf("emit %d\n", num_bytes_to_write);
+    emit->fuse_kind = FUSE_NONE;
     if (emit->pass < MP_PASS_EMIT) {
         emit->bytecode_offset += num_bytes_to_write;
         return emit->dummy_data;
@@ -306,6 +321,14 @@ STATIC void emit_write_bytecode_byte_signed_label(emit_t *emit, byte b1, mp_uint
     c[2] = bytecode_offset >> 8;
 }
 
+// Superinstructions replace the opcodes of the sequence they fuse, which
+// start at fuse_offset, so writing goes back there.  The sequence is the same
+// in every pass so the code size and label offsets stay consistent.
+STATIC byte *emit_get_cur_to_write_fused(emit_t *emit, int num_bytes_to_write) {
+    emit->bytecode_offset = emit->fuse_offset;
+    return emit_get_cur_to_write_bytecode(emit, num_bytes_to_write);
+}
+
 void mp_emit_bc_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scope) {
     emit->pass = pass;
     emit->stack_size = 0;
@@ -313,6 +336,7 @@ void mp_emit_bc_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scope) {
     emit->scope = scope;
     emit->last_source_line_offset = 0;
     emit->last_source_line = 1;
+    emit->fuse_kind = FUSE_NONE;
     #ifndef NDEBUG
     // With debugging enabled labels are checked for unique assignment
     if (pass < MP_PASS_EMIT && emit->label_offsets != NULL) {
@@ -453,6 +477,7 @@ bool mp_emit_bc_last_emit_was_return_value(emit_t *emit) {
 }
 
 void mp_emit_bc_adjust_stack_size(emit_t *emit, mp_int_t delta) {
+    emit->fuse_kind = FUSE_NONE;
     if (emit->pass == MP_PASS_SCOPE) {
         return;
     }
@@ -481,6 +506,7 @@ void mp_emit_bc_set_source_line(emit_t *emit, mp_uint_t source_line) {
         emit_write_code_info_bytes_lines(emit, bytes_to_skip, lines_to_skip);
         emit->last_source_line_offset = emit->bytecode_offset;
         emit->last_source_line = source_line;
+        emit->fuse_kind = FUSE_NONE;
     }
 #else
     (void)emit;
@@ -533,12 +559,17 @@ void mp_emit_bc_load_const_tok(emit_t *emit, mp_token_kind_t tok) {
 }
 
 void mp_emit_bc_load_const_small_int(emit_t *emit, mp_int_t arg) {
+    byte fuse_kind = emit->fuse_kind;
     emit_bc_pre(emit, 1);
     if (-16 <= arg && arg <= 47) {
         emit_write_bytecode_byte(emit, MP_BC_LOAD_CONST_SMALL_INT_MULTI + 16 + arg);
     } else {
         emit_write_bytecode_byte_int(emit, MP_BC_LOAD_CONST_SMALL_INT, arg);
     }
+    if (fuse_kind == FUSE_LOAD_FAST && -128 <= arg && arg <= 127) {
+        emit->fuse_kind = FUSE_LOAD_FAST_INT;
+        emit->fuse_int = arg;
+    }
 }
 
 void mp_emit_bc_load_const_str(emit_t *emit, qstr qst) {
@@ -560,12 +591,26 @@ void mp_emit_bc_load_local(emit_t *emit, qstr qst, mp_uint_t local_num, int kind
     MP_STATIC_ASSERT(MP_BC_LOAD_FAST_N + MP_EMIT_IDOP_LOCAL_FAST == MP_BC_LOAD_FAST_N);
     MP_STATIC_ASSERT(MP_BC_LOAD_FAST_N + MP_EMIT_IDOP_LOCAL_DEREF == MP_BC_LOAD_DEREF);
     (void)qst;
+    byte fuse_kind = emit->fuse_kind;
     emit_bc_pre(emit, 1);
+    if (fuse_kind == FUSE_LOAD_FAST && emit->fuse_local <= 15
+        && kind == MP_EMIT_IDOP_LOCAL_FAST && local_num <= 15) {
+        byte *c = emit_get_cur_to_write_fused(emit, 2);
+        c[0] = MP_BC_LOAD_FAST_LOAD_FAST;
+        c[1] = emit->fuse_local | local_num << 4;
+        return;
+    }
+    size_t offset = emit->bytecode_offset;
     if (kind == MP_EMIT_IDOP_LOCAL_FAST && local_num <= 15) {
         emit_write_bytecode_byte(emit, MP_BC_LOAD_FAST_MULTI + local_num);
     } else {
         emit_write_bytecode_byte_uint(emit, MP_BC_LOAD_FAST_N + kind, local_num);
     }
+    if (MICROPY_OPT_SUPERINSTRUCTIONS_DYNAMIC && kind == MP_EMIT_IDOP_LOCAL_FAST && local_num <= 255) {
+        emit->fuse_kind = FUSE_LOAD_FAST;
+        emit->fuse_local = local_num;
+        emit->fuse_offset = offset;
+    }
 }
 
 void mp_emit_bc_load_global(emit_t *emit, qstr qst, int kind) {
@@ -624,7 +669,17 @@ void mp_emit_bc_store_local(emit_t *emit, qstr qst, mp_uint_t local_num, int kin
     MP_STATIC_ASSERT(MP_BC_STORE_FAST_N + MP_EMIT_IDOP_LOCAL_FAST == MP_BC_STORE_FAST_N);
     MP_STATIC_ASSERT(MP_BC_STORE_FAST_N + MP_EMIT_IDOP_LOCAL_DEREF == MP_BC_STORE_DEREF);
     (void)qst;
+    byte fuse_kind = emit->fuse_kind;
     emit_bc_pre(emit, -1);
+    if (fuse_kind == FUSE_FAST_IMM && kind == MP_EMIT_IDOP_LOCAL_FAST && local_num <= 255) {
+        byte *c = emit_get_cur_to_write_fused(emit, 5);
+        c[0] = MP_BC_BINARY_OP_FAST_IMM_STORE;
+        c[1] = emit->fuse_local;
+        c[2] = emit->fuse_op;
+        c[3] = emit->fuse_int;
+        c[4] = local_num;
+        return;
+    }
     if (kind == MP_EMIT_IDOP_LOCAL_FAST && local_num <= 15) {
         emit_write_bytecode_byte(emit, MP_BC_STORE_FAST_MULTI + local_num);
     } else {
@@ -684,7 +739,16 @@ void mp_emit_bc_jump(emit_t *emit, mp_uint_t label) {
 }
 
 void mp_emit_bc_pop_jump_if(emit_t *emit, bool cond, mp_uint_t label) {
+    byte fuse_kind = emit->fuse_kind;
     emit_bc_pre(emit, -1);
+    if (fuse_kind == FUSE_BINARY_OP) {
+        byte op = emit->fuse_op;
+        emit->bytecode_offset = emit->fuse_offset;
+        emit_write_bytecode_byte_signed_label(emit,
+            cond ? MP_BC_BINARY_OP_POP_JUMP_IF_TRUE : MP_BC_BINARY_OP_POP_JUMP_IF_FALSE, label);
+        emit_write_bytecode_byte(emit, op);
+        return;
+    }
     if (cond) {
         emit_write_bytecode_byte_signed_label(emit, MP_BC_POP_JUMP_IF_TRUE, label);
     } else {
@@ -785,11 +849,27 @@ void mp_emit_bc_binary_op(emit_t *emit, mp_binary_op_t op) {
         invert = true;
         op = MP_BINARY_OP_IS;
     }
+    byte fuse_kind = emit->fuse_kind;
     emit_bc_pre(emit, -1);
+    if (fuse_kind == FUSE_LOAD_FAST_INT && !invert) {
+        byte *c = emit_get_cur_to_write_fused(emit, 4);
+        c[0] = MP_BC_BINARY_OP_FAST_IMM;
+        c[1] = emit->fuse_local;
+        c[2] = op;
+        c[3] = emit->fuse_int;
+        emit->fuse_kind = FUSE_FAST_IMM;
+        emit->fuse_op = op;
+        return;
+    }
+    size_t offset = emit->bytecode_offset;
     emit_write_bytecode_byte(emit, MP_BC_BINARY_OP_MULTI + op);
     if (invert) {
         emit_bc_pre(emit, 0);
         emit_write_bytecode_byte(emit, MP_BC_UNARY_OP_MULTI + MP_UNARY_OP_NOT);
+    } else if (MICROPY_OPT_SUPERINSTRUCTIONS_DYNAMIC) {
+        emit->fuse_kind = FUSE_BINARY_OP;
+        emit->fuse_op = op;
+        emit->fuse_offset = offset;
     }
 }
 
@@ -135,6 +135,17 @@ typedef struct _stack_info_t {
     } data;
 } stack_info_t;
 
+// Where a viper local lives, as worked out by emit_native_alloc_locals().
+typedef struct _local_alloc_t {
+    mp_uint_t first; // position in the use log of the first use of the local
+    mp_uint_t last; // position of the last use, both widened to cover loops
+    mp_uint_t weight; // number of uses, with uses inside loops counting more
+    int reg; // REG_LOCAL_x holding the local, or -1 if it is in the stack frame
+    int slot; // stack frame slot of the local, or -1 if it is in a register
+} local_alloc_t;
+
+#define USE_POS_NONE ((mp_uint_t)-1)
+
 struct _emit_t {
     mp_obj_t *error_slot;
     int pass;
@@ -146,6 +157,19 @@ struct _emit_t {
     mp_uint_t local_vtype_alloc;
     vtype_kind_t *local_vtype;
 
+    // Viper locals are given registers based on the uses of each local that
+    // are logged during MP_PASS_STACK_SIZE.  Labels record their position in
+    // the use log so that jumps back to them can be recognised as loops.
+    local_alloc_t *local_alloc;
+    mp_uint_t n_local_slots;
+    bool can_alloc_locals;
+    mp_uint_t use_log_alloc;
+    mp_uint_t use_log_len;
+    uint16_t *use_log;
+    mp_uint_t max_num_labels;
+    mp_uint_t *label_pos;
+    mp_uint_t *label_loop_end;
+
     mp_uint_t stack_info_alloc;
     stack_info_t *stack_info;
     vtype_kind_t saved_stack_vtype;
@@ -166,6 +190,7 @@ struct _emit_t {
 emit_t *EXPORT_FUN(new)(mp_obj_t *error_slot, mp_uint_t max_num_labels) {
     emit_t *emit = m_new0(emit_t, 1);
     emit->error_slot = error_slot;
+    emit->max_num_labels = max_num_labels;
     emit->as = m_new0(ASM_T, 1);
     mp_asm_base_init(&emit->as->base, max_num_labels);
     return emit;
@@ -175,6 +200,11 @@ void EXPORT_FUN(free)(emit_t *emit) {
     mp_asm_base_deinit(&emit->as->base, false);
     m_del_obj(ASM_T, emit->as);
     m_del(vtype_kind_t, emit->local_vtype, emit->local_vtype_alloc);
+    m_del(local_alloc_t, emit->local_alloc, emit->local_vtype_alloc);
+    m_del(uint16_t, emit->use_log, emit->use_log_alloc);
+    if (emit->label_pos != NULL) {
+        m_del(mp_uint_t, emit->label_pos, 2 * emit->max_num_labels);
+    }
     m_del(stack_info_t, emit->stack_info, emit->stack_info_alloc);
     m_del_obj(emit_t, emit);
 }
@@ -216,6 +246,179 @@ STATIC void emit_native_store_fast(emit_t *emit, qstr qst, mp_uint_t local_num);
 
 #define STATE_START (sizeof(mp_code_state_t) / sizeof(mp_uint_t))
 
+STATIC const uint8_t local_regs[REG_LOCAL_NUM] = {REG_LOCAL_1, REG_LOCAL_2, REG_LOCAL_3};
+
+STATIC bool emit_native_logging_uses(emit_t *emit) {
+    return emit->pass == MP_PASS_STACK_SIZE && emit->do_viper_types;
+}
+
+STATIC void emit_native_log_local_use(emit_t *emit, mp_uint_t local_num) {
+    if (!emit_native_logging_uses(emit)) {
+        return;
+    }
+    if (emit->use_log_len >= emit->use_log_alloc) {
+        emit->use_log = m_renew(uint16_t, emit->use_log, emit->use_log_alloc, emit->use_log_alloc + 32);
+        emit->use_log_alloc += 32;
+    }
+    emit->use_log[emit->use_log_len++] = local_num;
+}
+
+STATIC void emit_native_log_label(emit_t *emit, mp_uint_t l) {
+    if (emit_native_logging_uses(emit)) {
+        emit->label_pos[l] = emit->use_log_len;
+    }
+}
+
+STATIC void emit_native_log_jump(emit_t *emit, mp_uint_t l) {
+    // a jump back to a label that was already seen closes a loop
+    if (emit_native_logging_uses(emit) && emit->label_pos[l] != USE_POS_NONE
+        && emit->label_loop_end[l] < emit->use_log_len) {
+        emit->label_loop_end[l] = emit->use_log_len;
+    }
+}
+
+// Decides which viper locals live in the REG_LOCAL_NUM callee-saved registers,
+// by linear scan over the live range of each local.  A live range runs from
+// the first to the last use of the local, widened to cover each loop that it
+// overlaps because the value may be carried around the loop.  Locals with
+// live ranges that don't overlap can share a register.  When more locals are
+// live than there are registers, those used least, counting uses in loops
+// eight times per level of nesting, are kept in the stack frame instead.
+// Without a use log, or when the function has exception handlers (which
+// restore the callee-saved registers when they catch), the first locals get
+// the registers as they always did.
+STATIC void emit_native_alloc_locals(emit_t *emit) {
+    local_alloc_t *la = emit->local_alloc;
+    mp_uint_t n = emit->scope->num_locals;
+    emit->n_local_slots = 0;
+
+    if (emit->pass == MP_PASS_STACK_SIZE || !emit->can_alloc_locals) {
+        for (mp_uint_t i = 0; i < n; i++) {
+            if (i < REG_LOCAL_NUM) {
+                la[i].reg = local_regs[i];
+                la[i].slot = -1;
+            } else {
+                la[i].reg = -1;
+                la[i].slot = emit->n_local_slots++;
+            }
+        }
+        return;
+    }
+
+    for (mp_uint_t i = 0; i < n; i++) {
+        // arguments are live on entry, other locals from their first use
+        la[i].first = i < emit->scope->num_pos_args ? 0 : USE_POS_NONE;
+        la[i].last = 0;
+        la[i].weight = 0;
+        la[i].reg = -1;
+        la[i].slot = -1;
+    }
+    for (mp_uint_t pos = 0; pos < emit->use_log_len; pos++) {
+        local_alloc_t *l = &la[emit->use_log[pos]];
+        if (l->first > pos) {
+            l->first = pos;
+        }
+        l->last = pos;
+        mp_uint_t w = 1;
+        for (mp_uint_t lab = 0; lab < emit->max_num_labels; lab++) {
+            if (emit->label_loop_end[lab] > pos && emit->label_pos[lab] <= pos && w < 0x1000000) {
+                w <<= 3;
+            }
+        }
+        l->weight += w;
+    }
+
+    // widening a live range to one loop can make it overlap an outer loop
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (mp_uint_t lab = 0; lab < emit->max_num_labels; lab++) {
+            mp_uint_t start = emit->label_pos[lab];
+            mp_uint_t end = emit->label_loop_end[lab];
+            if (end <= start || start == USE_POS_NONE) {
+                continue;
+            }
+            for (mp_uint_t i = 0; i < n; i++) {
+                if (la[i].first < end && la[i].last >= start
+                    && (la[i].first > start || la[i].last < end - 1)) {
+                    la[i].first = MIN(la[i].first, start);
+                    la[i].last = MAX(la[i].last, end - 1);
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    // visit the live ranges in order of their start
+    int active[REG_LOCAL_NUM];
+    for (int r = 0; r < REG_LOCAL_NUM; r++) {
+        active[r] = -1;
+    }
+    mp_uint_t prev_first = 0;
+    int prev_i = -1;
+    for (;;) {
+        int cur = -1;
+        for (mp_uint_t i = 0; i < n; i++) {
+            if (la[i].first == USE_POS_NONE
+                || la[i].first < prev_first || (la[i].first == prev_first && (int)i <= prev_i)) {
+                continue;
+            }
+            if (cur < 0 || la[i].first < la[cur].first) {
+                cur = i;
+            }
+        }
+        if (cur < 0) {
+            break;
+        }
+        prev_first = la[cur].first;
+        prev_i = cur;
+
+        int free_r = -1;
+        int weakest_r = -1;
+        for (int r = 0; r < REG_LOCAL_NUM; r++) {
+            if (active[r] >= 0 && la[active[r]].last < la[cur].first) {
+                active[r] = -1;
+            }
+            if (active[r] < 0) {
+                if (free_r < 0) {
+                    free_r = r;
+                }
+            } else if (weakest_r < 0 || la[active[r]].weight < la[active[weakest_r]].weight) {
+                weakest_r = r;
+            }
+        }
+        if (free_r < 0 && la[active[weakest_r]].weight < la[cur].weight) {
+            // spill the local that is used least for the whole of its range
+            la[active[weakest_r]].reg = -1;
+            free_r = weakest_r;
+        }
+        if (free_r >= 0) {
+            la[cur].reg = local_regs[free_r];
+            active[free_r] = cur;
+        }
+    }
+
+    for (mp_uint_t i = 0; i < n; i++) {
+        if (la[i].reg < 0 && la[i].first != USE_POS_NONE) {
+            la[i].slot = emit->n_local_slots++;
+        }
+    }
+}
+
+// Returns the register caching the given local, or -1 if there isn't one.
+STATIC int emit_native_local_reg(emit_t *emit, mp_uint_t local_num) {
+    if (emit->do_viper_types) {
+        return emit->local_alloc[local_num].reg;
+    }
+    return local_num < REG_LOCAL_NUM ? local_regs[local_num] : -1;
+}
+
+STATIC mp_uint_t emit_native_local_slot(emit_t *emit, mp_uint_t local_num) {
+    if (emit->do_viper_types) {
+        return emit->local_alloc[local_num].slot;
+    }
+    return STATE_START + emit->n_state - 1 - local_num;
+}
+
 STATIC void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scope) {
     DEBUG_printf("start_pass(pass=%u, scope=%p)\n", pass, scope);
 
@@ -228,6 +431,7 @@ STATIC void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
     // allocate memory for keeping track of the types of locals
     if (emit->local_vtype_alloc < scope->num_locals) {
         emit->local_vtype = m_renew(vtype_kind_t, emit->local_vtype, emit->local_vtype_alloc, scope->num_locals);
+        emit->local_alloc = m_renew(local_alloc_t, emit->local_alloc, emit->local_vtype_alloc, scope->num_locals);
         emit->local_vtype_alloc = scope->num_locals;
     }
 
@@ -277,13 +481,25 @@ STATIC void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
             return;
         }
 
+        if (pass == MP_PASS_STACK_SIZE) {
+            // start a new log of the uses of locals
+            if (emit->label_pos == NULL) {
+                emit->label_pos = m_new(mp_uint_t, 2 * emit->max_num_labels);
+                emit->label_loop_end = emit->label_pos + emit->max_num_labels;
+            }
+            for (mp_uint_t i = 0; i < emit->max_num_labels; i++) {
+                emit->label_pos[i] = USE_POS_NONE;
+                emit->label_loop_end[i] = 0;
+            }
+            emit->use_log_len = 0;
+            emit->can_alloc_locals = true;
+        }
+        emit_native_alloc_locals(emit);
+
         // entry to function
         int num_locals = 0;
         if (pass > MP_PASS_SCOPE) {
-            num_locals = scope->num_locals - REG_LOCAL_NUM;
-            if (num_locals < 0) {
-                num_locals = 0;
-            }
+            num_locals = emit->n_local_slots;
             emit->stack_start = num_locals;
             num_locals += scope->stack_size;
         }
@@ -298,28 +514,23 @@ STATIC void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
 
         #if N_X86
         for (int i = 0; i < scope->num_pos_args; i++) {
-            if (i == 0) {
-                asm_x86_mov_arg_to_r32(emit->as, i, REG_LOCAL_1);
-            } else if (i == 1) {
-                asm_x86_mov_arg_to_r32(emit->as, i, REG_LOCAL_2);
-            } else if (i == 2) {
-                asm_x86_mov_arg_to_r32(emit->as, i, REG_LOCAL_3);
+            int reg_local = emit_native_local_reg(emit, i);
+            if (reg_local >= 0) {
+                asm_x86_mov_arg_to_r32(emit->as, i, reg_local);
             } else {
                 asm_x86_mov_arg_to_r32(emit->as, i, REG_TEMP0);
-                asm_x86_mov_r32_to_local(emit->as, REG_TEMP0, i - REG_LOCAL_NUM);
+                asm_x86_mov_r32_to_local(emit->as, REG_TEMP0, emit_native_local_slot(emit, i));
             }
         }
         #else
+        static const uint8_t arg_regs[] = {REG_ARG_1, REG_ARG_2, REG_ARG_3, REG_ARG_4};
         for (int i = 0; i < scope->num_pos_args; i++) {
-            if (i == 0) {
-                ASM_MOV_REG_REG(emit->as, REG_LOCAL_1, REG_ARG_1);
-            } else if (i == 1) {
-                ASM_MOV_REG_REG(emit->as, REG_LOCAL_2, REG_ARG_2);
-            } else if (i == 2) {
-                ASM_MOV_REG_REG(emit->as, REG_LOCAL_3, REG_ARG_3);
+            assert(i < 4); // max 4 args is checked above
+            int reg_local = emit_native_local_reg(emit, i);
+            if (reg_local >= 0) {
+                ASM_MOV_REG_REG(emit->as, reg_local, arg_regs[i]);
             } else {
-                assert(i == 3); // should be true; max 4 args is checked above
-                ASM_MOV_LOCAL_REG(emit->as, i - REG_LOCAL_NUM, REG_ARG_4);
+                ASM_MOV_LOCAL_REG(emit->as, emit_native_local_slot(emit, i), arg_regs[i]);
             }
         }
         #endif
@@ -800,6 +1011,7 @@ STATIC void emit_native_label_assign(emit_t *emit, mp_uint_t l) {
     // need to commit stack because we can jump here from elsewhere
     need_stack_settled(emit);
     mp_asm_base_label_assign(&emit->as->base, l);
+    emit_native_log_label(emit, l);
     emit_post(emit);
 }
 
@@ -939,19 +1151,13 @@ STATIC void emit_native_load_fast(emit_t *emit, qstr qst, mp_uint_t local_num) {
         EMIT_NATIVE_VIPER_TYPE_ERROR(emit, translate("local '%q' used before type known"), qst);
     }
     emit_native_pre(emit);
-    if (local_num == 0) {
-        emit_post_push_reg(emit, vtype, REG_LOCAL_1);
-    } else if (local_num == 1) {
-        emit_post_push_reg(emit, vtype, REG_LOCAL_2);
-    } else if (local_num == 2) {
-        emit_post_push_reg(emit, vtype, REG_LOCAL_3);
+    emit_native_log_local_use(emit, local_num);
+    int reg_local = emit_native_local_reg(emit, local_num);
+    if (reg_local >= 0) {
+        emit_post_push_reg(emit, vtype, reg_local);
     } else {
         need_reg_single(emit, REG_TEMP0, 0);
-        if (emit->do_viper_types) {
-            ASM_MOV_REG_LOCAL(emit->as, REG_TEMP0, local_num - REG_LOCAL_NUM);
-        } else {
-            ASM_MOV_REG_LOCAL(emit->as, REG_TEMP0, STATE_START + emit->n_state - 1 - local_num);
-        }
+        ASM_MOV_REG_LOCAL(emit->as, REG_TEMP0, emit_native_local_slot(emit, local_num));
         emit_post_push_reg(emit, vtype, REG_TEMP0);
     }
 }
@@ -1078,6 +1284,8 @@ STATIC void emit_native_load_subscr(emit_t *emit) {
             int reg_base = REG_ARG_1;
             int reg_index = REG_ARG_2;
             emit_pre_pop_reg_flexible(emit, &vtype_base, &reg_base, reg_index, reg_index);
+            // the loaded value goes in REG_RET, so save anything else held there
+            need_reg_single(emit, REG_RET, 0);
             switch (vtype_base) {
                 case VTYPE_PTR8: {
                     // pointer to 8-bit memory
@@ -1145,6 +1353,7 @@ STATIC void emit_native_load_subscr(emit_t *emit) {
                 EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
                     translate("can't load with '%q' index"), vtype_to_qstr(vtype_index));
             }
+            need_reg_single(emit, REG_RET, 0);
             switch (vtype_base) {
                 case VTYPE_PTR8: {
                     // pointer to 8-bit memory
@@ -1180,19 +1389,13 @@ STATIC void emit_native_load_subscr(emit_t *emit) {
 
 STATIC void emit_native_store_fast(emit_t *emit, qstr qst, mp_uint_t local_num) {
     vtype_kind_t vtype;
-    if (local_num == 0) {
-        emit_pre_pop_reg(emit, &vtype, REG_LOCAL_1);
-    } else if (local_num == 1) {
-        emit_pre_pop_reg(emit, &vtype, REG_LOCAL_2);
-    } else if (local_num == 2) {
-        emit_pre_pop_reg(emit, &vtype, REG_LOCAL_3);
+    emit_native_log_local_use(emit, local_num);
+    int reg_local = emit_native_local_reg(emit, local_num);
+    if (reg_local >= 0) {
+        emit_pre_pop_reg(emit, &vtype, reg_local);
     } else {
         emit_pre_pop_reg(emit, &vtype, REG_TEMP0);
-        if (emit->do_viper_types) {
-            ASM_MOV_LOCAL_REG(emit->as, local_num - REG_LOCAL_NUM, REG_TEMP0);
-        } else {
-            ASM_MOV_LOCAL_REG(emit->as, STATE_START + emit->n_state - 1 - local_num, REG_TEMP0);
-        }
+        ASM_MOV_LOCAL_REG(emit->as, emit_native_local_slot(emit, local_num), REG_TEMP0);
     }
     emit_post(emit);
 
@@ -1537,6 +1740,7 @@ STATIC void emit_native_jump(emit_t *emit, mp_uint_t label) {
     // need to commit stack because we are jumping elsewhere
     need_stack_settled(emit);
     ASM_JUMP(emit->as, label);
+    emit_native_log_jump(emit, label);
     emit_post(emit);
 }
 
@@ -1575,6 +1779,7 @@ STATIC void emit_native_pop_jump_if(emit_t *emit, bool cond, mp_uint_t label) {
     } else {
         ASM_JUMP_IF_REG_ZERO(emit->as, REG_RET, label);
     }
+    emit_native_log_jump(emit, label);
     emit_post(emit);
 }
 
@@ -1586,6 +1791,7 @@ STATIC void emit_native_jump_if_or_pop(emit_t *emit, bool cond, mp_uint_t label)
     } else {
         ASM_JUMP_IF_REG_ZERO(emit->as, REG_RET, label);
     }
+    emit_native_log_jump(emit, label);
     adjust_stack(emit, -1);
     emit_post(emit);
 }
@@ -1638,6 +1844,9 @@ STATIC void emit_native_setup_with(emit_t *emit, mp_uint_t label) {
 }
 
 STATIC void emit_native_setup_block(emit_t *emit, mp_uint_t label, int kind) {
+    if (emit_native_logging_uses(emit)) {
+        emit->can_alloc_locals = false;
+    }
     if (kind == MP_EMIT_SETUP_BLOCK_WITH) {
         emit_native_setup_with(emit, label);
     } else {
@@ -33,6 +33,10 @@
 
 #include "supervisor/shared/safe_mode.h"
 
+#if MICROPY_PY_UHEAP
+#include "extmod/moduheap.h"
+#endif
+
 #if MICROPY_ENABLE_GC
 
 #if MICROPY_DEBUG_VERBOSE // print debugging info
@@ -639,6 +643,13 @@ void *gc_alloc(size_t n_bytes, bool has_finaliser, bool long_lived) {
     gc_dump_alloc_table();
     #endif
 
+    #if MICROPY_PY_UHEAP
+    if (MP_STATE_VM(uheap) != NULL) {
+        // collected is only left set by a collection we ran if auto collection is enabled
+        uheap_trace_alloc(ret_ptr, n_bytes, collected && MP_STATE_MEM(gc_auto_collect_enabled));
+    }
+    #endif
+
     return ret_ptr;
 }
 
@@ -704,6 +715,27 @@ void gc_free(void *ptr) {
     }
 }
 
+#if MICROPY_PY_UHEAP
+// Call fun for every allocation on the heap. The heap is locked while walking
+// so fun must not allocate.
+void gc_walk(void (*fun)(void *ptr, size_t n_bytes, void *arg), void *arg) {
+    gc_lock();
+    size_t n_total = MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB;
+    for (size_t block = 0; block < n_total; block++) {
+        if (ATB_GET_KIND(block) != AT_HEAD) {
+            continue;
+        }
+        size_t n_blocks = 1;
+        while (block + n_blocks < n_total && ATB_GET_KIND(block + n_blocks) == AT_TAIL) {
+            n_blocks += 1;
+        }
+        fun((void*)PTR_FROM_BLOCK(block), n_blocks * BYTES_PER_BLOCK, arg);
+        block += n_blocks - 1;
+    }
+    gc_unlock();
+}
+#endif
+
 size_t gc_nbytes(const void *ptr) {
     GC_ENTER();
     if (VERIFY_PTR(ptr)) {
@@ -84,6 +84,7 @@ typedef struct _gc_info_t {
 } gc_info_t;
 
 void gc_info(gc_info_t *info);
+void gc_walk(void (*fun)(void *ptr, size_t n_bytes, void *arg), void *arg);
 void gc_dump_info(void);
 void gc_dump_alloc_table(void);
 
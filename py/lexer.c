@@ -121,6 +121,66 @@ STATIC bool is_tail_of_identifier(mp_lexer_t *lex) {
     return is_head_of_identifier(lex) || is_digit(lex);
 }
 
+// Get the next raw byte of source, taking it from the reader a chunk at a time
+// when the reader supports that.
+STATIC unichar read_byte(mp_lexer_t *lex) {
+    if (lex->src_cur < lex->src_end) {
+        return *lex->src_cur++;
+    }
+    if (lex->reader.readchunk == NULL) {
+        return lex->reader.readbyte(lex->reader.data);
+    }
+    size_t len;
+    const byte *chunk = lex->reader.readchunk(lex->reader.data, &len);
+    if (len == 0) {
+        lex->src_cur = lex->src_end = NULL;
+        return MP_LEXER_EOF;
+    }
+    lex->src_cur = chunk + 1;
+    lex->src_end = chunk + len;
+    return chunk[0];
+}
+
+// A byte that can be part of a run consumed by add_run(): a plain identifier
+// character if quote_char is 0, otherwise a plain string literal character.
+// Such bytes never change the line or do anything special in next_char().
+static inline bool is_run_byte(unichar c, byte quote_char) {
+    if (quote_char == 0) {
+        return unichar_isident(c) || (c >= 0x80 && c < 0x100);
+    }
+    return c < 0x100 && c != quote_char && c != '\\' && c != '\n' && c != '\r' && c != '\t';
+}
+
+// Add the current characters and then the rest of the reader's current chunk
+// to the token text in one go, for as long as they are all run bytes.  This is
+// equivalent to repeatedly adding CUR_CHAR and calling next_char(), which the
+// caller goes on to do for whatever is left.
+STATIC void add_run(mp_lexer_t *lex, byte quote_char) {
+    if (!is_run_byte(lex->chr0, quote_char) || !is_run_byte(lex->chr1, quote_char)
+        || !is_run_byte(lex->chr2, quote_char)) {
+        return;
+    }
+    const byte *start = lex->src_cur;
+    const byte *p = start;
+    while (p < lex->src_end && is_run_byte(*p, quote_char)) {
+        ++p;
+    }
+    size_t n = p - start;
+    if (n < 3) {
+        return;
+    }
+    char *s = vstr_add_len(&lex->vstr, n);
+    s[0] = lex->chr0;
+    s[1] = lex->chr1;
+    s[2] = lex->chr2;
+    memcpy(s + 3, start, n - 3);
+    lex->chr0 = p[-3];
+    lex->chr1 = p[-2];
+    lex->chr2 = p[-1];
+    lex->src_cur = p;
+    lex->column += n;
+}
+
 STATIC void next_char(mp_lexer_t *lex) {
     if (lex->chr0 == '\n') {
         // a new line
@@ -136,14 +196,14 @@ STATIC void next_char(mp_lexer_t *lex) {
 
     lex->chr0 = lex->chr1;
     lex->chr1 = lex->chr2;
-    lex->chr2 = lex->reader.readbyte(lex->reader.data);
+    lex->chr2 = read_byte(lex);
 
     if (lex->chr1 == '\r') {
         // CR is a new line, converted to LF
         lex->chr1 = '\n';
         if (lex->chr2 == '\n') {
             // CR LF is a single new line, throw out the extra LF
-            lex->chr2 = lex->reader.readbyte(lex->reader.data);
+            lex->chr2 = read_byte(lex);
         }
     }
 
@@ -386,6 +446,7 @@ STATIC void parse_string_literal(mp_lexer_t *lex, bool is_raw) {
             } else {
                 // Add the "character" as a byte so that we remain 8-bit clean.
                 // This way, strings are parsed correctly whether or not they contain utf-8 chars.
+                add_run(lex, quote_char);
                 vstr_add_byte(&lex->vstr, CUR_CHAR(lex));
             }
         }
@@ -538,6 +599,7 @@ void mp_lexer_to_next(mp_lexer_t *lex) {
 
         // get tail chars
         while (!is_end(lex) && is_tail_of_identifier(lex)) {
+            add_run(lex, 0);
             vstr_add_byte(&lex->vstr, CUR_CHAR(lex));
             next_char(lex);
         }
@@ -674,6 +736,7 @@ mp_lexer_t *mp_lexer_new(qstr src_name, mp_reader_t reader) {
 
     lex->source_name = src_name;
     lex->reader = reader;
+    lex->src_cur = lex->src_end = NULL;
     lex->line = 1;
     lex->column = (size_t)-2; // account for 3 dummy bytes
     lex->emit_dent = 0;
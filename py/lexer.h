@@ -148,6 +148,8 @@ typedef enum _mp_token_kind_t {
 typedef struct _mp_lexer_t {
     qstr source_name;           // name of source
     mp_reader_t reader;         // stream source
+    const byte *src_cur;        // unread part of the chunk last taken from reader
+    const byte *src_end;
 
     unichar chr0, chr1, chr2;   // current cached characters from source
 
@@ -135,8 +135,31 @@ def compute_huffman_coding(translations, qstrs, compression_filename):
     with open(compression_filename, "w") as f:
         f.write("const uint8_t lengths[] = {{ {} }};\n".format(", ".join(map(str, lengths))))
         f.write("const {} values[] = {{ {} }};\n".format(values_type, ", ".join(str(ord(u)) for u in values)))
+        f.write("#if TRANSLATE_DECODE_TABLE_BITS > 0\n")
+        f.write("const uint16_t decode_table[] = {{ {} }};\n".format(", ".join(map(str, compute_decode_table(lengths)))))
+        f.write("#endif\n")
     return values, lengths
 
+# Number of leading bits looked up at once by decompress(). Must match TRANSLATE_DECODE_TABLE_BITS.
+DECODE_TABLE_BITS = 8
+
+def compute_decode_table(lengths):
+    # Each entry is indexed by the next DECODE_TABLE_BITS bits of the stream. Codes that fit are
+    # stored as (code length << 12) | index into values; longer codes leave a 0 entry and are
+    # decoded a bit at a time.
+    table = [0] * (1 << DECODE_TABLE_BITS)
+    code = 0
+    index = 0
+    for length in range(1, DECODE_TABLE_BITS + 1):
+        for _ in range(lengths[length - 1] if length <= len(lengths) else 0):
+            shift = DECODE_TABLE_BITS - length
+            for suffix in range(1 << shift):
+                table[(code << shift) | suffix] = (length << 12) | index
+            code += 1
+            index += 1
+        code <<= 1
+    return table
+
 def decompress(encoding_table, length, encoded):
     values, lengths = encoding_table
     #print(l, encoded)
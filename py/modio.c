@@ -105,6 +105,247 @@ STATIC const mp_obj_type_t mp_type_iobase = {
 
 #endif // MICROPY_PY_IO_IOBASE
 
+#if MICROPY_PY_IO_BUFFEREDREADER || MICROPY_PY_IO_BUFFEREDWRITER
+
+// Buffer size used when the constructor is not given one.
+#define BUFFERED_DEFAULT_SIZE (256)
+
+STATIC size_t buffered_alloc_arg(size_t n_args, const mp_obj_t *args) {
+    if (n_args < 2) {
+        return BUFFERED_DEFAULT_SIZE;
+    }
+    mp_int_t alloc = mp_obj_get_int(args[1]);
+    if (alloc <= 0) {
+        mp_raise_ValueError(NULL);
+    }
+    return alloc;
+}
+
+// Pass an ioctl through to the wrapped stream.
+STATIC mp_uint_t buffered_stream_ioctl(mp_obj_t stream, mp_uint_t request, uintptr_t arg, int *errcode) {
+    const mp_stream_p_t *stream_p = mp_get_stream(stream);
+    if (stream_p->ioctl == NULL) {
+        *errcode = MP_EINVAL;
+        return MP_STREAM_ERROR;
+    }
+    return stream_p->ioctl(stream, request, arg, errcode);
+}
+
+STATIC mp_obj_t buffered___exit__(size_t n_args, const mp_obj_t *args) {
+    (void)n_args;
+    return mp_stream_close(args[0]);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(buffered___exit___obj, 4, 4, buffered___exit__);
+
+#endif
+
+#if MICROPY_PY_IO_BUFFEREDREADER
+typedef struct _mp_obj_bufreader_t {
+    mp_obj_base_t base;
+    mp_obj_t stream;
+    size_t alloc;
+    size_t pos; // next unread byte in buf
+    size_t len; // end of valid data in buf
+    byte buf[0];
+} mp_obj_bufreader_t;
+
+STATIC mp_obj_t bufreader_make_new(const mp_obj_type_t *type, size_t n_args, const mp_obj_t *args, mp_map_t *kw_args) {
+    mp_arg_check_num(n_args, kw_args, 1, 2, false);
+    mp_get_stream_raise(args[0], MP_STREAM_OP_READ);
+    size_t alloc = buffered_alloc_arg(n_args, args);
+    mp_obj_bufreader_t *o = m_new_obj_var(mp_obj_bufreader_t, byte, alloc);
+    o->base.type = type;
+    o->stream = args[0];
+    o->alloc = alloc;
+    o->pos = 0;
+    o->len = 0;
+    return MP_OBJ_FROM_PTR(o);
+}
+
+// Top up the buffer with a single read of the underlying stream, moving any
+// unread bytes to the front first.  Returns the number of bytes added, 0 at
+// EOF or MP_STREAM_ERROR.
+STATIC mp_uint_t bufreader_fill(mp_obj_bufreader_t *self, int *errcode) {
+    if (self->pos != 0) {
+        memmove(self->buf, self->buf + self->pos, self->len - self->pos);
+        self->len -= self->pos;
+        self->pos = 0;
+    }
+    const mp_stream_p_t *stream_p = mp_get_stream(self->stream);
+    mp_uint_t out_sz = stream_p->read(self->stream, self->buf + self->len, self->alloc - self->len, errcode);
+    if (out_sz != MP_STREAM_ERROR) {
+        self->len += out_sz;
+    }
+    return out_sz;
+}
+
+STATIC mp_uint_t bufreader_read(mp_obj_t self_in, void *buf, mp_uint_t size, int *errcode) {
+    mp_obj_bufreader_t *self = MP_OBJ_TO_PTR(self_in);
+
+    if (self->pos == self->len) {
+        self->pos = self->len = 0;
+        if (size >= self->alloc) {
+            // Nothing buffered and the caller wants at least a buffer's
+            // worth: read straight into their memory.
+            const mp_stream_p_t *stream_p = mp_get_stream(self->stream);
+            return stream_p->read(self->stream, buf, size, errcode);
+        }
+        mp_uint_t out_sz = bufreader_fill(self, errcode);
+        if (out_sz == MP_STREAM_ERROR || out_sz == 0) {
+            return out_sz;
+        }
+    }
+
+    mp_uint_t avail = self->len - self->pos;
+    if (size > avail) {
+        size = avail;
+    }
+    memcpy(buf, self->buf + self->pos, size);
+    self->pos += size;
+    return size;
+}
+
+STATIC mp_obj_t bufreader_readline(size_t n_args, const mp_obj_t *args) {
+    mp_obj_bufreader_t *self = MP_OBJ_TO_PTR(args[0]);
+
+    size_t max_size = (size_t)-1;
+    if (n_args > 1 && args[1] != mp_const_none) {
+        mp_int_t sz = mp_obj_get_int(args[1]);
+        if (sz >= 0) {
+            max_size = sz;
+        }
+    }
+
+    // Only a line longer than the buffer is assembled in the vstr; a shorter
+    // one is returned in one piece once its newline has been buffered.
+    vstr_t vstr;
+    vstr_init(&vstr, 0);
+    for (;;) {
+        const byte *start = self->buf + self->pos;
+        size_t avail = self->len - self->pos;
+        size_t limit = max_size - vstr.len;
+        bool at_limit = avail >= limit;
+        if (at_limit) {
+            avail = limit;
+        }
+        const byte *nl = memchr(start, '\n', avail);
+        if (nl != NULL || at_limit) {
+            size_t n = nl != NULL ? (size_t)(nl + 1 - start) : avail;
+            vstr_add_strn(&vstr, (const char*)start, n);
+            self->pos += n;
+            break;
+        }
+
+        if (self->pos == 0 && self->len == self->alloc) {
+            // the buffer is full without a newline: the line is longer
+            // than the buffer, so hand over what we have and keep going
+            vstr_add_strn(&vstr, (const char*)start, avail);
+            self->pos = self->len = 0;
+        }
+
+        int error;
+        mp_uint_t out_sz = bufreader_fill(self, &error);
+        if (out_sz == MP_STREAM_ERROR) {
+            if (!mp_is_nonblocking_error(error)) {
+                mp_raise_OSError(error);
+            }
+            if (vstr.len == 0) {
+                // The partial line stays buffered for the next call; like
+                // read(), return None when nothing can be returned yet.
+                vstr_clear(&vstr);
+                return mp_const_none;
+            }
+            break;
+        }
+        if (out_sz == 0) {
+            // EOF: return whatever is left
+            vstr_add_strn(&vstr, (const char*)self->buf + self->pos, self->len - self->pos);
+            self->pos = self->len = 0;
+            break;
+        }
+    }
+
+    return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(bufreader_readline_obj, 1, 2, bufreader_readline);
+
+STATIC mp_obj_t bufreader_peek(size_t n_args, const mp_obj_t *args) {
+    mp_obj_bufreader_t *self = MP_OBJ_TO_PTR(args[0]);
+    // As in CPython the size argument is advisory: all buffered data is
+    // returned, and the stream is read once only if nothing is buffered.
+    (void)n_args;
+    if (self->pos == self->len) {
+        int error;
+        if (bufreader_fill(self, &error) == MP_STREAM_ERROR) {
+            if (mp_is_nonblocking_error(error)) {
+                return mp_const_none;
+            }
+            mp_raise_OSError(error);
+        }
+    }
+    return mp_obj_new_bytes(self->buf + self->pos, self->len - self->pos);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(bufreader_peek_obj, 1, 2, bufreader_peek);
+
+STATIC mp_uint_t bufreader_ioctl(mp_obj_t self_in, mp_uint_t request, uintptr_t arg, int *errcode) {
+    mp_obj_bufreader_t *self = MP_OBJ_TO_PTR(self_in);
+    size_t buffered = self->len - self->pos;
+
+    if (request == MP_STREAM_POLL && (arg & MP_STREAM_POLL_RD) && buffered != 0) {
+        // buffered data is readable without asking the stream
+        mp_uint_t ret = MP_STREAM_POLL_RD;
+        arg &= ~MP_STREAM_POLL_RD;
+        if (arg != 0) {
+            mp_uint_t more = buffered_stream_ioctl(self->stream, request, arg, errcode);
+            if (more == MP_STREAM_ERROR) {
+                return more;
+            }
+            ret |= more;
+        }
+        return ret;
+    }
+
+    if (request == MP_STREAM_SEEK) {
+        struct mp_stream_seek_t *seek_s = (struct mp_stream_seek_t*)arg;
+        if (seek_s->whence == MP_SEEK_CUR) {
+            // the stream is ahead of the reader by the buffered bytes
+            seek_s->offset -= buffered;
+        }
+        self->pos = self->len = 0;
+    }
+
+    return buffered_stream_ioctl(self->stream, request, arg, errcode);
+}
+
+STATIC const mp_rom_map_elem_t bufreader_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_read), MP_ROM_PTR(&mp_stream_read_obj) },
+    { MP_ROM_QSTR(MP_QSTR_readinto), MP_ROM_PTR(&mp_stream_readinto_obj) },
+    { MP_ROM_QSTR(MP_QSTR_readline), MP_ROM_PTR(&bufreader_readline_obj) },
+    { MP_ROM_QSTR(MP_QSTR_peek), MP_ROM_PTR(&bufreader_peek_obj) },
+    { MP_ROM_QSTR(MP_QSTR_seek), MP_ROM_PTR(&mp_stream_seek_obj) },
+    { MP_ROM_QSTR(MP_QSTR_close), MP_ROM_PTR(&mp_stream_close_obj) },
+    { MP_ROM_QSTR(MP_QSTR___enter__), MP_ROM_PTR(&mp_identity_obj) },
+    { MP_ROM_QSTR(MP_QSTR___exit__), MP_ROM_PTR(&buffered___exit___obj) },
+};
+STATIC MP_DEFINE_CONST_DICT(bufreader_locals_dict, bufreader_locals_dict_table);
+
+STATIC const mp_stream_p_t bufreader_stream_p = {
+    MP_PROTO_IMPLEMENT(MP_QSTR_protocol_stream)
+    .read = bufreader_read,
+    .ioctl = bufreader_ioctl,
+};
+
+STATIC const mp_obj_type_t bufreader_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_BufferedReader,
+    .make_new = bufreader_make_new,
+    .getiter = mp_identity_getiter,
+    .iternext = mp_stream_unbuffered_iter,
+    .protocol = &bufreader_stream_p,
+    .locals_dict = (mp_obj_dict_t*)&bufreader_locals_dict,
+};
+#endif // MICROPY_PY_IO_BUFFEREDREADER
+
 #if MICROPY_PY_IO_BUFFEREDWRITER
 typedef struct _mp_obj_bufwriter_t {
     mp_obj_base_t base;
@@ -115,8 +356,9 @@ typedef struct _mp_obj_bufwriter_t {
 } mp_obj_bufwriter_t;
 
 STATIC mp_obj_t bufwriter_make_new(const mp_obj_type_t *type, size_t n_args, const mp_obj_t *args, mp_map_t *kw_args) {
-    mp_arg_check_num(n_args, kw_args, 2, 2, false);
-    size_t alloc = mp_obj_get_int(args[1]);
+    mp_arg_check_num(n_args, kw_args, 1, 2, false);
+    mp_get_stream_raise(args[0], MP_STREAM_OP_WRITE);
+    size_t alloc = buffered_alloc_arg(n_args, args);
     mp_obj_bufwriter_t *o = m_new_obj_var(mp_obj_bufwriter_t, byte, alloc);
     o->base.type = type;
     o->stream = args[0];
@@ -125,6 +367,33 @@ STATIC mp_obj_t bufwriter_make_new(const mp_obj_type_t *type, size_t n_args, con
     return o;
 }
 
+// Write out the buffer.  If a non-blocking stream takes only part of it the
+// rest is moved to the front and kept for the next attempt.  Returns false
+// with *errcode set unless the buffer was emptied.
+STATIC bool bufwriter_flush_buf(mp_obj_bufwriter_t *self, int *errcode) {
+    const mp_stream_p_t *stream_p = mp_get_stream(self->stream);
+    size_t done = 0;
+    while (done < self->len) {
+        mp_uint_t out_sz = stream_p->write(self->stream, self->buf + done, self->len - done, errcode);
+        if (out_sz == MP_STREAM_ERROR) {
+            break;
+        }
+        if (out_sz == 0) {
+            // the stream stopped accepting data without saying why
+            *errcode = MP_EIO;
+            break;
+        }
+        done += out_sz;
+    }
+    if (done == self->len) {
+        self->len = 0;
+        return true;
+    }
+    memmove(self->buf, self->buf + done, self->len - done);
+    self->len -= done;
+    return false;
+}
+
 STATIC mp_uint_t bufwriter_write(mp_obj_t self_in, const void *buf, mp_uint_t size, int *errcode) {
     mp_obj_bufwriter_t *self = MP_OBJ_TO_PTR(self_in);
 
@@ -145,16 +414,25 @@ STATIC mp_uint_t bufwriter_write(mp_obj_t self_in, const void *buf, mp_uint_t si
         // is word-aligned, to guard against obscure cases when it matters, e.g.
         // https://github.com/micropython/micropython/issues/1863
         memcpy(self->buf + self->len, buf, rem);
+        self->len = self->alloc;
         buf = (byte*)buf + rem;
         size -= rem;
-        mp_uint_t out_sz = mp_stream_write_exactly(self->stream, self->buf, self->alloc, errcode);
-        if (*errcode != 0) {
+        if (!bufwriter_flush_buf(self, errcode)) {
+            if (mp_is_nonblocking_error(*errcode)) {
+                // What was copied in stays buffered, so it counts as written.
+                // EAGAIN is reported only if nothing was taken.
+                mp_uint_t done = org_size - size;
+                if (done != 0) {
+                    *errcode = 0;
+                    return done;
+                }
+                return MP_STREAM_ERROR;
+            }
+            // Any other error fails the write, so take back what it copied in
+            // and is still buffered rather than let a later flush send it.
+            self->len -= MIN(self->len, rem);
             return MP_STREAM_ERROR;
         }
-        // TODO: try to recover from a case of non-blocking stream, e.g. move
-        // remaining chunk to the beginning of buffer.
-        assert(out_sz == self->alloc);
-        self->len = 0;
     }
 
     return org_size;
@@ -163,31 +441,54 @@ STATIC mp_uint_t bufwriter_write(mp_obj_t self_in, const void *buf, mp_uint_t si
 STATIC mp_obj_t bufwriter_flush(mp_obj_t self_in) {
     mp_obj_bufwriter_t *self = MP_OBJ_TO_PTR(self_in);
 
-    if (self->len != 0) {
-        int err;
-        mp_uint_t out_sz = mp_stream_write_exactly(self->stream, self->buf, self->len, &err);
-        // TODO: try to recover from a case of non-blocking stream, e.g. move
-        // remaining chunk to the beginning of buffer.
-        assert(out_sz == self->len);
-        self->len = 0;
-        if (err != 0) {
-            mp_raise_OSError(err);
-        }
+    int err;
+    if (self->len != 0 && !bufwriter_flush_buf(self, &err)) {
+        mp_raise_OSError(err);
     }
 
     return mp_const_none;
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(bufwriter_flush_obj, bufwriter_flush);
 
+STATIC mp_uint_t bufwriter_ioctl(mp_obj_t self_in, mp_uint_t request, uintptr_t arg, int *errcode) {
+    mp_obj_bufwriter_t *self = MP_OBJ_TO_PTR(self_in);
+
+    if (request == MP_STREAM_POLL && (arg & MP_STREAM_POLL_WR) && self->len < self->alloc) {
+        // room in the buffer means a write won't block
+        mp_uint_t ret = MP_STREAM_POLL_WR;
+        arg &= ~MP_STREAM_POLL_WR;
+        if (arg != 0) {
+            mp_uint_t more = buffered_stream_ioctl(self->stream, request, arg, errcode);
+            if (more == MP_STREAM_ERROR) {
+                return more;
+            }
+            ret |= more;
+        }
+        return ret;
+    }
+
+    if (request == MP_STREAM_FLUSH || request == MP_STREAM_CLOSE || request == MP_STREAM_SEEK) {
+        if (self->len != 0 && !bufwriter_flush_buf(self, errcode)) {
+            return MP_STREAM_ERROR;
+        }
+    }
+
+    return buffered_stream_ioctl(self->stream, request, arg, errcode);
+}
+
 STATIC const mp_rom_map_elem_t bufwriter_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_write), MP_ROM_PTR(&mp_stream_write_obj) },
     { MP_ROM_QSTR(MP_QSTR_flush), MP_ROM_PTR(&bufwriter_flush_obj) },
+    { MP_ROM_QSTR(MP_QSTR_close), MP_ROM_PTR(&mp_stream_close_obj) },
+    { MP_ROM_QSTR(MP_QSTR___enter__), MP_ROM_PTR(&mp_identity_obj) },
+    { MP_ROM_QSTR(MP_QSTR___exit__), MP_ROM_PTR(&buffered___exit___obj) },
 };
 STATIC MP_DEFINE_CONST_DICT(bufwriter_locals_dict, bufwriter_locals_dict_table);
 
 STATIC const mp_stream_p_t bufwriter_stream_p = {
     MP_PROTO_IMPLEMENT(MP_QSTR_protocol_stream)
     .write = bufwriter_write,
+    .ioctl = bufwriter_ioctl,
 };
 
 STATIC const mp_obj_type_t bufwriter_type = {
@@ -271,6 +572,9 @@ STATIC const mp_rom_map_elem_t mp_module_io_globals_table[] = {
     #if MICROPY_PY_IO_BYTESIO
     { MP_ROM_QSTR(MP_QSTR_BytesIO), MP_ROM_PTR(&mp_type_bytesio) },
     #endif
+    #if MICROPY_PY_IO_BUFFEREDREADER
+    { MP_ROM_QSTR(MP_QSTR_BufferedReader), MP_ROM_PTR(&bufreader_type) },
+    #endif
     #if MICROPY_PY_IO_BUFFEREDWRITER
     { MP_ROM_QSTR(MP_QSTR_BufferedWriter), MP_ROM_PTR(&bufwriter_type) },
     #endif
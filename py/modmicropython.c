@@ -150,6 +150,37 @@ STATIC MP_DEFINE_CONST_FUN_OBJ_1(mp_micropython_kbd_intr_obj, mp_micropython_kbd
 #endif
 
 #if MICROPY_ENABLE_SCHEDULER
+#if MICROPY_SCHEDULER_PRIORITY
+STATIC mp_obj_t mp_micropython_schedule(size_t n_args, const mp_obj_t *args) {
+    // priority is clamped to 0-255; a negative or missing deadline means none
+    mp_int_t priority = n_args > 2 ? mp_obj_get_int(args[2]) : 0;
+    mp_int_t deadline_us = n_args > 3 && args[3] != mp_const_none ? mp_obj_get_int(args[3]) : -1;
+    priority = MIN(MAX(priority, 0), 255);
+    if (!mp_sched_schedule_priority(args[0], args[1], priority, deadline_us)) {
+        mp_raise_msg(&mp_type_RuntimeError, translate("schedule stack full"));
+    }
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_schedule_obj, 2, 4, mp_micropython_schedule);
+
+STATIC mp_obj_t mp_micropython_schedule_stats(size_t n_args, const mp_obj_t *args) {
+    mp_uint_t atomic_state = MICROPY_BEGIN_ATOMIC_SECTION();
+    mp_obj_t items[] = {
+        MP_OBJ_NEW_SMALL_INT(MP_STATE_VM(sched_sp)),
+        MP_OBJ_NEW_SMALL_INT(MP_STATE_VM(sched_max_sp)),
+        MP_OBJ_NEW_SMALL_INT(MP_STATE_VM(sched_dropped)),
+        mp_obj_new_int_from_uint(MP_STATE_VM(sched_max_latency_us)),
+    };
+    if (n_args > 0 && mp_obj_is_true(args[0])) {
+        MP_STATE_VM(sched_max_sp) = MP_STATE_VM(sched_sp);
+        MP_STATE_VM(sched_dropped) = 0;
+        MP_STATE_VM(sched_max_latency_us) = 0;
+    }
+    MICROPY_END_ATOMIC_SECTION(atomic_state);
+    return mp_obj_new_tuple(MP_ARRAY_SIZE(items), items);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_schedule_stats_obj, 0, 1, mp_micropython_schedule_stats);
+#else
 STATIC mp_obj_t mp_micropython_schedule(mp_obj_t function, mp_obj_t arg) {
     if (!mp_sched_schedule(function, arg)) {
         mp_raise_msg(&mp_type_RuntimeError, translate("schedule stack full"));
@@ -158,6 +189,7 @@ STATIC mp_obj_t mp_micropython_schedule(mp_obj_t function, mp_obj_t arg) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_2(mp_micropython_schedule_obj, mp_micropython_schedule);
 #endif
+#endif
 
 STATIC const mp_rom_map_elem_t mp_module_micropython_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_micropython) },
@@ -192,6 +224,9 @@ STATIC const mp_rom_map_elem_t mp_module_micropython_globals_table[] = {
     #endif
     #if MICROPY_ENABLE_SCHEDULER
     { MP_ROM_QSTR(MP_QSTR_schedule), MP_ROM_PTR(&mp_micropython_schedule_obj) },
+    #if MICROPY_SCHEDULER_PRIORITY
+    { MP_ROM_QSTR(MP_QSTR_schedule_stats), MP_ROM_PTR(&mp_micropython_schedule_stats_obj) },
+    #endif
     #endif
 };
 
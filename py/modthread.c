@@ -162,6 +162,9 @@ STATIC void *thread_entry(void *args_in) {
     thread_entry_args_t *args = (thread_entry_args_t*)args_in;
 
     mp_state_thread_t ts;
+    #if MICROPY_TRACK_CODE_STATE
+    ts.current_code_state = NULL;
+    #endif
     mp_thread_set_state(&ts);
 
     mp_stack_set_top(&ts + 1); // need to include ts in root-pointer scan
@@ -252,11 +252,30 @@
 #define MICROPY_PERSISTENT_CODE_LOAD (0)
 #endif
 
+// Whether .mpy files that are in memory are executed in place. Their bytecode
+// then stays where it is instead of being copied to the heap; constants are
+// still allocated. Files are read into a private image outside the heap,
+// which needs MICROPY_ENABLE_FINALISER to be freed once no code uses it.
+// Read-only files stored contiguously on a FAT filesystem are used in place
+// if the block device returns a buffer for BP_IOCTL_BUFFER.
+#ifndef MICROPY_PERSISTENT_CODE_LOAD_XIP
+#define MICROPY_PERSISTENT_CODE_LOAD_XIP (0)
+#endif
+
 // Whether to support saving of persistent code
 #ifndef MICROPY_PERSISTENT_CODE_SAVE
 #define MICROPY_PERSISTENT_CODE_SAVE (0)
 #endif
 
+// Whether imported .py files have their bytecode cached in .mpy files, which
+// are loaded instead of compiling the source again while its size, mtime and
+// contents are unchanged. Only directories with a .mpycache subdirectory are
+// cached.
+// Needs MICROPY_VFS and persistent code loading and saving.
+#ifndef MICROPY_PERSISTENT_CODE_CACHE
+#define MICROPY_PERSISTENT_CODE_CACHE (0)
+#endif
+
 // Whether generated code can persist independently of the VM/runtime instance
 // This is enabled automatically when needed by other features
 #ifndef MICROPY_PERSISTENT_CODE
@@ -330,9 +349,11 @@
 // Configure dynamic compiler macros
 #if MICROPY_DYNAMIC_COMPILER
 #define MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE_DYNAMIC (mp_dynamic_compiler.opt_cache_map_lookup_in_bytecode)
+#define MICROPY_OPT_SUPERINSTRUCTIONS_DYNAMIC (mp_dynamic_compiler.opt_superinstructions)
 #define MICROPY_PY_BUILTINS_STR_UNICODE_DYNAMIC (mp_dynamic_compiler.py_builtins_str_unicode)
 #else
 #define MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE_DYNAMIC MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE
+#define MICROPY_OPT_SUPERINSTRUCTIONS_DYNAMIC MICROPY_OPT_SUPERINSTRUCTIONS
 #define MICROPY_PY_BUILTINS_STR_UNICODE_DYNAMIC MICROPY_PY_BUILTINS_STR_UNICODE
 #endif
 
@@ -407,6 +428,22 @@
 #define MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE (0)
 #endif
 
+// Whether the bytecode compiler fuses common opcode sequences, such as
+// loading a local and adding a small int to it, or a comparison followed by
+// a conditional jump, into single superinstructions that the VM dispatches
+// once.  Speeds up tight loops at the cost of a bit of VM code ROM.  .mpy
+// files with superinstructions can only be loaded when this is enabled.
+#ifndef MICROPY_OPT_SUPERINSTRUCTIONS
+#define MICROPY_OPT_SUPERINSTRUCTIONS (0)
+#endif
+
+// Whether the VM does binary operations on small ints and floats inline,
+// before falling back to mp_binary_op for all other types.  Speeds up
+// arithmetic and comparisons in loops for about 500 bytes of code ROM.
+#ifndef MICROPY_OPT_VM_FAST_BINARY_OP
+#define MICROPY_OPT_VM_FAST_BINARY_OP (0)
+#endif
+
 // Whether to use fast versions of bitwise operations (and, or, xor) when the
 // arguments are both positive.  Increases Thumb2 code size by about 250 bytes.
 #ifndef MICROPY_OPT_MPZ_BITWISE
@@ -433,6 +470,12 @@
 #define MICROPY_READER_VFS (0)
 #endif
 
+// Size of the buffer the POSIX and VFS readers read source files into. The
+// default is one filesystem block so each refill is a single block read.
+#ifndef MICROPY_READER_BUF_SIZE
+#define MICROPY_READER_BUF_SIZE (512)
+#endif
+
 // Number of VFS mounts to persist across soft-reset.
 #ifndef MICROPY_FATFS_NUM_PERSISTENT
 #define MICROPY_FATFS_NUM_PERSISTENT (0)
@@ -697,6 +740,13 @@ typedef double mp_float_t;
 #define MICROPY_SCHEDULER_DEPTH (4)
 #endif
 
+// Whether scheduled callbacks carry a priority and an optional deadline, and
+// the scheduler keeps queue depth, drop and latency statistics.
+// Requires mp_hal_ticks_us().
+#ifndef MICROPY_SCHEDULER_PRIORITY
+#define MICROPY_SCHEDULER_PRIORITY (0)
+#endif
+
 // Support for generic VFS sub-system
 #ifndef MICROPY_VFS
 #define MICROPY_VFS (0)
@@ -1056,6 +1106,11 @@ typedef double mp_float_t;
 #define MICROPY_PY_IO_BUFFEREDWRITER (0)
 #endif
 
+// Whether to provide "io.BufferedReader" class
+#ifndef MICROPY_PY_IO_BUFFEREDREADER
+#define MICROPY_PY_IO_BUFFEREDREADER (0)
+#endif
+
 // Whether to provide "struct" module
 #ifndef MICROPY_PY_STRUCT
 #define MICROPY_PY_STRUCT (1)
@@ -1190,6 +1245,23 @@ typedef double mp_float_t;
 #define MICROPY_PY_UTIMEQ (0)
 #endif
 
+// Native event loop for generator based coroutines (requires utimeq, and
+// uselect for waiting on streams)
+#ifndef MICROPY_PY_UASYNCIO
+#define MICROPY_PY_UASYNCIO (0)
+#endif
+
+// Sampling profiler that records which bytecode is running each time the port
+// calls uprofile_tick() (requires MICROPY_TRACK_CODE_STATE)
+#ifndef MICROPY_PY_UPROFILE
+#define MICROPY_PY_UPROFILE (0)
+#endif
+
+// Allocation tracing and heap histograms (requires MICROPY_TRACK_CODE_STATE)
+#ifndef MICROPY_PY_UHEAP
+#define MICROPY_PY_UHEAP (0)
+#endif
+
 #ifndef MICROPY_PY_UHASHLIB
 #define MICROPY_PY_UHASHLIB (0)
 #endif
@@ -1275,6 +1347,12 @@ typedef double mp_float_t;
 #define MICROPY_PY_WEBREPL (0)
 #endif
 
+// Whether MP_STATE_THREAD(current_code_state) follows the innermost running
+// bytecode function, so that it can be found from outside the VM
+#ifndef MICROPY_TRACK_CODE_STATE
+#define MICROPY_TRACK_CODE_STATE (MICROPY_PY_UPROFILE || MICROPY_PY_UHEAP)
+#endif
+
 /*****************************************************************************/
 /* Hooks for a port to add builtins                                          */
 
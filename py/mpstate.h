@@ -45,6 +45,7 @@
 typedef struct mp_dynamic_compiler_t {
     uint8_t small_int_bits; // must be <= host small_int_bits
     bool opt_cache_map_lookup_in_bytecode;
+    bool opt_superinstructions;
     bool py_builtins_str_unicode;
 } mp_dynamic_compiler_t;
 extern mp_dynamic_compiler_t mp_dynamic_compiler;
@@ -58,6 +59,12 @@ extern mp_dynamic_compiler_t mp_dynamic_compiler;
 typedef struct _mp_sched_item_t {
     mp_obj_t func;
     mp_obj_t arg;
+    #if MICROPY_SCHEDULER_PRIORITY
+    mp_uint_t enqueued_us;
+    mp_uint_t deadline_us;
+    uint8_t priority;
+    bool has_deadline;
+    #endif
 } mp_sched_item_t;
 
 // This structure hold information about the memory allocation system.
@@ -186,6 +193,18 @@ typedef struct _mp_state_vm_t {
     mp_obj_t lwip_slip_stream;
     #endif
 
+    #if MICROPY_PY_UASYNCIO
+    mp_obj_t uasyncio_loop;
+    #endif
+
+    #if MICROPY_PY_UPROFILE
+    struct _uprofile_t *uprofile;
+    #endif
+
+    #if MICROPY_PY_UHEAP
+    struct _uheap_t *uheap;
+    #endif
+
     #if MICROPY_VFS
     struct _mp_vfs_mount_t *vfs_cur;
     struct _mp_vfs_mount_t *vfs_mount_table;
@@ -218,6 +237,11 @@ typedef struct _mp_state_vm_t {
     #if MICROPY_ENABLE_SCHEDULER
     volatile int16_t sched_state;
     uint16_t sched_sp;
+    #if MICROPY_SCHEDULER_PRIORITY
+    uint16_t sched_max_sp;
+    uint16_t sched_dropped;
+    mp_uint_t sched_max_latency_us;
+    #endif
     #endif
 
     #if MICROPY_PY_THREAD_GIL
@@ -246,6 +270,12 @@ typedef struct _mp_state_thread_t {
     uint8_t *pystack_cur;
     #endif
 
+    #if MICROPY_TRACK_CODE_STATE
+    // The innermost bytecode function running on this thread, or NULL. It may
+    // be read from an interrupt.
+    struct _mp_code_state_t *volatile current_code_state;
+    #endif
+
     ////////////////////////////////////////////////////////////
     // START ROOT POINTER SECTION
     // Everything that needs GC scanning must start here, and
@@ -281,7 +281,13 @@ STATIC mp_obj_t fun_bc_call(mp_obj_t self_in, size_t n_args, size_t n_kw, const
 
     // execute the byte code with the correct globals context
     mp_globals_set(self->globals);
+    #if MICROPY_TRACK_CODE_STATE
+    mp_code_state_t *prev_code_state = MP_STATE_THREAD(current_code_state);
+    #endif
     mp_vm_return_kind_t vm_return_kind = mp_execute_bytecode(code_state, MP_OBJ_NULL);
+    #if MICROPY_TRACK_CODE_STATE
+    MP_STATE_THREAD(current_code_state) = prev_code_state;
+    #endif
     mp_globals_set(code_state->old_globals);
 
 #if VM_DETECT_STACK_OVERFLOW
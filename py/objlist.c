@@ -289,35 +289,337 @@ STATIC mp_obj_t list_pop(size_t n_args, const mp_obj_t *args) {
     return ret;
 }
 
-STATIC void mp_quicksort(mp_obj_t *head, mp_obj_t *tail, mp_obj_t key_fn, mp_obj_t binop_less_result) {
+// Sorting is a stable natural merge sort in the style of Timsort.  Runs of
+// items that are already in order are found and merged pairwise, so sorted
+// and nearly sorted lists take close to linear time, and short runs are first
+// extended with a binary insertion sort.  If there is a key function it is
+// called once per item and the keys are moved around together with the items.
+// Merges use a temporary buffer of at most half the list, falling back to a
+// slower in-place merge if that can't be allocated.
+
+// Maximum number of runs waiting to be merged; the merge rules keep this
+// logarithmic in the list length, and if it fills up all runs get merged.
+#define SORT_MAX_RUNS (40)
+
+typedef struct _sort_state_t {
+    mp_obj_t *keys;     // what is compared; the items themselves if there's no key function
+    mp_obj_t *items;    // the items, moved along with the keys, or NULL if they are the keys
+    mp_obj_t *tmp;      // merge buffer: tmp_alloc keys, followed by tmp_alloc items if needed
+    size_t tmp_alloc;
+    // while merging, tmp[tmp_lo:tmp_hi] holds the entries that belong at
+    // keys[dest:], so that they can be put back if a comparison raises
+    size_t tmp_lo;
+    size_t tmp_hi;
+    size_t dest;
+    bool reverse;
+    size_t n_runs;
+    size_t run[SORT_MAX_RUNS + 1]; // start of each run, then the end of the last one
+} sort_state_t;
+
+STATIC bool sort_lt(sort_state_t *s, mp_obj_t a, mp_obj_t b) {
+    if (s->reverse) {
+        mp_obj_t t = a;
+        a = b;
+        b = t;
+    }
+    if (MP_OBJ_IS_SMALL_INT(a) && MP_OBJ_IS_SMALL_INT(b)) {
+        return MP_OBJ_SMALL_INT_VALUE(a) < MP_OBJ_SMALL_INT_VALUE(b);
+    }
+    return mp_obj_is_true(mp_binary_op(MP_BINARY_OP_LESS, a, b));
+}
+
+STATIC void sort_move(sort_state_t *s, size_t dest, size_t src, size_t n) {
+    memmove(&s->keys[dest], &s->keys[src], n * sizeof(mp_obj_t));
+    if (s->items != NULL) {
+        memmove(&s->items[dest], &s->items[src], n * sizeof(mp_obj_t));
+    }
+}
+
+// Reverse the entries in [lo, hi).
+STATIC void sort_reverse(sort_state_t *s, size_t lo, size_t hi) {
+    while (lo + 1 < hi) {
+        --hi;
+        mp_obj_t t = s->keys[lo];
+        s->keys[lo] = s->keys[hi];
+        s->keys[hi] = t;
+        if (s->items != NULL) {
+            t = s->items[lo];
+            s->items[lo] = s->items[hi];
+            s->items[hi] = t;
+        }
+        ++lo;
+    }
+}
+
+// Index of the first entry in [lo, hi) that is greater than key.
+STATIC size_t sort_upper_bound(sort_state_t *s, size_t lo, size_t hi, mp_obj_t key) {
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (sort_lt(s, key, s->keys[mid])) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+// Index of the first entry in [lo, hi) that is not less than key.
+STATIC size_t sort_lower_bound(sort_state_t *s, size_t lo, size_t hi, mp_obj_t key) {
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (sort_lt(s, s->keys[mid], key)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Sort [lo, hi) given that [lo, start) is already sorted.
+STATIC void sort_binary_insertion(sort_state_t *s, size_t lo, size_t start, size_t hi) {
+    for (; start < hi; ++start) {
+        mp_obj_t key = s->keys[start];
+        size_t pos = sort_upper_bound(s, lo, start, key);
+        if (pos == start) {
+            continue;
+        }
+        mp_obj_t item = s->items != NULL ? s->items[start] : MP_OBJ_NULL;
+        sort_move(s, pos + 1, pos, start - pos);
+        s->keys[pos] = key;
+        if (s->items != NULL) {
+            s->items[pos] = item;
+        }
+    }
+}
+
+// Length of the run starting at lo, which is made ascending if it's descending.
+// Only strictly descending runs are reversed, to keep the sort stable.
+STATIC size_t sort_count_run(sort_state_t *s, size_t lo, size_t hi) {
+    size_t n = lo + 1;
+    if (n == hi) {
+        return 1;
+    }
+    if (sort_lt(s, s->keys[n], s->keys[lo])) {
+        for (++n; n < hi && sort_lt(s, s->keys[n], s->keys[n - 1]); ++n) {
+        }
+        sort_reverse(s, lo, n);
+    } else {
+        for (++n; n < hi && !sort_lt(s, s->keys[n], s->keys[n - 1]); ++n) {
+        }
+    }
+    return n - lo;
+}
+
+// Make room for n entries in the merge buffer, returning false if there's no memory.
+STATIC bool sort_ensure_tmp(sort_state_t *s, size_t n) {
+    if (n <= s->tmp_alloc) {
+        return true;
+    }
+    size_t per_entry = s->items != NULL ? 2 : 1;
+    if (s->tmp != NULL) {
+        m_del(mp_obj_t, s->tmp, s->tmp_alloc * per_entry);
+    }
+    s->tmp = m_new_maybe(mp_obj_t, n * per_entry);
+    s->tmp_alloc = s->tmp != NULL ? n : 0;
+    return s->tmp != NULL;
+}
+
+STATIC void sort_to_tmp(sort_state_t *s, size_t src, size_t n) {
+    memcpy(s->tmp, &s->keys[src], n * sizeof(mp_obj_t));
+    if (s->items != NULL) {
+        memcpy(s->tmp + s->tmp_alloc, &s->items[src], n * sizeof(mp_obj_t));
+    }
+}
+
+// Copy the entries still in the merge buffer back to where they belong.
+STATIC void sort_from_tmp(sort_state_t *s) {
+    size_t n = s->tmp_hi - s->tmp_lo;
+    memcpy(&s->keys[s->dest], s->tmp + s->tmp_lo, n * sizeof(mp_obj_t));
+    if (s->items != NULL) {
+        memcpy(&s->items[s->dest], s->tmp + s->tmp_alloc + s->tmp_lo, n * sizeof(mp_obj_t));
+    }
+    s->tmp_lo = s->tmp_hi = 0;
+}
+
+// Merge [lo, mid) and [mid, hi) going forwards, with the first run in the buffer.
+STATIC void sort_merge_lo(sort_state_t *s, size_t lo, size_t mid, size_t hi) {
+    mp_obj_t *tmp_keys = s->tmp;
+    mp_obj_t *tmp_items = s->tmp + s->tmp_alloc;
+    sort_to_tmp(s, lo, mid - lo);
+    s->tmp_lo = 0;
+    s->tmp_hi = mid - lo;
+    s->dest = lo;
+    size_t b = mid;
+    while (s->tmp_lo < s->tmp_hi && b < hi) {
+        bool take_b = sort_lt(s, s->keys[b], tmp_keys[s->tmp_lo]);
+        size_t d = s->dest++;
+        if (take_b) {
+            s->keys[d] = s->keys[b];
+            if (s->items != NULL) {
+                s->items[d] = s->items[b];
+            }
+            ++b;
+        } else {
+            s->keys[d] = tmp_keys[s->tmp_lo];
+            if (s->items != NULL) {
+                s->items[d] = tmp_items[s->tmp_lo];
+            }
+            ++s->tmp_lo;
+        }
+    }
+    sort_from_tmp(s);
+}
+
+// Merge [lo, mid) and [mid, hi) going backwards, with the second run in the buffer.
+STATIC void sort_merge_hi(sort_state_t *s, size_t lo, size_t mid, size_t hi) {
+    mp_obj_t *tmp_keys = s->tmp;
+    mp_obj_t *tmp_items = s->tmp + s->tmp_alloc;
+    sort_to_tmp(s, mid, hi - mid);
+    s->tmp_lo = 0;
+    s->tmp_hi = hi - mid;
+    s->dest = mid;
+    size_t d = hi;
+    while (s->tmp_hi > 0 && s->dest > lo) {
+        --d;
+        if (sort_lt(s, tmp_keys[s->tmp_hi - 1], s->keys[s->dest - 1])) {
+            --s->dest;
+            s->keys[d] = s->keys[s->dest];
+            if (s->items != NULL) {
+                s->items[d] = s->items[s->dest];
+            }
+        } else {
+            --s->tmp_hi;
+            s->keys[d] = tmp_keys[s->tmp_hi];
+            if (s->items != NULL) {
+                s->items[d] = tmp_items[s->tmp_hi];
+            }
+        }
+    }
+    sort_from_tmp(s);
+}
+
+// Merge [lo, mid) and [mid, hi) without a buffer, by rotating one half of a
+// run past part of the other and recursing on the two pieces.
+STATIC void sort_merge_inplace(sort_state_t *s, size_t lo, size_t mid, size_t hi) {
     MP_STACK_CHECK();
-    while (head < tail) {
-        mp_obj_t *h = head - 1;
-        mp_obj_t *t = tail;
-        mp_obj_t v = key_fn == MP_OBJ_NULL ? tail[0] : mp_call_function_1(key_fn, tail[0]); // get pivot using key_fn
-        for (;;) {
-            do ++h; while (h < t && mp_binary_op(MP_BINARY_OP_LESS, key_fn == MP_OBJ_NULL ? h[0] : mp_call_function_1(key_fn, h[0]), v) == binop_less_result);
-            do --t; while (h < t && mp_binary_op(MP_BINARY_OP_LESS, v, key_fn == MP_OBJ_NULL ? t[0] : mp_call_function_1(key_fn, t[0])) == binop_less_result);
-            if (h >= t) break;
-            mp_obj_t x = h[0];
-            h[0] = t[0];
-            t[0] = x;
+    while (lo < mid && mid < hi) {
+        if (hi - lo == 2) {
+            if (sort_lt(s, s->keys[mid], s->keys[lo])) {
+                sort_reverse(s, lo, hi);
+            }
+            return;
+        }
+        size_t cut_a, cut_b;
+        if (mid - lo >= hi - mid) {
+            cut_a = lo + (mid - lo) / 2;
+            cut_b = sort_lower_bound(s, mid, hi, s->keys[cut_a]);
+        } else {
+            cut_b = mid + (hi - mid) / 2;
+            cut_a = sort_upper_bound(s, lo, mid, s->keys[cut_b]);
         }
-        mp_obj_t x = h[0];
-        h[0] = tail[0];
-        tail[0] = x;
-        // do the smaller recursive call first, to keep stack within O(log(N))
-        if (t - head < tail - h - 1) {
-            mp_quicksort(head, t, key_fn, binop_less_result);
-            head = h + 1;
+        // rotate [cut_a, mid) past [mid, cut_b)
+        sort_reverse(s, cut_a, mid);
+        sort_reverse(s, mid, cut_b);
+        sort_reverse(s, cut_a, cut_b);
+        size_t new_mid = cut_a + (cut_b - mid);
+        // recurse on the smaller piece, to keep stack within O(log(N))
+        if (new_mid - lo < hi - new_mid) {
+            sort_merge_inplace(s, lo, cut_a, new_mid);
+            lo = new_mid;
+            mid = cut_b;
         } else {
-            mp_quicksort(h + 1, tail, key_fn, binop_less_result);
-            tail = t;
+            sort_merge_inplace(s, new_mid, cut_b, hi);
+            hi = new_mid;
+            mid = cut_a;
+        }
+    }
+}
+
+// Merge pending runs i and i + 1.
+STATIC void sort_merge_at(sort_state_t *s, size_t i) {
+    size_t lo = s->run[i];
+    size_t mid = s->run[i + 1];
+    size_t hi = s->run[i + 2];
+    memmove(&s->run[i + 1], &s->run[i + 2], (s->n_runs - i - 1) * sizeof(size_t));
+    --s->n_runs;
+
+    // Entries at the start of the first run that are not greater than the
+    // start of the second, and entries at the end of the second run that are
+    // not less than the end of the first, are already where they belong.
+    lo = sort_upper_bound(s, lo, mid, s->keys[mid]);
+    if (lo == mid) {
+        return;
+    }
+    hi = sort_lower_bound(s, mid, hi, s->keys[mid - 1]);
+
+    if (!sort_ensure_tmp(s, MIN(mid - lo, hi - mid))) {
+        sort_merge_inplace(s, lo, mid, hi);
+    } else if (mid - lo <= hi - mid) {
+        sort_merge_lo(s, lo, mid, hi);
+    } else {
+        sort_merge_hi(s, lo, mid, hi);
+    }
+}
+
+// Merge pending runs until their lengths shrink faster than the Fibonacci
+// numbers from the bottom of the stack to the top.
+STATIC void sort_merge_collapse(sort_state_t *s) {
+    #define RUN_LEN(i) (s->run[(i) + 1] - s->run[i])
+    while (s->n_runs > 1) {
+        size_t i = s->n_runs - 2;
+        if ((i > 0 && RUN_LEN(i - 1) <= RUN_LEN(i) + RUN_LEN(i + 1))
+            || (i > 1 && RUN_LEN(i - 2) <= RUN_LEN(i - 1) + RUN_LEN(i))) {
+            if (RUN_LEN(i - 1) < RUN_LEN(i + 1)) {
+                --i;
+            }
+        } else if (RUN_LEN(i) > RUN_LEN(i + 1)) {
+            break;
+        }
+        sort_merge_at(s, i);
+    }
+    #undef RUN_LEN
+}
+
+STATIC void sort_merge_all(sort_state_t *s) {
+    while (s->n_runs > 1) {
+        sort_merge_at(s, s->n_runs - 2);
+    }
+}
+
+// Minimum run length, between 32 and 64, chosen so that n / min_run is equal
+// to or a little less than a power of 2 so the final merges are balanced.
+STATIC size_t sort_min_run(size_t n) {
+    size_t r = 0;
+    while (n >= 64) {
+        r |= n & 1;
+        n >>= 1;
+    }
+    return n + r;
+}
+
+STATIC void sort_runs(sort_state_t *s, size_t n) {
+    size_t min_run = sort_min_run(n);
+    s->n_runs = 0;
+    s->run[0] = 0;
+    for (size_t lo = 0; lo < n;) {
+        size_t len = sort_count_run(s, lo, n);
+        if (len < min_run) {
+            size_t forced = MIN(min_run, n - lo);
+            sort_binary_insertion(s, lo, lo + len, lo + forced);
+            len = forced;
         }
+        if (s->n_runs == SORT_MAX_RUNS) {
+            sort_merge_all(s);
+        }
+        lo += len;
+        s->run[++s->n_runs] = lo;
+        sort_merge_collapse(s);
     }
+    sort_merge_all(s);
 }
 
-// TODO Python defines sort to be stable but ours is not
 mp_obj_t mp_obj_list_sort(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_key, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_rom_obj = MP_ROM_PTR(&mp_const_none_obj)} },
@@ -335,9 +637,39 @@ mp_obj_t mp_obj_list_sort(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_
     mp_obj_list_t *self = MP_OBJ_TO_PTR(pos_args[0]);
 
     if (self->len > 1) {
-        mp_quicksort(self->items, self->items + self->len - 1,
-                     args.key.u_obj == mp_const_none ? MP_OBJ_NULL : args.key.u_obj,
-                     args.reverse.u_bool ? mp_const_false : mp_const_true);
+        size_t n = self->len;
+        sort_state_t s;
+        s.keys = self->items;
+        s.items = NULL;
+        if (args.key.u_obj != mp_const_none) {
+            s.keys = m_new(mp_obj_t, n);
+            for (size_t i = 0; i < n; i++) {
+                s.keys[i] = mp_call_function_1(args.key.u_obj, self->items[i]);
+            }
+            s.items = self->items;
+        }
+        s.tmp = NULL;
+        s.tmp_alloc = 0;
+        s.tmp_lo = s.tmp_hi = s.dest = 0;
+        s.reverse = args.reverse.u_bool;
+
+        nlr_buf_t nlr;
+        if (nlr_push(&nlr) == 0) {
+            sort_runs(&s, n);
+            nlr_pop();
+        } else {
+            // a comparison raised: put back anything that was taken out for
+            // a merge so the list still holds all of its items
+            sort_from_tmp(&s);
+            nlr_jump(nlr.ret_val);
+        }
+
+        if (s.tmp != NULL) {
+            m_del(mp_obj_t, s.tmp, s.tmp_alloc * (s.items != NULL ? 2 : 1));
+        }
+        if (s.items != NULL) {
+            m_del(mp_obj_t, s.keys, n);
+        }
     }
 
     return mp_const_none;
@@ -220,6 +220,15 @@ STATIC const mp_rom_map_elem_t mp_builtin_module_table[] = {
 #if MICROPY_PY_UTIMEQ
     { MP_ROM_QSTR(MP_QSTR_utimeq), MP_ROM_PTR(&mp_module_utimeq) },
 #endif
+#if MICROPY_PY_UASYNCIO
+    { MP_ROM_QSTR(MP_QSTR_uasyncio), MP_ROM_PTR(&mp_module_uasyncio) },
+#endif
+#if MICROPY_PY_UPROFILE
+    { MP_ROM_QSTR(MP_QSTR_uprofile), MP_ROM_PTR(&mp_module_uprofile) },
+#endif
+#if MICROPY_PY_UHEAP
+    { MP_ROM_QSTR(MP_QSTR_uheap), MP_ROM_PTR(&mp_module_uheap) },
+#endif
 #if MICROPY_PY_UHASHLIB
     { MP_ROM_QSTR(MP_QSTR_hashlib), MP_ROM_PTR(&mp_module_uhashlib) },
 #endif
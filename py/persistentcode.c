@@ -48,12 +48,17 @@
 #define MPY_FEATURE_FLAGS ( \
     ((MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE) << 0) \
     | ((MICROPY_PY_BUILTINS_STR_UNICODE) << 1) \
+    | ((MICROPY_OPT_SUPERINSTRUCTIONS) << 2) \
     )
 // This is a version of the flags that can be configured at runtime.
 #define MPY_FEATURE_FLAGS_DYNAMIC ( \
     ((MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE_DYNAMIC) << 0) \
     | ((MICROPY_PY_BUILTINS_STR_UNICODE_DYNAMIC) << 1) \
+    | ((MICROPY_OPT_SUPERINSTRUCTIONS_DYNAMIC) << 2) \
     )
+// Features that a loaded file may go without even if they are enabled here:
+// a VM that runs superinstructions also runs bytecode that has none.
+#define MPY_FEATURE_FLAGS_OPTIONAL ((MICROPY_OPT_SUPERINSTRUCTIONS) << 2)
 
 #if MICROPY_PERSISTENT_CODE_LOAD || (MICROPY_PERSISTENT_CODE_SAVE && !MICROPY_DYNAMIC_COMPILER)
 // The bytecode will depend on the number of bits in a small-int, and
@@ -168,42 +173,95 @@ STATIC mp_obj_t load_obj(mp_reader_t *reader) {
     return MP_OBJ_FROM_PTR(&mp_const_none_obj);
 }
 
-STATIC void load_bytecode_qstrs(mp_reader_t *reader, byte *ip, byte *ip_top) {
-    while (ip < ip_top) {
+// Bytecode being linked, which may still be in place in the buffer it was
+// loaded from.
+typedef struct _bytecode_link_t {
+    byte *bytecode;
+    size_t bc_len;
+    bool read_only;
+} bytecode_link_t;
+
+// Stores qst at offset in the bytecode. Bytecode in a read-only buffer is moved
+// to the heap the first time a qstr differs from the one already there.
+STATIC void link_qstr(bytecode_link_t *link, size_t offset, qstr qst) {
+    byte *p = link->bytecode + offset;
+    if (link->read_only) {
+        if (p[0] == (byte)qst && p[1] == (byte)(qst >> 8)) {
+            return;
+        }
+        byte *copy = m_new(byte, link->bc_len);
+        memcpy(copy, link->bytecode, link->bc_len);
+        link->bytecode = copy;
+        link->read_only = false;
+        p = copy + offset;
+    }
+    p[0] = qst;
+    p[1] = qst >> 8;
+}
+
+STATIC void load_bytecode_qstrs(mp_reader_t *reader, bytecode_link_t *link, size_t offset) {
+    while (offset < link->bc_len) {
         size_t sz;
-        uint f = mp_opcode_format(ip, &sz);
+        uint f = mp_opcode_format(link->bytecode + offset, &sz);
         if (f == MP_OPCODE_QSTR) {
-            qstr qst = load_qstr(reader);
-            ip[1] = qst;
-            ip[2] = qst >> 8;
+            link_qstr(link, offset + 1, load_qstr(reader));
         }
-        ip += sz;
+        offset += sz;
     }
 }
 
 STATIC mp_raw_code_t *load_raw_code(mp_reader_t *reader) {
     // load bytecode
-    size_t bc_len = read_uint(reader);
-    byte *bytecode = m_new(byte, bc_len);
-    read_bytes(reader, bytecode, bc_len);
+    bytecode_link_t link;
+    link.bc_len = read_uint(reader);
+    link.bytecode = NULL;
+    link.read_only = false;
+    #if MICROPY_PERSISTENT_CODE_LOAD_XIP
+    // Execute the bytecode where it is if the reader allows it. The VM caches
+    // map lookups in the bytecode so with that enabled it must be writable.
+    bool writable;
+    mp_obj_t image;
+    byte *xip_bytecode = mp_reader_xip_data(reader, link.bc_len, &writable, &image);
+    link.bytecode = xip_bytecode;
+    if (link.bytecode != NULL && !writable && MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE) {
+        byte *copy = m_new(byte, link.bc_len);
+        memcpy(copy, link.bytecode, link.bc_len);
+        link.bytecode = copy;
+        writable = true;
+    }
+    link.read_only = !writable;
+    #endif
+    if (link.bytecode == NULL) {
+        link.bytecode = m_new(byte, link.bc_len);
+        read_bytes(reader, link.bytecode, link.bc_len);
+    }
 
     // extract prelude
-    const byte *ip = bytecode;
+    const byte *ip = link.bytecode;
     const byte *ip2;
     bytecode_prelude_t prelude;
     extract_prelude(&ip, &ip2, &prelude);
 
     // load qstrs and link global qstr ids into bytecode
-    qstr simple_name = load_qstr(reader);
-    qstr source_file = load_qstr(reader);
-    ((byte*)ip2)[0] = simple_name; ((byte*)ip2)[1] = simple_name >> 8;
-    ((byte*)ip2)[2] = source_file; ((byte*)ip2)[3] = source_file >> 8;
-    load_bytecode_qstrs(reader, (byte*)ip, bytecode + bc_len);
+    size_t ip_offset = ip - link.bytecode;
+    size_t ip2_offset = ip2 - link.bytecode;
+    link_qstr(&link, ip2_offset, load_qstr(reader)); // simple_name
+    link_qstr(&link, ip2_offset + 2, load_qstr(reader)); // source_file
+    load_bytecode_qstrs(reader, &link, ip_offset);
 
     // load constant table
     size_t n_obj = read_uint(reader);
     size_t n_raw_code = read_uint(reader);
-    mp_uint_t *const_table = m_new(mp_uint_t, prelude.n_pos_args + prelude.n_kwonly_args + n_obj + n_raw_code);
+    size_t n_keep = 0;
+    #if MICROPY_PERSISTENT_CODE_LOAD_XIP
+    // Bytecode still in an image keeps it alive through an extra slot at the
+    // end of the constant table, which the VM never reads. Functions made
+    // from this raw code refer to the same table.
+    if (image != MP_OBJ_NULL && link.bytecode == xip_bytecode) {
+        n_keep = 1;
+    }
+    #endif
+    mp_uint_t *const_table = m_new(mp_uint_t, prelude.n_pos_args + prelude.n_kwonly_args + n_obj + n_raw_code + n_keep);
     mp_uint_t *ct = const_table;
     for (size_t i = 0; i < prelude.n_pos_args + prelude.n_kwonly_args; ++i) {
         *ct++ = (mp_uint_t)MP_OBJ_NEW_QSTR(load_qstr(reader));
@@ -214,12 +272,17 @@ STATIC mp_raw_code_t *load_raw_code(mp_reader_t *reader) {
     for (size_t i = 0; i < n_raw_code; ++i) {
         *ct++ = (mp_uint_t)(uintptr_t)load_raw_code(reader);
     }
+    #if MICROPY_PERSISTENT_CODE_LOAD_XIP
+    if (n_keep) {
+        *ct++ = (mp_uint_t)image;
+    }
+    #endif
 
     // create raw_code and return it
     mp_raw_code_t *rc = mp_emit_glue_new_raw_code();
-    mp_emit_glue_assign_bytecode(rc, bytecode,
+    mp_emit_glue_assign_bytecode(rc, link.bytecode,
         #if MICROPY_PERSISTENT_CODE_SAVE || MICROPY_DEBUG_PRINTERS
-        bc_len,
+        link.bc_len,
         #endif
         const_table,
         #if MICROPY_PERSISTENT_CODE_SAVE
@@ -230,15 +293,26 @@ STATIC mp_raw_code_t *load_raw_code(mp_reader_t *reader) {
 }
 
 mp_raw_code_t *mp_raw_code_load(mp_reader_t *reader) {
+    // Close the reader on failure too, so that a file or XIP image it has is
+    // released now rather than never or when the garbage collector finds it.
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) != 0) {
+        reader->close(reader->data);
+        nlr_jump(nlr.ret_val);
+    }
     byte header[4];
     read_bytes(reader, header, sizeof(header));
     if (header[0] != 'M'
         || header[1] != MPY_VERSION
-        || header[2] != MPY_FEATURE_FLAGS
+        || (header[2] & ~MPY_FEATURE_FLAGS_OPTIONAL) != (MPY_FEATURE_FLAGS & ~MPY_FEATURE_FLAGS_OPTIONAL)
         || header[3] > mp_small_int_bits()) {
         mp_raise_MpyError(translate("Incompatible .mpy file. Please update all .mpy files. See http://adafru.it/mpy-update for more info."));
     }
     mp_raw_code_t *rc = load_raw_code(reader);
+    nlr_pop();
+    #if MICROPY_PERSISTENT_CODE_LOAD_XIP
+    mp_reader_xip_keep(reader);
+    #endif
     reader->close(reader->data);
     return rc;
 }
@@ -249,8 +323,21 @@ mp_raw_code_t *mp_raw_code_load_mem(const byte *buf, size_t len) {
     return mp_raw_code_load(&reader);
 }
 
+#if MICROPY_PERSISTENT_CODE_LOAD_XIP
+mp_raw_code_t *mp_raw_code_load_xip(byte *buf, size_t len, bool writable) {
+    mp_reader_t reader;
+    mp_reader_new_mem_xip(&reader, buf, len, writable);
+    return mp_raw_code_load(&reader);
+}
+#endif
+
 mp_raw_code_t *mp_raw_code_load_file(const char *filename) {
     mp_reader_t reader;
+    #if MICROPY_PERSISTENT_CODE_LOAD_XIP
+    if (mp_reader_new_file_xip(&reader, filename)) {
+        return mp_raw_code_load(&reader);
+    }
+    #endif
     mp_reader_new_file(&reader, filename);
     return mp_raw_code_load(&reader);
 }
@@ -33,6 +33,11 @@
 mp_raw_code_t *mp_raw_code_load(mp_reader_t *reader);
 mp_raw_code_t *mp_raw_code_load_mem(const byte *buf, size_t len);
 mp_raw_code_t *mp_raw_code_load_file(const char *filename);
+#if MICROPY_PERSISTENT_CODE_LOAD_XIP
+// Loads a .mpy image that stays at buf for the life of the program, such as one
+// in memory mapped flash. The bytecode is executed from buf when possible.
+mp_raw_code_t *mp_raw_code_load_xip(byte *buf, size_t len, bool writable);
+#endif
 
 void mp_raw_code_save(mp_raw_code_t *rc, mp_print_t *print);
 void mp_raw_code_save_file(mp_raw_code_t *rc, const char *filename);
@@ -169,6 +169,7 @@ PY_CORE_O_BASENAME = $(addprefix py/,\
 	runtime.o \
 	runtime_utils.o \
 	scheduler.o \
+	ringbuf.o \
 	nativeglue.o \
 	stackctrl.o \
 	argcheck.o \
@@ -249,6 +250,10 @@ PY_EXTMOD_O_BASENAME = \
 	extmod/moduzlib.o \
 	extmod/moduheapq.o \
 	extmod/modutimeq.o \
+	extmod/moduasyncio.o \
+	extmod/moduprofile.o \
+	extmod/moduheap.o \
+	extmod/sampletable.o \
 	extmod/moduhashlib.o \
 	extmod/modubinascii.o \
 	extmod/virtpin.o \
@@ -36,6 +36,11 @@ typedef struct _mp_reader_mem_t {
     const byte *beg;
     const byte *cur;
     const byte *end;
+    #if MICROPY_PERSISTENT_CODE_LOAD_XIP
+    bool xip;
+    bool writable;
+    mp_reader_image_t *image;
+    #endif
 } mp_reader_mem_t;
 
 STATIC mp_uint_t mp_reader_mem_readbyte(void *data) {
@@ -47,8 +52,36 @@ STATIC mp_uint_t mp_reader_mem_readbyte(void *data) {
     }
 }
 
+STATIC const byte *mp_reader_mem_readchunk(void *data, size_t *len) {
+    mp_reader_mem_t *reader = (mp_reader_mem_t*)data;
+    const byte *chunk = reader->cur;
+    *len = reader->end - reader->cur;
+    reader->cur = reader->end;
+    return chunk;
+}
+
+#if MICROPY_PERSISTENT_CODE_LOAD_XIP
+#if !MICROPY_ENABLE_FINALISER
+#error MICROPY_PERSISTENT_CODE_LOAD_XIP needs MICROPY_ENABLE_FINALISER to free images
+#endif
+
+STATIC void mp_reader_image_release(mp_reader_image_t *image) {
+    if (image->map.buf != NULL && image->map.release != NULL) {
+        image->map.release(image->map.buf, image->map.len);
+    }
+    image->map.buf = NULL;
+    image->map.owner = MP_OBJ_NULL;
+}
+#endif
+
 STATIC void mp_reader_mem_close(void *data) {
     mp_reader_mem_t *reader = (mp_reader_mem_t*)data;
+    #if MICROPY_PERSISTENT_CODE_LOAD_XIP
+    // Nothing executes from an image whose load didn't finish.
+    if (reader->image != NULL && !reader->image->keep) {
+        mp_reader_image_release(reader->image);
+    }
+    #endif
     if (reader->free_len > 0) {
         m_del(char, (char*)reader->beg, reader->free_len);
     }
@@ -61,43 +94,140 @@ void mp_reader_new_mem(mp_reader_t *reader, const byte *buf, size_t len, size_t
     rm->beg = buf;
     rm->cur = buf;
     rm->end = buf + len;
+    #if MICROPY_PERSISTENT_CODE_LOAD_XIP
+    rm->xip = false;
+    rm->writable = false;
+    rm->image = NULL;
+    #endif
     reader->data = rm;
     reader->readbyte = mp_reader_mem_readbyte;
+    reader->readchunk = mp_reader_mem_readchunk;
     reader->close = mp_reader_mem_close;
 }
 
+#if MICROPY_PERSISTENT_CODE_LOAD_XIP
+void mp_reader_new_mem_xip(mp_reader_t *reader, byte *buf, size_t len, bool writable) {
+    mp_reader_new_mem(reader, buf, len, 0);
+    mp_reader_mem_t *rm = (mp_reader_mem_t*)reader->data;
+    rm->xip = true;
+    rm->writable = writable;
+}
+
+STATIC mp_obj_t mp_reader_image_del(mp_obj_t self_in) {
+    mp_reader_image_release(MP_OBJ_TO_PTR(self_in));
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(mp_reader_image_del_obj, mp_reader_image_del);
+
+STATIC const mp_rom_map_elem_t mp_reader_image_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&mp_reader_image_del_obj) },
+};
+STATIC MP_DEFINE_CONST_DICT(mp_reader_image_locals_dict, mp_reader_image_locals_dict_table);
+
+STATIC const mp_obj_type_t mp_type_reader_image = {
+    { &mp_type_type },
+    .name = MP_QSTR_image,
+    .locals_dict = (mp_obj_dict_t*)&mp_reader_image_locals_dict,
+};
+
+mp_reader_image_t *mp_reader_image_new(void) {
+    mp_reader_image_t *image = m_new_obj_with_finaliser(mp_reader_image_t);
+    image->base.type = &mp_type_reader_image;
+    image->map.buf = NULL;
+    image->map.len = 0;
+    image->map.writable = false;
+    image->map.release = NULL;
+    image->map.owner = MP_OBJ_NULL;
+    image->keep = false;
+    return image;
+}
+
+void mp_reader_new_image(mp_reader_t *reader, mp_reader_image_t *image) {
+    mp_reader_new_mem_xip(reader, image->map.buf, image->map.len, image->map.writable);
+    mp_reader_mem_t *rm = (mp_reader_mem_t*)reader->data;
+    rm->image = image;
+}
+
+byte *mp_reader_xip_data(mp_reader_t *reader, size_t len, bool *writable, mp_obj_t *image) {
+    if (reader->readbyte != mp_reader_mem_readbyte) {
+        return NULL;
+    }
+    mp_reader_mem_t *rm = (mp_reader_mem_t*)reader->data;
+    if (!rm->xip || (size_t)(rm->end - rm->cur) < len) {
+        return NULL;
+    }
+    byte *data = (byte*)rm->cur;
+    rm->cur += len;
+    *writable = rm->writable;
+    *image = rm->image == NULL ? MP_OBJ_NULL : MP_OBJ_FROM_PTR(rm->image);
+    return data;
+}
+
+void mp_reader_xip_keep(mp_reader_t *reader) {
+    if (reader->readbyte == mp_reader_mem_readbyte) {
+        mp_reader_mem_t *rm = (mp_reader_mem_t*)reader->data;
+        if (rm->image != NULL) {
+            rm->image->keep = true;
+        }
+    }
+}
+#endif
+
 #if MICROPY_READER_POSIX
 
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
+#if MICROPY_PERSISTENT_CODE_LOAD_XIP
+#include <errno.h>
+#include <sys/mman.h>
+#endif
 
 typedef struct _mp_reader_posix_t {
     bool close_fd;
     int fd;
     size_t len;
     size_t pos;
-    byte buf[20];
+    byte buf[MICROPY_READER_BUF_SIZE];
 } mp_reader_posix_t;
 
-STATIC mp_uint_t mp_reader_posix_readbyte(void *data) {
-    mp_reader_posix_t *reader = (mp_reader_posix_t*)data;
+// Refills the buffer once it has been consumed; returns false at end of file.
+STATIC bool mp_reader_posix_fill(mp_reader_posix_t *reader) {
     if (reader->pos >= reader->len) {
         if (reader->len == 0) {
-            return MP_READER_EOF;
-        } else {
-            int n = read(reader->fd, reader->buf, sizeof(reader->buf));
-            if (n <= 0) {
-                reader->len = 0;
-                return MP_READER_EOF;
-            }
-            reader->len = n;
-            reader->pos = 0;
+            return false;
         }
+        int n = read(reader->fd, reader->buf, sizeof(reader->buf));
+        if (n <= 0) {
+            reader->len = 0;
+            return false;
+        }
+        reader->len = n;
+        reader->pos = 0;
+    }
+    return true;
+}
+
+STATIC mp_uint_t mp_reader_posix_readbyte(void *data) {
+    mp_reader_posix_t *reader = (mp_reader_posix_t*)data;
+    if (!mp_reader_posix_fill(reader)) {
+        return MP_READER_EOF;
     }
     return reader->buf[reader->pos++];
 }
 
+STATIC const byte *mp_reader_posix_readchunk(void *data, size_t *len) {
+    mp_reader_posix_t *reader = (mp_reader_posix_t*)data;
+    if (!mp_reader_posix_fill(reader)) {
+        *len = 0;
+        return NULL;
+    }
+    const byte *chunk = reader->buf + reader->pos;
+    *len = reader->len - reader->pos;
+    reader->pos = reader->len;
+    return chunk;
+}
+
 STATIC void mp_reader_posix_close(void *data) {
     mp_reader_posix_t *reader = (mp_reader_posix_t*)data;
     if (reader->close_fd) {
@@ -121,6 +251,7 @@ void mp_reader_new_file_from_fd(mp_reader_t *reader, int fd, bool close_fd) {
     rp->pos = 0;
     reader->data = rp;
     reader->readbyte = mp_reader_posix_readbyte;
+    reader->readchunk = mp_reader_posix_readchunk;
     reader->close = mp_reader_posix_close;
 }
 
@@ -133,6 +264,62 @@ void mp_reader_new_file(mp_reader_t *reader, const char *filename) {
     }
     mp_reader_new_file_from_fd(reader, fd, true);
 }
+
+#if MICROPY_PERSISTENT_CODE_LOAD_XIP
+bool mp_reader_new_file_xip(mp_reader_t *reader, const char *filename) {
+    mp_reader_image_t *image = mp_reader_image_new();
+    int fd = open(filename, O_RDONLY, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    image->map.buf = mp_reader_posix_snapshot(fd, &image->map.len);
+    close(fd);
+    if (image->map.buf == NULL) {
+        return false;
+    }
+    image->map.writable = true;
+    image->map.release = mp_reader_posix_release;
+    mp_reader_new_image(reader, image);
+    return true;
+}
+#endif
+#endif
+
+#if MICROPY_PERSISTENT_CODE_LOAD_XIP
+// A MAP_PRIVATE mapping of the file itself would avoid the copy but isn't a
+// snapshot: pages that haven't been written to yet still show later changes
+// to the file, and ones past a truncation fault. Anonymous memory is used
+// instead so that it is outside the heap, like a mapping would be.
+byte *mp_reader_posix_snapshot(int fd, size_t *len) {
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size <= 0) {
+        return NULL;
+    }
+    size_t size = st.st_size;
+    byte *buf = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buf == MAP_FAILED) {
+        return NULL;
+    }
+    size_t n = 0;
+    while (n < size) {
+        ssize_t res = pread(fd, buf + n, size - n, n);
+        if (res < 0 && errno == EINTR) {
+            continue;
+        }
+        if (res <= 0) {
+            // An error, or the file got shorter.
+            munmap(buf, size);
+            return NULL;
+        }
+        n += res;
+    }
+    *len = size;
+    return buf;
+}
+
+void mp_reader_posix_release(byte *buf, size_t len) {
+    munmap(buf, len);
+}
 #endif
 
 #endif
@@ -33,9 +33,15 @@
 // it can be called again after returning MP_READER_EOF, and in that case must return MP_READER_EOF
 #define MP_READER_EOF ((mp_uint_t)(-1))
 
+// the readchunk function returns a pointer to the next run of bytes the reader
+// already has in memory, consuming them, and stores their number in *len
+// the bytes stay valid until the next call to readbyte or readchunk
+// at end of stream it stores 0 in *len (and may return NULL)
+
 typedef struct _mp_reader_t {
     void *data;
     mp_uint_t (*readbyte)(void *data);
+    const byte *(*readchunk)(void *data, size_t *len);
     void (*close)(void *data);
 } mp_reader_t;
 
@@ -43,4 +49,45 @@ void mp_reader_new_mem(mp_reader_t *reader, const byte *buf, size_t len, size_t
 void mp_reader_new_file(mp_reader_t *reader, const char *filename);
 void mp_reader_new_file_from_fd(mp_reader_t *reader, int fd, bool close_fd);
 
+#if MICROPY_PERSISTENT_CODE_LOAD_XIP
+#include "py/stream.h"
+
+// A memory reader over a buffer that is never freed or moved, so data can be
+// used where it is instead of being copied out. If writable, the buffer may be
+// modified in place.
+void mp_reader_new_mem_xip(mp_reader_t *reader, byte *buf, size_t len, bool writable);
+
+// The in-memory copy or mapping of a file that code is executed from in place.
+// Each function loaded from it keeps it, and so its owner, alive, and its
+// release function is called when the last of them is collected. It is
+// allocated empty, before map is filled in, so that running out of memory
+// can't leak the copy.
+typedef struct _mp_reader_image_t {
+    mp_obj_base_t base;
+    struct mp_stream_mmap_t map;
+    bool keep;
+} mp_reader_image_t;
+mp_reader_image_t *mp_reader_image_new(void);
+// An XIP reader over the image. Closing the reader releases the image unless
+// a load from it finished, see mp_reader_xip_keep.
+void mp_reader_new_image(mp_reader_t *reader, mp_reader_image_t *image);
+// Returns a pointer to the next len bytes of an XIP reader and skips over them.
+// Returns NULL if the reader isn't an XIP one or is too short. *image is set
+// to the image the bytes are in, or MP_OBJ_NULL if the buffer is never freed;
+// code executed from the bytes must keep a reference to it.
+byte *mp_reader_xip_data(mp_reader_t *reader, size_t len, bool *writable, mp_obj_t *image);
+// Keeps the reader's image, if any, once the reader is closed.
+void mp_reader_xip_keep(mp_reader_t *reader);
+// Sets up an XIP reader over a copy of the file. Returns false if the file
+// can't be copied, in which case mp_reader_new_file should be used.
+bool mp_reader_new_file_xip(mp_reader_t *reader, const char *filename);
+
+#if MICROPY_READER_POSIX
+// Reads all of fd into private memory outside the heap for MP_STREAM_GET_MMAP.
+// Returns NULL if it can't.
+byte *mp_reader_posix_snapshot(int fd, size_t *len);
+void mp_reader_posix_release(byte *buf, size_t len);
+#endif
+#endif
+
 #endif // MICROPY_INCLUDED_PY_READER_H
@@ -0,0 +1,95 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Paul Sokolovsky
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include "py/gc.h"
+#include "py/misc.h"
+#include "py/ringbuf.h"
+
+#if MICROPY_ENABLE_GC
+bool ringbuf_alloc(ringbuf_t *r, size_t sz, bool long_lived) {
+    r->buf = gc_alloc(sz, false, long_lived);
+    r->size = r->buf == NULL ? 0 : sz;
+    r->iget = r->iput = 0;
+    r->get_pos = r->put_pos = 0;
+    r->high_water = 0;
+    return r->buf != NULL;
+}
+#endif
+
+size_t ringbuf_get_peek(ringbuf_t *r, uint8_t **ptr) {
+    *ptr = r->buf + r->get_pos;
+    return MIN(ringbuf_load_acquire(&r->iput) - r->iget, r->size - r->get_pos);
+}
+
+void ringbuf_get_commit(ringbuf_t *r, size_t n) {
+    r->get_pos = ringbuf_offset(r, r->get_pos, n);
+    ringbuf_store_release(&r->iget, r->iget + n);
+}
+
+size_t ringbuf_get_n(ringbuf_t *r, uint8_t *data, size_t len) {
+    // At most two contiguous spans: up to the end of the buffer, then from
+    // the start.
+    size_t total = 0;
+    for (int i = 0; i < 2 && total < len; i++) {
+        uint8_t *src;
+        size_t n = MIN(ringbuf_get_peek(r, &src), len - total);
+        memcpy(data + total, src, n);
+        ringbuf_get_commit(r, n);
+        total += n;
+    }
+    return total;
+}
+
+size_t ringbuf_put_peek(ringbuf_t *r, uint8_t **ptr) {
+    *ptr = r->buf + r->put_pos;
+    return MIN(r->size - (r->iput - ringbuf_load_acquire(&r->iget)), r->size - r->put_pos);
+}
+
+void ringbuf_put_commit(ringbuf_t *r, size_t n) {
+    r->put_pos = ringbuf_offset(r, r->put_pos, n);
+    uint32_t iput = r->iput + n;
+    ringbuf_store_release(&r->iput, iput);
+    // Only the producer writes high_water, so a racy read of iget just
+    // under-reports by whatever the consumer took in the meantime.
+    uint32_t count = iput - ringbuf_load_acquire(&r->iget);
+    if (count > r->high_water) {
+        r->high_water = count;
+    }
+}
+
+size_t ringbuf_put_n(ringbuf_t *r, const uint8_t *data, size_t len) {
+    size_t total = 0;
+    for (int i = 0; i < 2 && total < len; i++) {
+        uint8_t *dest;
+        size_t n = MIN(ringbuf_put_peek(r, &dest), len - total);
+        memcpy(dest, data + total, n);
+        ringbuf_put_commit(r, n);
+        total += n;
+    }
+    return total;
+}
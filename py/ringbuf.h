@@ -26,84 +26,117 @@
 #ifndef MICROPY_INCLUDED_PY_RINGBUF_H
 #define MICROPY_INCLUDED_PY_RINGBUF_H
 
-#include "py/gc.h"
-
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+// A single-producer/single-consumer byte ring. One side (typically an
+// interrupt handler) only calls the put functions and the other side only
+// calls the get functions; neither needs to lock out the other.
+//
+// iget/iput run freely, wrapping at 2^32, so the count is always
+// iput - iget and the whole buffer is usable. Each index is only written by
+// its own side, with release ordering, and read by the other side with
+// acquire ordering so the bytes it covers are visible before the index is.
+// get_pos/put_pos are where those indices fall in buf. They are kept
+// separately, each by its own side, so that the size can be anything rather
+// than a power of two.
 typedef struct _ringbuf_t {
     uint8_t *buf;
-    uint16_t size;
-    uint16_t iget;
-    uint16_t iput;
+    uint32_t size;
+    uint32_t iget;
+    uint32_t iput;
+    uint32_t get_pos;
+    uint32_t put_pos;
+    // Largest count the producer has left in the buffer.
+    uint32_t high_water;
 } ringbuf_t;
 
 // Static initialization:
 // byte buf_array[N];
 // ringbuf_t buf = {buf_array, sizeof(buf_array)};
 
-// Dynamic initialization. This creates root pointer!
-#define ringbuf_alloc(r, sz, long_lived)                   \
-{ \
-    (r)->buf = gc_alloc(sz, false, long_lived);   \
-    (r)->size = sz; \
-    (r)->iget = (r)->iput = 0; \
+// Dynamic initialization. This creates root pointer! Returns false, and
+// leaves buf NULL, if out of memory.
+bool ringbuf_alloc(ringbuf_t *r, size_t sz, bool long_lived);
+
+// The position in buf n bytes after pos, for n up to the size.
+static inline uint32_t ringbuf_offset(ringbuf_t *r, uint32_t pos, size_t n) {
+    pos += n;
+    return pos >= r->size ? pos - r->size : pos;
 }
 
-static inline int ringbuf_get(ringbuf_t *r) {
-    if (r->iget == r->iput) {
-        return -1;
-    }
-    uint8_t v = r->buf[r->iget++];
-    if (r->iget >= r->size) {
-        r->iget = 0;
-    }
-    return v;
+static inline uint32_t ringbuf_load_acquire(const uint32_t *p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
 }
 
-static inline int ringbuf_put(ringbuf_t *r, uint8_t v) {
-    uint32_t iput_new = r->iput + 1;
-    if (iput_new >= r->size) {
-        iput_new = 0;
-    }
-    if (iput_new == r->iget) {
-        return -1;
-    }
-    r->buf[r->iput] = v;
-    r->iput = iput_new;
-    return 0;
+static inline void ringbuf_store_release(uint32_t *p, uint32_t v) {
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
 }
 
-static inline uint16_t ringbuf_count(ringbuf_t *r)
-{
-    volatile int count = r->iput - r->iget;
-    if ( count < 0 ) {
-        count += r->size;
-    }
+static inline size_t ringbuf_count(ringbuf_t *r) {
+    uint32_t iget = ringbuf_load_acquire(&r->iget);
+    return ringbuf_load_acquire(&r->iput) - iget;
+}
 
-    return (uint16_t) count;
+static inline size_t ringbuf_free(ringbuf_t *r) {
+    return r->size - ringbuf_count(r);
 }
 
-static inline void ringbuf_clear(ringbuf_t *r)
-{
-    r->iput = r->iget = 0;
+static inline size_t ringbuf_high_water(ringbuf_t *r) {
+    return r->high_water;
 }
 
-// will overwrite old data
-static inline void ringbuf_put_n(ringbuf_t* r, uint8_t* buf, uint8_t bufsize)
-{
-    for(uint8_t i=0; i < bufsize; i++) {
-        if ( ringbuf_put(r, buf[i]) < 0 ) {
-            // if full overwrite old data
-            (void) ringbuf_get(r);
-            ringbuf_put(r, buf[i]);
-        }
+// Consumer side.
+
+static inline int ringbuf_get(ringbuf_t *r) {
+    uint32_t iget = r->iget;
+    if (iget == ringbuf_load_acquire(&r->iput)) {
+        return -1;
     }
+    uint8_t v = r->buf[r->get_pos];
+    r->get_pos = ringbuf_offset(r, r->get_pos, 1);
+    ringbuf_store_release(&r->iget, iget + 1);
+    return v;
+}
+
+// Discards n bytes, up to the count.
+void ringbuf_get_commit(ringbuf_t *r, size_t n);
+
+// Discards everything currently in the buffer.
+static inline void ringbuf_clear(ringbuf_t *r) {
+    ringbuf_get_commit(r, ringbuf_count(r));
 }
 
-static inline void ringbuf_get_n(ringbuf_t* r, uint8_t* buf, uint8_t bufsize)
-{
-    for(uint8_t i=0; i < bufsize; i++) {
-        buf[i] = ringbuf_get(r);
+// Copies out up to len bytes and returns how many were copied.
+size_t ringbuf_get_n(ringbuf_t *r, uint8_t *data, size_t len);
+
+// Zero-copy read: points *ptr at the oldest bytes and returns how many can
+// be read there without wrapping. ringbuf_get_commit() then releases n of
+// them back to the producer.
+size_t ringbuf_get_peek(ringbuf_t *r, uint8_t **ptr);
+
+// Producer side.
+
+void ringbuf_put_commit(ringbuf_t *r, size_t n);
+
+static inline int ringbuf_put(ringbuf_t *r, uint8_t v) {
+    uint32_t iput = r->iput;
+    if (iput - ringbuf_load_acquire(&r->iget) == r->size) {
+        return -1;
     }
+    r->buf[r->put_pos] = v;
+    ringbuf_put_commit(r, 1);
+    return 0;
 }
+
+// Copies in as much of data as fits and returns how many bytes were stored.
+// Old data is never overwritten; what doesn't fit is dropped.
+size_t ringbuf_put_n(ringbuf_t *r, const uint8_t *data, size_t len);
+
+// Zero-copy write: points *ptr at free space and returns how many bytes can
+// be written there without wrapping. ringbuf_put_commit() then publishes n
+// of them to the consumer.
+size_t ringbuf_put_peek(ringbuf_t *r, uint8_t **ptr);
+
 #endif // MICROPY_INCLUDED_PY_RINGBUF_H
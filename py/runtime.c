@@ -69,6 +69,11 @@ void mp_init(void) {
     #if MICROPY_ENABLE_SCHEDULER
     MP_STATE_VM(sched_state) = MP_SCHED_IDLE;
     MP_STATE_VM(sched_sp) = 0;
+    #if MICROPY_SCHEDULER_PRIORITY
+    MP_STATE_VM(sched_max_sp) = 0;
+    MP_STATE_VM(sched_dropped) = 0;
+    MP_STATE_VM(sched_max_latency_us) = 0;
+    #endif
     #endif
 
 #if MICROPY_ENABLE_EMERGENCY_EXCEPTION_BUF
@@ -123,6 +128,22 @@ void mp_init(void) {
     MP_STATE_VM(dupterm_arr_obj) = MP_OBJ_NULL;
     #endif
 
+    #if MICROPY_PY_UASYNCIO
+    MP_STATE_VM(uasyncio_loop) = MP_OBJ_NULL;
+    #endif
+
+    #if MICROPY_PY_UPROFILE
+    MP_STATE_VM(uprofile) = NULL;
+    #endif
+
+    #if MICROPY_PY_UHEAP
+    MP_STATE_VM(uheap) = NULL;
+    #endif
+
+    #if MICROPY_TRACK_CODE_STATE
+    MP_STATE_THREAD(current_code_state) = NULL;
+    #endif
+
     #ifdef MICROPY_FSUSERMOUNT
     // zero out the pointers to the user-mounted devices
     memset(MP_STATE_VM(fs_user_mount) + MICROPY_FATFS_NUM_PERSISTENT, 0,
@@ -72,6 +72,12 @@ void mp_sched_lock(void);
 void mp_sched_unlock(void);
 static inline unsigned int mp_sched_num_pending(void) { return MP_STATE_VM(sched_sp); }
 bool mp_sched_schedule(mp_obj_t function, mp_obj_t arg);
+#if MICROPY_SCHEDULER_PRIORITY
+// Higher priorities run first. Within a priority, callbacks with a deadline
+// run before those without, earliest deadline first, and otherwise in the
+// order they were scheduled. A negative deadline_us means no deadline.
+bool mp_sched_schedule_priority(mp_obj_t function, mp_obj_t arg, uint8_t priority, mp_int_t deadline_us);
+#endif
 #endif
 
 // extra printing method specifically for mp_obj_t's which are integral type
@@ -27,9 +27,32 @@
 #include <stdio.h>
 
 #include "py/runtime.h"
+#include "py/mphal.h"
 
 #if MICROPY_ENABLE_SCHEDULER
 
+#if MICROPY_SCHEDULER_PRIORITY
+// Whether a should run before b. The stack is kept ordered by this so the
+// most urgent item is always on top.
+STATIC bool sched_item_before(const mp_sched_item_t *a, const mp_sched_item_t *b) {
+    if (a->priority != b->priority) {
+        return a->priority > b->priority;
+    }
+    if (a->has_deadline != b->has_deadline) {
+        return a->has_deadline;
+    }
+    return a->has_deadline && (mp_int_t)(a->deadline_us - b->deadline_us) < 0;
+}
+
+STATIC bool sched_top_overdue(void) {
+    if (MP_STATE_VM(sched_sp) == 0) {
+        return false;
+    }
+    mp_sched_item_t *top = &MP_STATE_VM(sched_stack)[MP_STATE_VM(sched_sp) - 1];
+    return top->has_deadline && (mp_int_t)(mp_hal_ticks_us() - top->deadline_us) >= 0;
+}
+#endif
+
 // A variant of this is inlined in the VM at the pending exception check
 void mp_handle_pending(void) {
     if (MP_STATE_VM(sched_state) == MP_SCHED_PENDING) {
@@ -51,13 +74,27 @@ void mp_handle_pending(void) {
 // or by the VM's inlined version of that function.
 void mp_handle_pending_tail(mp_uint_t atomic_state) {
     MP_STATE_VM(sched_state) = MP_SCHED_LOCKED;
-    if (MP_STATE_VM(sched_sp) > 0) {
+    while (MP_STATE_VM(sched_sp) > 0) {
         mp_sched_item_t item = MP_STATE_VM(sched_stack)[--MP_STATE_VM(sched_sp)];
+        #if MICROPY_SCHEDULER_PRIORITY
+        mp_uint_t latency = mp_hal_ticks_us() - item.enqueued_us;
+        if (latency > MP_STATE_VM(sched_max_latency_us)) {
+            MP_STATE_VM(sched_max_latency_us) = latency;
+        }
+        #endif
         MICROPY_END_ATOMIC_SECTION(atomic_state);
         mp_call_function_1_protected(item.func, item.arg);
-    } else {
-        MICROPY_END_ATOMIC_SECTION(atomic_state);
+        atomic_state = MICROPY_BEGIN_ATOMIC_SECTION();
+        #if MICROPY_SCHEDULER_PRIORITY
+        // Don't leave a callback that has already missed its deadline
+        // waiting for the next branch point.
+        if (sched_top_overdue()) {
+            continue;
+        }
+        #endif
+        break;
     }
+    MICROPY_END_ATOMIC_SECTION(atomic_state);
     mp_sched_unlock();
 }
 
@@ -84,6 +121,49 @@ void mp_sched_unlock(void) {
     MICROPY_END_ATOMIC_SECTION(atomic_state);
 }
 
+#if MICROPY_SCHEDULER_PRIORITY
+
+bool mp_sched_schedule(mp_obj_t function, mp_obj_t arg) {
+    return mp_sched_schedule_priority(function, arg, 0, -1);
+}
+
+bool mp_sched_schedule_priority(mp_obj_t function, mp_obj_t arg, uint8_t priority, mp_int_t deadline_us) {
+    mp_sched_item_t item;
+    item.func = function;
+    item.arg = arg;
+    item.enqueued_us = mp_hal_ticks_us();
+    item.deadline_us = item.enqueued_us + deadline_us;
+    item.priority = priority;
+    item.has_deadline = deadline_us >= 0;
+
+    mp_uint_t atomic_state = MICROPY_BEGIN_ATOMIC_SECTION();
+    bool ret;
+    if (MP_STATE_VM(sched_sp) < MICROPY_SCHEDULER_DEPTH) {
+        if (MP_STATE_VM(sched_state) == MP_SCHED_IDLE) {
+            MP_STATE_VM(sched_state) = MP_SCHED_PENDING;
+        }
+        // Slide everything the new item should run before down by one.
+        mp_sched_item_t *stack = MP_STATE_VM(sched_stack);
+        size_t i = MP_STATE_VM(sched_sp)++;
+        for (; i > 0 && !sched_item_before(&item, &stack[i - 1]); --i) {
+            stack[i] = stack[i - 1];
+        }
+        stack[i] = item;
+        if (MP_STATE_VM(sched_sp) > MP_STATE_VM(sched_max_sp)) {
+            MP_STATE_VM(sched_max_sp) = MP_STATE_VM(sched_sp);
+        }
+        ret = true;
+    } else {
+        // schedule stack is full
+        ++MP_STATE_VM(sched_dropped);
+        ret = false;
+    }
+    MICROPY_END_ATOMIC_SECTION(atomic_state);
+    return ret;
+}
+
+#else
+
 bool mp_sched_schedule(mp_obj_t function, mp_obj_t arg) {
     mp_uint_t atomic_state = MICROPY_BEGIN_ATOMIC_SECTION();
     bool ret;
@@ -103,6 +183,9 @@ bool mp_sched_schedule(mp_obj_t function, mp_obj_t arg) {
     return ret;
 }
 
+#endif
+
+
 #else // MICROPY_ENABLE_SCHEDULER
 
 // A variant of this is inlined in the VM at the pending exception check
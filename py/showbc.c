@@ -370,6 +370,33 @@ const byte *mp_bytecode_print_str(const byte *ip) {
             ip += 1;
             break;
 
+        case MP_BC_LOAD_FAST_LOAD_FAST:
+            printf("LOAD_FAST_LOAD_FAST %d %d", ip[0] & 0x0f, ip[0] >> 4);
+            ip += 1;
+            break;
+
+        case MP_BC_BINARY_OP_FAST_IMM:
+            printf("BINARY_OP_FAST_IMM %d %s %d", ip[0], qstr_str(mp_binary_op_method_name[ip[1]]), (int8_t)ip[2]);
+            ip += 3;
+            break;
+
+        case MP_BC_BINARY_OP_FAST_IMM_STORE:
+            printf("BINARY_OP_FAST_IMM_STORE %d %s %d %d", ip[0], qstr_str(mp_binary_op_method_name[ip[1]]), (int8_t)ip[2], ip[3]);
+            ip += 4;
+            break;
+
+        case MP_BC_BINARY_OP_POP_JUMP_IF_FALSE:
+            DECODE_SLABEL;
+            printf("BINARY_OP_POP_JUMP_IF_FALSE " UINT_FMT " %s", (mp_uint_t)(ip + unum - mp_showbc_code_start), qstr_str(mp_binary_op_method_name[*ip]));
+            ip += 1;
+            break;
+
+        case MP_BC_BINARY_OP_POP_JUMP_IF_TRUE:
+            DECODE_SLABEL;
+            printf("BINARY_OP_POP_JUMP_IF_TRUE " UINT_FMT " %s", (mp_uint_t)(ip + unum - mp_showbc_code_start), qstr_str(mp_binary_op_method_name[*ip]));
+            ip += 1;
+            break;
+
         case MP_BC_SETUP_EXCEPT:
             DECODE_ULABEL; // except labels are always forward
             printf("SETUP_EXCEPT " UINT_FMT, (mp_uint_t)(ip + unum - mp_showbc_code_start));
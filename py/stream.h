@@ -42,6 +42,7 @@
 #define MP_STREAM_SET_OPTS      (7)  // Set stream options
 #define MP_STREAM_GET_DATA_OPTS (8)  // Get data/message options
 #define MP_STREAM_SET_DATA_OPTS (9)  // Set data/message options
+#define MP_STREAM_GET_MMAP      (10) // Get the whole file in memory
 
 // These poll ioctl values are compatible with Linux
 #define MP_STREAM_POLL_RD  (0x0001)
@@ -58,6 +59,20 @@ struct mp_stream_seek_t {
     int whence;
 };
 
+// Argument structure for MP_STREAM_GET_MMAP. buf holds the file as it was when
+// the ioctl was made and must not change, even if the file does, until
+// release(buf, len) is called, which may be after the stream is closed. With
+// release NULL buf is never freed, like a file in memory mapped flash. If buf
+// belongs to an object, owner is set to it and kept alive for as long as buf
+// is used. A writable buf is private, so writes to it never reach the file.
+struct mp_stream_mmap_t {
+    byte *buf;
+    size_t len;
+    bool writable;
+    void (*release)(byte *buf, size_t len);
+    mp_obj_t owner;
+};
+
 // seek ioctl "whence" values
 #define MP_SEEK_SET (0)
 #define MP_SEEK_CUR (1)
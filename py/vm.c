@@ -32,6 +32,7 @@
 #include "py/emitglue.h"
 #include "py/objtype.h"
 #include "py/runtime.h"
+#include "py/smallint.h"
 #include "py/bc0.h"
 #include "py/bc.h"
 
@@ -110,6 +111,104 @@
     exc_sp--; /* pop back to previous exception handler */ \
     CLEAR_SYS_EXC_INFO() /* just clear sys.exc_info(), not compliant, but it shouldn't be used in 1st place */
 
+#if MICROPY_OPT_VM_FAST_BINARY_OP
+// Handles the common arithmetic and comparison operators on two small ints,
+// or on floats (possibly mixed with a small int), without the type dispatch
+// that mp_binary_op does first.  Anything unusual, such as an overflow, a
+// negative shift or a division by zero, goes to mp_binary_op so that it
+// produces the same result or exception as it always did.
+STATIC mp_obj_t vm_binary_op(mp_binary_op_t op, mp_obj_t lhs, mp_obj_t rhs) {
+    if (MP_OBJ_IS_SMALL_INT(lhs) && MP_OBJ_IS_SMALL_INT(rhs)) {
+        mp_int_t lhs_val = MP_OBJ_SMALL_INT_VALUE(lhs);
+        mp_int_t rhs_val = MP_OBJ_SMALL_INT_VALUE(rhs);
+        switch (op) {
+            // + and - can't overflow mp_int_t; the result is checked below
+            case MP_BINARY_OP_ADD:
+            case MP_BINARY_OP_INPLACE_ADD: lhs_val += rhs_val; break;
+            case MP_BINARY_OP_SUBTRACT:
+            case MP_BINARY_OP_INPLACE_SUBTRACT: lhs_val -= rhs_val; break;
+            case MP_BINARY_OP_MULTIPLY:
+            case MP_BINARY_OP_INPLACE_MULTIPLY:
+                if (mp_small_int_mul_overflow(lhs_val, rhs_val)) {
+                    goto generic;
+                }
+                lhs_val *= rhs_val;
+                break;
+            case MP_BINARY_OP_AND:
+            case MP_BINARY_OP_INPLACE_AND: lhs_val &= rhs_val; break;
+            case MP_BINARY_OP_OR:
+            case MP_BINARY_OP_INPLACE_OR: lhs_val |= rhs_val; break;
+            case MP_BINARY_OP_XOR:
+            case MP_BINARY_OP_INPLACE_XOR: lhs_val ^= rhs_val; break;
+            case MP_BINARY_OP_RSHIFT:
+            case MP_BINARY_OP_INPLACE_RSHIFT:
+                if (rhs_val < 0 || rhs_val >= (mp_int_t)BITS_PER_WORD) {
+                    goto generic;
+                }
+                lhs_val >>= rhs_val;
+                break;
+            case MP_BINARY_OP_LESS: return mp_obj_new_bool(lhs_val < rhs_val);
+            case MP_BINARY_OP_MORE: return mp_obj_new_bool(lhs_val > rhs_val);
+            case MP_BINARY_OP_LESS_EQUAL: return mp_obj_new_bool(lhs_val <= rhs_val);
+            case MP_BINARY_OP_MORE_EQUAL: return mp_obj_new_bool(lhs_val >= rhs_val);
+            case MP_BINARY_OP_EQUAL: return mp_obj_new_bool(lhs_val == rhs_val);
+            case MP_BINARY_OP_NOT_EQUAL: return mp_obj_new_bool(lhs_val != rhs_val);
+            default: goto generic;
+        }
+        if (MP_SMALL_INT_FITS(lhs_val)) {
+            return MP_OBJ_NEW_SMALL_INT(lhs_val);
+        }
+        goto generic;
+    }
+
+    #if MICROPY_PY_BUILTINS_FLOAT
+    {
+        // With MICROPY_OBJ_REPR_C or _D the float result is stored in the
+        // object word itself, so this path doesn't touch the heap at all.
+        mp_float_t lhs_val, rhs_val;
+        if (mp_obj_is_float(lhs)) {
+            lhs_val = mp_obj_float_get(lhs);
+        } else if (MP_OBJ_IS_SMALL_INT(lhs)) {
+            lhs_val = (mp_float_t)MP_OBJ_SMALL_INT_VALUE(lhs);
+        } else {
+            goto generic;
+        }
+        if (mp_obj_is_float(rhs)) {
+            rhs_val = mp_obj_float_get(rhs);
+        } else if (MP_OBJ_IS_SMALL_INT(rhs)) {
+            rhs_val = (mp_float_t)MP_OBJ_SMALL_INT_VALUE(rhs);
+        } else {
+            goto generic;
+        }
+        switch (op) {
+            case MP_BINARY_OP_ADD:
+            case MP_BINARY_OP_INPLACE_ADD: return mp_obj_new_float(lhs_val + rhs_val);
+            case MP_BINARY_OP_SUBTRACT:
+            case MP_BINARY_OP_INPLACE_SUBTRACT: return mp_obj_new_float(lhs_val - rhs_val);
+            case MP_BINARY_OP_MULTIPLY:
+            case MP_BINARY_OP_INPLACE_MULTIPLY: return mp_obj_new_float(lhs_val * rhs_val);
+            case MP_BINARY_OP_TRUE_DIVIDE:
+            case MP_BINARY_OP_INPLACE_TRUE_DIVIDE:
+                if (rhs_val == 0) {
+                    goto generic;
+                }
+                return mp_obj_new_float(lhs_val / rhs_val);
+            case MP_BINARY_OP_LESS: return mp_obj_new_bool(lhs_val < rhs_val);
+            case MP_BINARY_OP_MORE: return mp_obj_new_bool(lhs_val > rhs_val);
+            case MP_BINARY_OP_LESS_EQUAL: return mp_obj_new_bool(lhs_val <= rhs_val);
+            case MP_BINARY_OP_MORE_EQUAL: return mp_obj_new_bool(lhs_val >= rhs_val);
+            default: break;
+        }
+    }
+    #endif
+
+generic:
+    return mp_binary_op(op, lhs, rhs);
+}
+#else
+#define vm_binary_op mp_binary_op
+#endif
+
 // fastn has items in reverse order (fastn[0] is local[0], fastn[-1] is local[1], etc)
 // sp points to bottom of stack which grows up
 // returns:
@@ -151,6 +250,9 @@ mp_vm_return_kind_t mp_execute_bytecode(mp_code_state_t *code_state, volatile mp
 #if MICROPY_STACKLESS
 run_code_state: ;
 #endif
+    #if MICROPY_TRACK_CODE_STATE
+    MP_STATE_THREAD(current_code_state) = code_state;
+    #endif
     // Pointers which are constant for particular invocation of mp_execute_bytecode()
     mp_obj_t * /*const*/ fastn;
     mp_exc_stack_t * /*const*/ exc_stack;
@@ -1231,6 +1333,67 @@ yield:
                     mp_import_all(POP());
                     DISPATCH();
 
+                #if MICROPY_OPT_SUPERINSTRUCTIONS
+                ENTRY(MP_BC_LOAD_FAST_LOAD_FAST): {
+                    obj_shared = fastn[-(mp_int_t)(ip[0] & 0x0f)];
+                    if (obj_shared == MP_OBJ_NULL) {
+                        goto local_name_error;
+                    }
+                    PUSH(obj_shared);
+                    obj_shared = fastn[-(mp_int_t)(ip[0] >> 4)];
+                    ip += 1;
+                    goto load_check;
+                }
+
+                ENTRY(MP_BC_BINARY_OP_FAST_IMM): {
+                    MARK_EXC_IP_SELECTIVE();
+                    mp_obj_t lhs = fastn[-(mp_int_t)ip[0]];
+                    if (lhs == MP_OBJ_NULL) {
+                        goto local_name_error;
+                    }
+                    PUSH(vm_binary_op(ip[1], lhs, MP_OBJ_NEW_SMALL_INT((int8_t)ip[2])));
+                    ip += 3;
+                    DISPATCH();
+                }
+
+                ENTRY(MP_BC_BINARY_OP_FAST_IMM_STORE): {
+                    MARK_EXC_IP_SELECTIVE();
+                    mp_obj_t lhs = fastn[-(mp_int_t)ip[0]];
+                    if (lhs == MP_OBJ_NULL) {
+                        goto local_name_error;
+                    }
+                    fastn[-(mp_int_t)ip[3]] = vm_binary_op(ip[1], lhs, MP_OBJ_NEW_SMALL_INT((int8_t)ip[2]));
+                    ip += 4;
+                    DISPATCH();
+                }
+
+                ENTRY(MP_BC_BINARY_OP_POP_JUMP_IF_FALSE): {
+                    MARK_EXC_IP_SELECTIVE();
+                    DECODE_SLABEL;
+                    mp_obj_t rhs = POP();
+                    mp_obj_t lhs = POP();
+                    if (!mp_obj_is_true(vm_binary_op(ip[0], lhs, rhs))) {
+                        ip += slab;
+                    } else {
+                        ip += 1;
+                    }
+                    DISPATCH_WITH_PEND_EXC_CHECK();
+                }
+
+                ENTRY(MP_BC_BINARY_OP_POP_JUMP_IF_TRUE): {
+                    MARK_EXC_IP_SELECTIVE();
+                    DECODE_SLABEL;
+                    mp_obj_t rhs = POP();
+                    mp_obj_t lhs = POP();
+                    if (mp_obj_is_true(vm_binary_op(ip[0], lhs, rhs))) {
+                        ip += slab;
+                    } else {
+                        ip += 1;
+                    }
+                    DISPATCH_WITH_PEND_EXC_CHECK();
+                }
+                #endif
+
 #if MICROPY_OPT_COMPUTED_GOTO
                 ENTRY(MP_BC_LOAD_CONST_SMALL_INT_MULTI):
                     PUSH(MP_OBJ_NEW_SMALL_INT((mp_int_t)ip[-1] - MP_BC_LOAD_CONST_SMALL_INT_MULTI - 16));
@@ -1253,7 +1416,7 @@ yield:
                     MARK_EXC_IP_SELECTIVE();
                     mp_obj_t rhs = POP();
                     mp_obj_t lhs = TOP();
-                    SET_TOP(mp_binary_op(ip[-1] - MP_BC_BINARY_OP_MULTI, lhs, rhs));
+                    SET_TOP(vm_binary_op(ip[-1] - MP_BC_BINARY_OP_MULTI, lhs, rhs));
                     DISPATCH();
                 }
 
@@ -1276,7 +1439,7 @@ yield:
                     } else if (ip[-1] < MP_BC_BINARY_OP_MULTI + MP_BINARY_OP_NUM_BYTECODE) {
                         mp_obj_t rhs = POP();
                         mp_obj_t lhs = TOP();
-                        SET_TOP(mp_binary_op(ip[-1] - MP_BC_BINARY_OP_MULTI, lhs, rhs));
+                        SET_TOP(vm_binary_op(ip[-1] - MP_BC_BINARY_OP_MULTI, lhs, rhs));
                         DISPATCH();
                     } else
 #endif
@@ -1345,6 +1508,11 @@ pending_exception_check:
 exception_handler:
             // exception occurred
 
+            #if MICROPY_TRACK_CODE_STATE
+            // an async exception may have jumped here out of nested bytecode
+            MP_STATE_THREAD(current_code_state) = code_state;
+            #endif
+
             #if MICROPY_PY_SYS_EXC_INFO
             MP_STATE_VM(cur_exception) = nlr.ret_val;
             #endif
@@ -1381,50 +1549,9 @@ unwind_loop:
             // TODO: don't set traceback for exceptions re-raised by END_FINALLY.
             // But consider how to handle nested exceptions.
             if (nlr.ret_val != &mp_const_GeneratorExit_obj) {
-                const byte *ip = code_state->fun_bc->bytecode;
-                ip = mp_decode_uint_skip(ip); // skip n_state
-                ip = mp_decode_uint_skip(ip); // skip n_exc_stack
-                ip++; // skip scope_params
-                ip++; // skip n_pos_args
-                ip++; // skip n_kwonly_args
-                ip++; // skip n_def_pos_args
-                size_t bc = code_state->ip - ip;
-                size_t code_info_size = mp_decode_uint_value(ip);
-                ip = mp_decode_uint_skip(ip); // skip code_info_size
-                bc -= code_info_size;
-                #if MICROPY_PERSISTENT_CODE
-                qstr block_name = ip[0] | (ip[1] << 8);
-                qstr source_file = ip[2] | (ip[3] << 8);
-                ip += 4;
-                #else
-                qstr block_name = mp_decode_uint_value(ip);
-                ip = mp_decode_uint_skip(ip);
-                qstr source_file = mp_decode_uint_value(ip);
-                ip = mp_decode_uint_skip(ip);
-                #endif
-                size_t source_line = 1;
-                size_t c;
-                while ((c = *ip)) {
-                    size_t b, l;
-                    if ((c & 0x80) == 0) {
-                        // 0b0LLBBBBB encoding
-                        b = c & 0x1f;
-                        l = c >> 5;
-                        ip += 1;
-                    } else {
-                        // 0b1LLLBBBB 0bLLLLLLLL encoding (l's LSB in second byte)
-                        b = c & 0xf;
-                        l = ((c << 4) & 0x700) | ip[1];
-                        ip += 2;
-                    }
-                    if (bc >= b) {
-                        bc -= b;
-                        source_line += l;
-                    } else {
-                        // found source line corresponding to bytecode offset
-                        break;
-                    }
-                }
+                qstr block_name;
+                qstr source_file;
+                size_t source_line = mp_bytecode_get_source_line(code_state->fun_bc->bytecode, code_state->ip, &block_name, &source_file);
                 mp_obj_exception_add_traceback(MP_OBJ_FROM_PTR(nlr.ret_val), source_file, source_line, block_name);
             }
 
@@ -1465,6 +1592,9 @@ unwind_loop:
                 mp_nonlocal_free(code_state, sizeof(mp_code_state_t));
                 #endif
                 code_state = new_code_state;
+                #if MICROPY_TRACK_CODE_STATE
+                MP_STATE_THREAD(current_code_state) = code_state;
+                #endif
                 size_t n_state = mp_decode_uint_value(code_state->fun_bc->bytecode);
                 fastn = &code_state->state[n_state - 1];
                 exc_stack = (mp_exc_stack_t*)(code_state->state + n_state);
@@ -106,6 +106,13 @@ static const void *const entry_table[256] = {
     [MP_BC_IMPORT_NAME] = &&entry_MP_BC_IMPORT_NAME,
     [MP_BC_IMPORT_FROM] = &&entry_MP_BC_IMPORT_FROM,
     [MP_BC_IMPORT_STAR] = &&entry_MP_BC_IMPORT_STAR,
+    #if MICROPY_OPT_SUPERINSTRUCTIONS
+    [MP_BC_LOAD_FAST_LOAD_FAST] = &&entry_MP_BC_LOAD_FAST_LOAD_FAST,
+    [MP_BC_BINARY_OP_FAST_IMM] = &&entry_MP_BC_BINARY_OP_FAST_IMM,
+    [MP_BC_BINARY_OP_FAST_IMM_STORE] = &&entry_MP_BC_BINARY_OP_FAST_IMM_STORE,
+    [MP_BC_BINARY_OP_POP_JUMP_IF_FALSE] = &&entry_MP_BC_BINARY_OP_POP_JUMP_IF_FALSE,
+    [MP_BC_BINARY_OP_POP_JUMP_IF_TRUE] = &&entry_MP_BC_BINARY_OP_POP_JUMP_IF_TRUE,
+    #endif
     [MP_BC_LOAD_CONST_SMALL_INT_MULTI ... MP_BC_LOAD_CONST_SMALL_INT_MULTI + 63] = &&entry_MP_BC_LOAD_CONST_SMALL_INT_MULTI,
     [MP_BC_LOAD_FAST_MULTI ... MP_BC_LOAD_FAST_MULTI + 15] = &&entry_MP_BC_LOAD_FAST_MULTI,
     [MP_BC_STORE_FAST_MULTI ... MP_BC_STORE_FAST_MULTI + 15] = &&entry_MP_BC_STORE_FAST_MULTI,
@@ -62,6 +62,7 @@ STATIC mp_obj_t scanresults_iternext(mp_obj_t self_in) {
 //|
 //|     Returns the next `_bleio.ScanEntry`. Blocks if none have been received and scanning is still
 //|     active. Raises `StopIteration` if scanning is finished and no other results are available.
+//|     When the scan was started with ``reuse_entry=True`` the same object is returned each time.
 //|
 
 const mp_obj_type_t bleio_scanresults_type = {
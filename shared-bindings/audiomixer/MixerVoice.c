@@ -50,6 +50,10 @@
 //|
 // TODO: support mono or stereo voices
 STATIC mp_obj_t audiomixer_mixervoice_make_new(const mp_obj_type_t *type, size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    (void)type;
+    (void)n_args;
+    (void)pos_args;
+    (void)kw_args;
     audiomixer_mixervoice_obj_t *self = m_new_obj(audiomixer_mixervoice_obj_t);
     self->base.type = &audiomixer_mixervoice_type;
 
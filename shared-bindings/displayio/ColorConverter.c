@@ -52,6 +52,7 @@
 // TODO(tannewt): Add support for other color formats.
 //|
 STATIC mp_obj_t displayio_colorconverter_make_new(const mp_obj_type_t *type, size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    (void)type;
     enum { ARG_dither};
 
     static const mp_arg_t allowed_args[] = {
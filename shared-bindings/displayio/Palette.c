@@ -53,6 +53,7 @@
 // TODO(tannewt): Add support for 8-bit alpha blending.
 //|
 STATIC mp_obj_t displayio_palette_make_new(const mp_obj_type_t *type, size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    (void)type;
     enum { ARG_color_count };
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_color_count, MP_ARG_REQUIRED | MP_ARG_INT },
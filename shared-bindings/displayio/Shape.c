@@ -52,6 +52,7 @@
 //|   :param bool mirror_y: When true the top boundary is mirrored to the bottom.
 //|
 STATIC mp_obj_t displayio_shape_make_new(const mp_obj_type_t *type, size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    (void)type;
     enum { ARG_width, ARG_height, ARG_mirror_x, ARG_mirror_y };
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_width, MP_ARG_REQUIRED | MP_ARG_INT },
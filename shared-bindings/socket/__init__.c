@@ -240,6 +240,46 @@ STATIC mp_obj_t socket_send(mp_obj_t self_in, mp_obj_t buf_in) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_2(socket_send_obj, socket_send);
 
+//| .. method:: sendall(bytes)
+//|
+//|   Send all of the given bytes to the connected remote address,
+//|   blocking until the NIC has accepted every byte.
+//|   Suits sockets of type SOCK_STREAM
+//|
+//|   The data is handed to the NIC straight from the given buffer, so a
+//|   large payload can be streamed from a memoryview without copying it.
+//|
+//|   :param ~bytes bytes: some bytes to send
+//|
+
+STATIC mp_obj_t socket_sendall(mp_obj_t self_in, mp_obj_t buf_in) {
+    mod_network_socket_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->nic == MP_OBJ_NULL) {
+        // not connected
+        mp_raise_OSError(MP_EPIPE);
+    }
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_READ);
+    const byte *buf = bufinfo.buf;
+    mp_uint_t len = bufinfo.len;
+    while (len > 0) {
+        int _errno;
+        mp_int_t ret = self->nic_type->send(self, buf, len, &_errno);
+        if (ret == -1) {
+            mp_raise_OSError(_errno);
+        }
+        buf += ret;
+        len -= ret;
+        if (len > 0) {
+            // the NIC's transmit buffer is full; let other work run while it drains
+            RUN_BACKGROUND_TASKS;
+            mp_handle_pending();
+        }
+    }
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(socket_sendall_obj, socket_sendall);
+
 
 // helper function for socket_recv and socket_recv_into to handle common operations of both
 STATIC mp_int_t _socket_recv_into(mod_network_socket_obj_t *sock, byte *buf, mp_int_t len) {
@@ -476,6 +516,7 @@ STATIC const mp_rom_map_elem_t socket_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_accept), MP_ROM_PTR(&socket_accept_obj) },
     { MP_ROM_QSTR(MP_QSTR_connect), MP_ROM_PTR(&socket_connect_obj) },
     { MP_ROM_QSTR(MP_QSTR_send), MP_ROM_PTR(&socket_send_obj) },
+    { MP_ROM_QSTR(MP_QSTR_sendall), MP_ROM_PTR(&socket_sendall_obj) },
     { MP_ROM_QSTR(MP_QSTR_recv), MP_ROM_PTR(&socket_recv_obj) },
     { MP_ROM_QSTR(MP_QSTR_sendto), MP_ROM_PTR(&socket_sendto_obj) },
     { MP_ROM_QSTR(MP_QSTR_recvfrom), MP_ROM_PTR(&socket_recvfrom_obj) },
@@ -483,10 +524,43 @@ STATIC const mp_rom_map_elem_t socket_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_setsockopt), MP_ROM_PTR(&socket_setsockopt_obj) },
     { MP_ROM_QSTR(MP_QSTR_settimeout), MP_ROM_PTR(&socket_settimeout_obj) },
     { MP_ROM_QSTR(MP_QSTR_setblocking), MP_ROM_PTR(&socket_setblocking_obj) },
+
+    { MP_ROM_QSTR(MP_QSTR_read), MP_ROM_PTR(&mp_stream_read_obj) },
+    { MP_ROM_QSTR(MP_QSTR_readinto), MP_ROM_PTR(&mp_stream_readinto_obj) },
+    { MP_ROM_QSTR(MP_QSTR_readline), MP_ROM_PTR(&mp_stream_unbuffered_readline_obj) },
+    { MP_ROM_QSTR(MP_QSTR_write), MP_ROM_PTR(&mp_stream_write_obj) },
 };
 
 STATIC MP_DEFINE_CONST_DICT(socket_locals_dict, socket_locals_dict_table);
 
+// The stream read/write paths hand the caller's buffer straight to the NIC,
+// so readinto() and write() of a memoryview never allocate.
+STATIC mp_uint_t socket_read(mp_obj_t self_in, void *buf, mp_uint_t size, int *errcode) {
+    mod_network_socket_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->nic == MP_OBJ_NULL) {
+        *errcode = MP_ENOTCONN;
+        return MP_STREAM_ERROR;
+    }
+    mp_int_t ret = self->nic_type->recv(self, buf, size, errcode);
+    if (ret == -1) {
+        return MP_STREAM_ERROR;
+    }
+    return ret;
+}
+
+STATIC mp_uint_t socket_write(mp_obj_t self_in, const void *buf, mp_uint_t size, int *errcode) {
+    mod_network_socket_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->nic == MP_OBJ_NULL) {
+        *errcode = MP_EPIPE;
+        return MP_STREAM_ERROR;
+    }
+    mp_int_t ret = self->nic_type->send(self, buf, size, errcode);
+    if (ret == -1) {
+        return MP_STREAM_ERROR;
+    }
+    return ret;
+}
+
 mp_uint_t socket_ioctl(mp_obj_t self_in, mp_uint_t request, uintptr_t arg, int *errcode) {
     mod_network_socket_obj_t *self = MP_OBJ_TO_PTR(self_in);
     if (request == MP_STREAM_CLOSE) {
@@ -501,6 +575,8 @@ mp_uint_t socket_ioctl(mp_obj_t self_in, mp_uint_t request, uintptr_t arg, int *
 
 STATIC const mp_stream_p_t socket_stream_p = {
     MP_PROTO_IMPLEMENT(MP_QSTR_protocol_stream)
+    .read = socket_read,
+    .write = socket_write,
     .ioctl = socket_ioctl,
     .is_text = false,
 };
@@ -29,6 +29,7 @@
 
 #include "lib/utils/interrupt_char.h"
 #include "supervisor/shared/autoreload.h"
+#include "supervisor/shared/background_profile.h"
 #include "supervisor/shared/rgb_led_status.h"
 #include "supervisor/shared/stack.h"
 #include "supervisor/shared/translate.h"
@@ -124,6 +125,31 @@ STATIC mp_obj_t supervisor_set_next_stack_limit(mp_obj_t size_obj) {
 }
 MP_DEFINE_CONST_FUN_OBJ_1(supervisor_set_next_stack_limit_obj, supervisor_set_next_stack_limit);
 
+#if CIRCUITPY_BACKGROUND_PROFILE
+//| .. method:: background_stats()
+//|
+//|   Return a dict describing the work done between lines of Python code. Each key names a
+//|   background task (``"all"`` is the whole background pass) and each value is a tuple of
+//|   ``(calls, total_us, max_us, max_gap_us)``: how many times it ran, for how long in total, its
+//|   longest single run and the longest time from one run starting to the next one starting.
+//|   Only tasks that have run since `reset_background_stats` are included.
+//|
+STATIC mp_obj_t supervisor_background_stats(void) {
+    return background_profile_stats();
+}
+MP_DEFINE_CONST_FUN_OBJ_0(supervisor_background_stats_obj, supervisor_background_stats);
+
+//| .. method:: reset_background_stats()
+//|
+//|   Clear the statistics returned by `background_stats`.
+//|
+STATIC mp_obj_t supervisor_reset_background_stats(void) {
+    background_profile_reset();
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_0(supervisor_reset_background_stats_obj, supervisor_reset_background_stats);
+#endif
+
 STATIC const mp_rom_map_elem_t supervisor_module_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_supervisor) },
     { MP_OBJ_NEW_QSTR(MP_QSTR_enable_autoreload),  MP_ROM_PTR(&supervisor_enable_autoreload_obj) },
@@ -132,6 +158,10 @@ STATIC const mp_rom_map_elem_t supervisor_module_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_runtime),  MP_ROM_PTR(&common_hal_supervisor_runtime_obj) },
     { MP_ROM_QSTR(MP_QSTR_reload),  MP_ROM_PTR(&supervisor_reload_obj) },
     { MP_ROM_QSTR(MP_QSTR_set_next_stack_limit),  MP_ROM_PTR(&supervisor_set_next_stack_limit_obj) },
+    #if CIRCUITPY_BACKGROUND_PROFILE
+    { MP_ROM_QSTR(MP_QSTR_background_stats),  MP_ROM_PTR(&supervisor_background_stats_obj) },
+    { MP_ROM_QSTR(MP_QSTR_reset_background_stats),  MP_ROM_PTR(&supervisor_reset_background_stats_obj) },
+    #endif
 
 };
 
@@ -51,7 +51,7 @@
 //| :class:`WIZNET5K` -- wrapper for Wiznet 5500 Ethernet interface
 //| ===============================================================
 //|
-//| .. class:: WIZNET5K(spi, cs, rst, dhcp=True)
+//| .. class:: WIZNET5K(spi, cs, rst, dhcp=True, int=None)
 //|
 //|   Create a new WIZNET5500 interface using the specified pins
 //|
@@ -59,29 +59,36 @@
 //|   :param ~microcontroller.Pin cs: pin to use for Chip Select
 //|   :param ~microcontroller.Pin rst: pin to use for Reset (optional)
 //|   :param bool dhcp: boolean flag, whether to start DHCP automatically (optional, keyword only, default True)
+//|   :param ~microcontroller.Pin int: pin wired to the chip's INTn output (optional, keyword only)
 //|
 //|   * The reset pin is optional: if supplied it is used to reset the
 //|     wiznet board before initialization.
 //|   * The SPI bus will be initialized appropriately by this library.
+//|   * If the interrupt pin is supplied, socket readiness for ``select``
+//|     and blocking calls is driven by it; otherwise the chip is polled
+//|     at an interval that shortens while sockets are busy.
 //|   * At present, the WIZNET5K object is a singleton, so only one WizNet
 //|     interface is supported at a time.
 //|
 
 STATIC mp_obj_t wiznet5k_make_new(const mp_obj_type_t *type, size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
-    enum { ARG_spi, ARG_cs, ARG_rst, ARG_dhcp };
+    enum { ARG_spi, ARG_cs, ARG_rst, ARG_dhcp, ARG_int };
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_spi, MP_ARG_REQUIRED | MP_ARG_OBJ },
         { MP_QSTR_cs, MP_ARG_REQUIRED | MP_ARG_OBJ },
         { MP_QSTR_rst, MP_ARG_OBJ, { .u_obj = mp_const_none } },
         { MP_QSTR_dhcp, MP_ARG_KW_ONLY | MP_ARG_BOOL, { .u_bool = true } },
+        { MP_QSTR_int, MP_ARG_KW_ONLY | MP_ARG_OBJ, { .u_obj = mp_const_none } },
     };
     mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
     mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
     // TODO check type of ARG_spi?
     assert_pin(args[ARG_cs].u_obj, false);
     assert_pin(args[ARG_rst].u_obj, true); // may be NULL
+    assert_pin(args[ARG_int].u_obj, true);
+    mp_obj_t int_in = args[ARG_int].u_obj == mp_const_none ? MP_OBJ_NULL : args[ARG_int].u_obj;
 
-    mp_obj_t ret = wiznet5k_create(args[ARG_spi].u_obj, args[ARG_cs].u_obj, args[ARG_rst].u_obj);
+    mp_obj_t ret = wiznet5k_create(args[ARG_spi].u_obj, args[ARG_cs].u_obj, args[ARG_rst].u_obj, int_in);
     if (args[ARG_dhcp].u_bool) wiznet5k_start_dhcp();
     return ret;
 }
@@ -204,6 +211,7 @@ const mod_network_nic_type_t mod_network_nic_type_wiznet5k = {
     .settimeout = wiznet5k_socket_settimeout,
     .ioctl = wiznet5k_socket_ioctl,
     .timer_tick = wiznet5k_socket_timer_tick,
+    .poll = wiznet5k_poll,
     .deinit = wiznet5k_socket_deinit,
 };
 
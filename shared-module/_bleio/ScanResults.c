@@ -34,13 +34,22 @@
 #include "shared-bindings/_bleio/ScanEntry.h"
 #include "shared-bindings/_bleio/ScanResults.h"
 
-bleio_scanresults_obj_t* shared_module_bleio_new_scanresults(size_t buffer_size, uint8_t* prefixes, size_t prefixes_len, mp_int_t minimum_rssi) {
+// Byte offsets of the fields within a packet in the ring.
+#define PACKET_TICKS_OFFSET (1)
+#define PACKET_RSSI_OFFSET (PACKET_TICKS_OFFSET + sizeof(uint64_t))
+#define PACKET_DATA_OFFSET (PACKET_RSSI_OFFSET + 1 + NUM_BLEIO_ADDRESS_BYTES + 1 + sizeof(uint16_t))
+
+bleio_scanresults_obj_t* shared_module_bleio_new_scanresults(size_t buffer_size, uint8_t* prefixes, size_t prefixes_len, mp_int_t minimum_rssi, bool dedup, bool reuse_entry) {
     bleio_scanresults_obj_t* self = m_new_obj(bleio_scanresults_obj_t);
     self->base.type = &bleio_scanresults_type;
     ringbuf_alloc(&self->buf, buffer_size, false);
     self->prefixes = prefixes;
     self->prefix_length = prefixes_len;
     self->minimum_rssi = minimum_rssi;
+    if (dedup) {
+        self->dedup = m_new0(bleio_scanresults_dedup_slot_t, BLEIO_SCANRESULTS_DEDUP_SLOTS);
+    }
+    self->reuse_entry = reuse_entry;
     return self;
 }
 
@@ -52,11 +61,14 @@ mp_obj_t common_hal_bleio_scanresults_next(bleio_scanresults_obj_t *self) {
         return mp_const_none;
     }
 
+    // Stop the producer from merging into the packet we're about to read.
+    self->claimed = self->buf.iget + 1;
+
     // Create a ScanEntry out of the data on the buffer.
     uint8_t type = ringbuf_get(&self->buf);
     bool connectable = (type & (1 << 0)) != 0;
     bool scan_response = (type & (1 << 1)) != 0;
-    uint64_t ticks_ms; 
+    uint64_t ticks_ms;
     ringbuf_get_n(&self->buf, (uint8_t*) &ticks_ms, sizeof(ticks_ms));
     uint8_t rssi = ringbuf_get(&self->buf);
     uint8_t peer_addr[NUM_BLEIO_ADDRESS_BYTES];
@@ -65,26 +77,97 @@ mp_obj_t common_hal_bleio_scanresults_next(bleio_scanresults_obj_t *self) {
     uint16_t len;
     ringbuf_get_n(&self->buf, (uint8_t*) &len, sizeof(len));
 
-    mp_obj_str_t *o = MP_OBJ_TO_PTR(mp_obj_new_bytes_of_zeros(len));
-    ringbuf_get_n(&self->buf, (uint8_t*) o->data, len);
+    bleio_scanentry_obj_t *entry = self->entry;
+    if (entry == NULL) {
+        entry = m_new_obj(bleio_scanentry_obj_t);
+        entry->base.type = &bleio_scanentry_type;
+        entry->address = NULL;
+        entry->data = NULL;
+    }
 
-    bleio_scanentry_obj_t *entry = m_new_obj(bleio_scanentry_obj_t);
-    entry->base.type = &bleio_scanentry_type;
-    entry->rssi = rssi;
+    // A reused entry keeps its bytes object unless this payload doesn't fit in it.
+    if (entry->data == NULL || len > self->entry_data_alloc) {
+        entry->data = MP_OBJ_TO_PTR(mp_obj_new_bytes_of_zeros(len));
+        self->entry_data_alloc = len;
+    }
+    mp_obj_str_t *o = entry->data;
+    ringbuf_get_n(&self->buf, (uint8_t*) o->data, len);
+    ((byte*) o->data)[len] = '\0';
+    o->len = len;
+    o->hash = qstr_compute_hash(o->data, len);
 
-    bleio_address_obj_t *address = m_new_obj(bleio_address_obj_t);
-    address->base.type = &bleio_address_type;
-    common_hal_bleio_address_construct(MP_OBJ_TO_PTR(address), peer_addr, addr_type);
-    entry->address = address;
+    if (entry->address != NULL) {
+        mp_obj_str_t *address_bytes = MP_OBJ_TO_PTR(entry->address->bytes);
+        memcpy((byte*) address_bytes->data, peer_addr, sizeof(peer_addr));
+        address_bytes->hash = qstr_compute_hash(address_bytes->data, sizeof(peer_addr));
+        entry->address->type = addr_type;
+    } else {
+        bleio_address_obj_t *address = m_new_obj(bleio_address_obj_t);
+        address->base.type = &bleio_address_type;
+        common_hal_bleio_address_construct(MP_OBJ_TO_PTR(address), peer_addr, addr_type);
+        entry->address = address;
+    }
 
-    entry->data = o;
+    entry->rssi = rssi;
     entry->time_received = ticks_ms;
     entry->connectable = connectable;
     entry->scan_response = scan_response;
-    
+
+    if (self->reuse_entry) {
+        self->entry = entry;
+    }
+
     return MP_OBJ_FROM_PTR(entry);
 }
 
+// 32-bit FNV-1a, continuing from hash. qstr hashes can be as narrow as 8 bits, which would make
+// different payloads share a slot far too often.
+STATIC uint32_t scanresults_hash(uint32_t hash, const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ data[i]) * 16777619;
+    }
+    return hash;
+}
+
+// Whether the len bytes at position pos in the ring match data.
+STATIC bool scanresults_ring_equal(ringbuf_t *r, uint32_t pos, const uint8_t *data, size_t len) {
+    size_t first = MIN(len, r->size - pos);
+    return memcmp(r->buf + pos, data, first) == 0 &&
+        memcmp(r->buf, data + first, len - first) == 0;
+}
+
+// Find the slot for this address and payload. If it describes a packet that is still waiting in
+// the ring, and not being read, update that packet's RSSI and timestamp in place and return NULL.
+// Otherwise return the slot so the new packet can be recorded in it.
+STATIC bleio_scanresults_dedup_slot_t* scanresults_merge(bleio_scanresults_obj_t* self,
+                                                         uint64_t ticks_ms,
+                                                         uint8_t type,
+                                                         int8_t rssi,
+                                                         uint8_t *peer_addr,
+                                                         uint8_t addr_type,
+                                                         uint8_t *data,
+                                                         uint32_t payload_hash,
+                                                         uint16_t len) {
+    uint32_t key = scanresults_hash(payload_hash, peer_addr, NUM_BLEIO_ADDRESS_BYTES);
+    bleio_scanresults_dedup_slot_t *slot = &self->dedup[key & (BLEIO_SCANRESULTS_DEDUP_SLOTS - 1)];
+
+    ringbuf_t *r = &self->buf;
+    if (slot->used &&
+        slot->payload_hash == payload_hash &&
+        slot->len == len &&
+        slot->type == type &&
+        slot->addr_type == addr_type &&
+        memcmp(slot->addr, peer_addr, NUM_BLEIO_ADDRESS_BYTES) == 0 &&
+        (int32_t) (slot->start - self->claimed) >= 0 &&
+        scanresults_ring_equal(r, ringbuf_offset(r, slot->pos, PACKET_DATA_OFFSET), data, len)) {
+        for (size_t i = 0; i < sizeof(ticks_ms); i++) {
+            r->buf[ringbuf_offset(r, slot->pos, PACKET_TICKS_OFFSET + i)] = ((uint8_t*) &ticks_ms)[i];
+        }
+        r->buf[ringbuf_offset(r, slot->pos, PACKET_RSSI_OFFSET)] = rssi;
+        return NULL;
+    }
+    return slot;
+}
 
 void shared_module_bleio_scanresults_append(bleio_scanresults_obj_t* self,
                                             uint64_t ticks_ms,
@@ -95,13 +178,6 @@ void shared_module_bleio_scanresults_append(bleio_scanresults_obj_t* self,
                                             uint8_t addr_type,
                                             uint8_t *data,
                                             uint16_t len) {
-    int32_t packet_size = sizeof(uint8_t) + sizeof(ticks_ms) + sizeof(rssi) + NUM_BLEIO_ADDRESS_BYTES +
-        sizeof(addr_type) + sizeof(len) + len;
-    int32_t empty_space = self->buf.size - ringbuf_count(&self->buf);
-    if (packet_size >= empty_space) {
-        // We can't fit the packet so skip it.
-        return;
-    }
     // Filter the packet.
     if (rssi < self->minimum_rssi) {
         return;
@@ -119,6 +195,36 @@ void shared_module_bleio_scanresults_append(bleio_scanresults_obj_t* self,
         type |= 1 << 1;
     }
 
+    // Repeats are merged before the space check so they still land when the ring is full.
+    bleio_scanresults_dedup_slot_t *slot = NULL;
+    uint32_t payload_hash = 0;
+    if (self->dedup != NULL) {
+        payload_hash = scanresults_hash(2166136261, data, len);
+        slot = scanresults_merge(self, ticks_ms, type, rssi, peer_addr, addr_type, data, payload_hash, len);
+        if (slot == NULL) {
+            return;
+        }
+    }
+
+    int32_t packet_size = sizeof(uint8_t) + sizeof(ticks_ms) + sizeof(rssi) + NUM_BLEIO_ADDRESS_BYTES +
+        sizeof(addr_type) + sizeof(len) + len;
+    int32_t empty_space = ringbuf_free(&self->buf);
+    if (packet_size >= empty_space) {
+        // We can't fit the packet so skip it.
+        return;
+    }
+
+    if (slot != NULL) {
+        slot->used = true;
+        slot->payload_hash = payload_hash;
+        slot->start = self->buf.iput;
+        slot->pos = self->buf.put_pos;
+        slot->len = len;
+        slot->type = type;
+        slot->addr_type = addr_type;
+        memcpy(slot->addr, peer_addr, NUM_BLEIO_ADDRESS_BYTES);
+    }
+
     // Add the packet to the buffer.
     ringbuf_put(&self->buf, type);
     ringbuf_put_n(&self->buf, (uint8_t*) &ticks_ms, sizeof(ticks_ms));
@@ -32,6 +32,28 @@
 
 #include "py/obj.h"
 #include "py/ringbuf.h"
+#include "shared-module/_bleio/Address.h"
+#include "shared-module/_bleio/ScanEntry.h"
+
+// Number of slots in the table used to merge repeated advertisements. Must be a power of two.
+#ifndef BLEIO_SCANRESULTS_DEDUP_SLOTS
+#define BLEIO_SCANRESULTS_DEDUP_SLOTS (16)
+#endif
+
+// Remembers where the most recent packet with a given address and payload sits in the ring so
+// that repeats can update it in place instead of being appended again.
+typedef struct {
+    uint32_t payload_hash;
+    // Ring index (iput at the time it was added) of the start of the packet.
+    uint32_t start;
+    // Where the start of the packet is in the ring's buffer.
+    uint32_t pos;
+    uint16_t len;
+    uint8_t type;
+    uint8_t addr_type;
+    uint8_t addr[NUM_BLEIO_ADDRESS_BYTES];
+    bool used;
+} bleio_scanresults_dedup_slot_t;
 
 typedef struct {
     mp_obj_base_t base;
@@ -42,11 +64,20 @@ typedef struct {
     uint8_t* prefixes;
     size_t prefix_length;
     mp_int_t minimum_rssi;
+    // NULL unless repeated packets are merged.
+    bleio_scanresults_dedup_slot_t* dedup;
+    // Ring index just past the start of the packet being read. Packets starting before it
+    // belong to the reader and are no longer merged into.
+    volatile uint32_t claimed;
+    // The entry handed out again by every iteration when reuse_entry is set.
+    bleio_scanentry_obj_t* entry;
+    size_t entry_data_alloc;
+    bool reuse_entry;
     bool active;
     bool done;
 } bleio_scanresults_obj_t;
 
-bleio_scanresults_obj_t* shared_module_bleio_new_scanresults(size_t buffer_size, uint8_t* prefixes, size_t prefixes_len, mp_int_t minimum_rssi);
+bleio_scanresults_obj_t* shared_module_bleio_new_scanresults(size_t buffer_size, uint8_t* prefixes, size_t prefixes_len, mp_int_t minimum_rssi, bool dedup, bool reuse_entry);
 
 bool shared_module_bleio_scanresults_get_done(bleio_scanresults_obj_t* self);
 void shared_module_bleio_scanresults_set_done(bleio_scanresults_obj_t* self, bool done);
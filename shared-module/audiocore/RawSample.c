@@ -70,6 +70,9 @@ uint8_t common_hal_audioio_rawsample_get_channel_count(audioio_rawsample_obj_t*
 void audioio_rawsample_reset_buffer(audioio_rawsample_obj_t* self,
                                     bool single_channel,
                                     uint8_t channel) {
+    (void)self;
+    (void)single_channel;
+    (void)channel;
 }
 
 audioio_get_buffer_result_t audioio_rawsample_get_buffer(audioio_rawsample_obj_t* self,
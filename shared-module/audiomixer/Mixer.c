@@ -96,12 +96,14 @@ bool common_hal_audiomixer_mixer_get_playing(audiomixer_mixer_obj_t* self) {
 void audiomixer_mixer_reset_buffer(audiomixer_mixer_obj_t* self,
                                    bool single_channel,
                                    uint8_t channel) {
+    (void)single_channel;
+    (void)channel;
     for (uint8_t i = 0; i < self->voice_count; i++) {
         common_hal_audiomixer_mixervoice_stop(self->voice[i]);
     }
 }
 
-uint32_t add8signed(uint32_t a, uint32_t b) {
+STATIC uint32_t add8signed(uint32_t a, uint32_t b) {
     #if (defined (__ARM_ARCH_7EM__) && (__ARM_ARCH_7EM__ == 1)) //Cortex-M4 w/FPU
     return __SHADD8(a, b);
     #else
@@ -121,7 +123,7 @@ uint32_t add8signed(uint32_t a, uint32_t b) {
     #endif
 }
 
-uint32_t add8unsigned(uint32_t a, uint32_t b) {
+STATIC uint32_t add8unsigned(uint32_t a, uint32_t b) {
     #if (defined (__ARM_ARCH_7EM__) && (__ARM_ARCH_7EM__ == 1)) //Cortex-M4 w/FPU
     return __UHADD8(a, b);
     #else
@@ -139,7 +141,7 @@ uint32_t add8unsigned(uint32_t a, uint32_t b) {
     #endif
 }
 
-uint32_t add16signed(uint32_t a, uint32_t b) {
+STATIC uint32_t add16signed(uint32_t a, uint32_t b) {
     #if (defined (__ARM_ARCH_7EM__) && (__ARM_ARCH_7EM__ == 1)) //Cortex-M4 w/FPU
     return __SHADD16(a, b);
     #else
@@ -159,7 +161,7 @@ uint32_t add16signed(uint32_t a, uint32_t b) {
     #endif
 }
 
-uint32_t add16unsigned(uint32_t a, uint32_t b) {
+STATIC uint32_t add16unsigned(uint32_t a, uint32_t b) {
     #if (defined (__ARM_ARCH_7EM__) && (__ARM_ARCH_7EM__ == 1)) //Cortex-M4 w/FPU
     return __UHADD16(a, b);
     #else
@@ -134,9 +134,9 @@ void common_hal_displayio_bitmap_set_pixel(displayio_bitmap_t *self, int16_t x,
     if (bytes_per_value < 1) {
         uint32_t bit_position = (sizeof(size_t) * 8 - ((x & self->x_mask) + 1) * self->bits_per_value);
         uint32_t index = row_start + (x >> self->x_shift);
-        uint32_t word = self->data[index];
-        word &= ~(self->bitmask << bit_position);
-        word |= (value & self->bitmask) << bit_position;
+        size_t word = self->data[index];
+        word &= ~((size_t) self->bitmask << bit_position);
+        word |= (size_t) (value & self->bitmask) << bit_position;
         self->data[index] = word;
     } else {
         size_t* row = self->data + row_start;
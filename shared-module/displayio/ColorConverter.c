@@ -95,6 +95,7 @@ uint8_t displayio_colorconverter_compute_hue(uint32_t color_rgb888) {
 }
 
 void displayio_colorconverter_compute_tricolor(const _displayio_colorspace_t* colorspace, uint8_t pixel_hue, uint8_t pixel_luma, uint32_t*  color) {
+    (void)pixel_luma;
 
     int16_t hue_diff = colorspace->tricolor_hue - pixel_hue;
     if ((-10 <= hue_diff && hue_diff <= 10) || hue_diff <= -220 || hue_diff >= 220) {
@@ -185,9 +186,11 @@ void displayio_colorconverter_convert(displayio_colorconverter_t *self, const _d
 
 // Currently no refresh logic is needed for a ColorConverter.
 bool displayio_colorconverter_needs_refresh(displayio_colorconverter_t *self) {
+    (void)self;
     return false;
 }
 
 void displayio_colorconverter_finish_refresh(displayio_colorconverter_t *self) {
+    (void)self;
 }
 
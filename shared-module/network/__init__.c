@@ -56,13 +56,19 @@ void network_module_deinit(void) {
 void network_module_background(void) {
     static uint32_t next_tick = 0;
     uint32_t this_tick = supervisor_ticks_ms32();
-    if (this_tick < next_tick) return;
-    next_tick = this_tick + 1000;
+    // timer_tick drives once-a-second work such as DHCP lease timing
+    bool tick = (int32_t)(this_tick - next_tick) >= 0;
+    if (tick) {
+        next_tick = this_tick + 1000;
+    }
 
     for (mp_uint_t i = 0; i < MP_STATE_PORT(mod_network_nic_list).len; i++) {
         mp_obj_t nic = MP_STATE_PORT(mod_network_nic_list).items[i];
-        mod_network_nic_type_t *nic_type = (mod_network_nic_type_t*)mp_obj_get_type(nic); 
-        if (nic_type->timer_tick != NULL) nic_type->timer_tick(nic);
+        mod_network_nic_type_t *nic_type = (mod_network_nic_type_t*)mp_obj_get_type(nic);
+        // socket readiness is collected on every pass so that poll() and
+        // blocking calls see events without waiting for the next tick
+        if (nic_type->poll != NULL) nic_type->poll(nic);
+        if (tick && nic_type->timer_tick != NULL) nic_type->timer_tick(nic);
     }
 }
 
@@ -63,6 +63,8 @@ typedef struct _mod_network_nic_type_t {
     int (*settimeout)(struct _mod_network_socket_obj_t *socket, mp_uint_t timeout_ms, int *_errno);
     int (*ioctl)(struct _mod_network_socket_obj_t *socket, mp_uint_t request, mp_uint_t arg, int *_errno);
     void (*timer_tick)(struct _mod_network_socket_obj_t *socket);
+    // called on every background pass to collect socket events; may be NULL
+    void (*poll)(mp_obj_t nic);
     void (*deinit)(struct _mod_network_socket_obj_t *socket);
 } mod_network_nic_type_t;
 
@@ -28,10 +28,25 @@
 #include "supervisor/shared/translate.h"
 #include "tusb.h"
 
+// Moves everything TinyUSB has queued straight into free space in the ring.
+void usb_midi_portin_background(usb_midi_portin_obj_t *self) {
+    uint8_t *dest;
+    size_t space;
+    while ((space = ringbuf_put_peek(&self->ringbuf, &dest)) > 0) {
+        size_t n = tud_midi_read(dest, space);
+        if (n == 0) {
+            break;
+        }
+        ringbuf_put_commit(&self->ringbuf, n);
+    }
+}
+
 size_t common_hal_usb_midi_portin_read(usb_midi_portin_obj_t *self, uint8_t *data, size_t len, int *errcode) {
-    return tud_midi_read(data, len);
+    usb_midi_portin_background(self);
+    return ringbuf_get_n(&self->ringbuf, data, len);
 }
 
 uint32_t common_hal_usb_midi_portin_bytes_available(usb_midi_portin_obj_t *self) {
-    return tud_midi_available();
+    usb_midi_portin_background(self);
+    return ringbuf_count(&self->ringbuf);
 }
@@ -31,9 +31,18 @@
 #include <stdbool.h>
 
 #include "py/obj.h"
+#include "py/ringbuf.h"
+
+#define USB_MIDI_PORTIN_BUFFER_SIZE 128
 
 typedef struct  {
     mp_obj_base_t base;
+    // Filled from TinyUSB's receive FIFO by the USB background task so the
+    // endpoint keeps draining while user code isn't reading.
+    ringbuf_t ringbuf;
+    uint8_t ringbuf_data[USB_MIDI_PORTIN_BUFFER_SIZE];
 } usb_midi_portin_obj_t;
 
+void usb_midi_portin_background(usb_midi_portin_obj_t *self);
+
 #endif /* SHARED_MODULE_USB_MIDI_PORTIN_H */
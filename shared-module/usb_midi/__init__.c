@@ -37,6 +37,7 @@
 #include "tusb.h"
 
 supervisor_allocation* usb_midi_allocation;
+STATIC usb_midi_portin_obj_t *usb_midi_portin;
 
 void usb_midi_init(void) {
     // TODO(tannewt): Make this dynamic.
@@ -53,6 +54,8 @@ void usb_midi_init(void) {
 
     usb_midi_portin_obj_t* in = (usb_midi_portin_obj_t *) (usb_midi_allocation->ptr + tuple_size / 4);
     in->base.type = &usb_midi_portin_type;
+    in->ringbuf = (ringbuf_t) { in->ringbuf_data, sizeof(in->ringbuf_data) };
+    usb_midi_portin = in;
     ports->items[0] = MP_OBJ_FROM_PTR(in);
 
     usb_midi_portout_obj_t* out = (usb_midi_portout_obj_t *) (usb_midi_allocation->ptr + tuple_size / 4 + portin_size / 4);
@@ -61,3 +64,9 @@ void usb_midi_init(void) {
 
     mp_map_lookup(&usb_midi_module_globals.map, MP_ROM_QSTR(MP_QSTR_ports), MP_MAP_LOOKUP)->value = MP_OBJ_FROM_PTR(ports);
 }
+
+void usb_midi_background(void) {
+    if (usb_midi_portin != NULL) {
+        usb_midi_portin_background(usb_midi_portin);
+    }
+}
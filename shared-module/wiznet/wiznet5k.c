@@ -42,6 +42,7 @@
 #include "shared-bindings/digitalio/DigitalInOut.h"
 #include "shared-bindings/digitalio/DriveMode.h"
 #include "shared-bindings/busio/SPI.h"
+#include "supervisor/shared/tick.h"
 
 #include "shared-module/network/__init__.h"
 
@@ -78,6 +79,132 @@ STATIC void wiz_spi_write(const uint8_t *buf, uint32_t len) {
     (void)common_hal_busio_spi_write(wiznet5k_obj.spi, buf, len);
 }
 
+// Socket events that make a socket readable: a connection arriving on a
+// listening socket, the peer closing, or data arriving.  These are the ones
+// acknowledged here.  SENDOK and TIMEOUT belong to socket.c, which checks and
+// clears them on the next send, so they are left set.  Sn_IMR stays at 0xFF
+// since masking SENDOK would leave every send after the first busy; INTn is
+// gated per socket with SIMR only.
+#define WIZNET5K_SOCK_EVENTS (Sn_IR_CON | Sn_IR_DISCON | Sn_IR_RECV)
+
+// Bounds for the SIR polling interval used when INTn is not wired.
+#define WIZNET5K_POLL_MIN_MS (1)
+#define WIZNET5K_POLL_MAX_MS (32)
+
+// How long a send waits for the previous one to complete.  This is a little
+// longer than the chip's own retransmission timeout with the default RTR and
+// RCR (31.8 s), which normally ends the wait with Sn_IR_TIMEOUT first.
+#define WIZNET5K_SEND_TIMEOUT_MS (35000)
+
+STATIC void wiznet5k_socket_irq_enable(uint8_t sn) {
+    wiznet5k_obj.socket_rx_idle &= ~(1 << sn);
+    wiznet5k_obj.socket_timed_out &= ~(1 << sn);
+    setSIMR(getSIMR() | (1 << sn));
+}
+
+STATIC void wiznet5k_socket_irq_disable(uint8_t sn) {
+    setSIMR(getSIMR() & ~(1 << sn));
+    wiznet5k_obj.socket_rx_idle &= ~(1 << sn);
+    wiznet5k_obj.socket_timed_out &= ~(1 << sn);
+    wiznet5k_obj.socket_listening &= ~(1 << sn);
+}
+
+// Collect pending socket events from the chip.  With INTn wired this costs
+// a single GPIO read while nothing is happening.  Without it, SIR is read
+// at an interval that drops to the minimum on activity and doubles while
+// idle, so a tight poll() loop doesn't hammer the SPI bus.
+STATIC void wiznet5k_service(void) {
+    if (wiznet5k_obj.intn.pin != NULL) {
+        // INTn is active low
+        if (common_hal_digitalio_digitalinout_get_value(&wiznet5k_obj.intn)) {
+            return;
+        }
+    } else {
+        uint32_t now = supervisor_ticks_ms32();
+        if ((int32_t)(now - wiznet5k_obj.next_poll_ms) < 0) {
+            return;
+        }
+        wiznet5k_obj.next_poll_ms = now + wiznet5k_obj.poll_interval_ms;
+    }
+
+    // A socket's SIR bit stays set while socket.c has a SENDOK or TIMEOUT
+    // pending, so only events seen for the first time count as activity.
+    bool active = false;
+    uint8_t sir = getSIR();
+    for (uint8_t sn = 0; sir != 0; sn++, sir >>= 1) {
+        if (sir & 1) {
+            uint8_t ir = getSn_IR(sn);
+            uint8_t events = ir & WIZNET5K_SOCK_EVENTS;
+            if (events != 0) {
+                setSn_IR(sn, events);
+            }
+            // A timeout closes the socket, which wakes a reader too.
+            if ((ir & Sn_IR_TIMEOUT) && !(wiznet5k_obj.socket_timed_out & (1 << sn))) {
+                wiznet5k_obj.socket_timed_out |= 1 << sn;
+                events |= Sn_IR_TIMEOUT;
+            }
+            if (events != 0) {
+                wiznet5k_obj.socket_rx_idle &= ~(1 << sn);
+                active = true;
+            }
+        }
+    }
+    if (wiznet5k_obj.intn.pin == NULL) {
+        if (active) {
+            wiznet5k_obj.poll_interval_ms = WIZNET5K_POLL_MIN_MS;
+        } else if (wiznet5k_obj.poll_interval_ms < WIZNET5K_POLL_MAX_MS) {
+            wiznet5k_obj.poll_interval_ms *= 2;
+        }
+    }
+}
+
+void wiznet5k_poll(mp_obj_t nic) {
+    (void)nic;
+    wiznet5k_service();
+}
+
+// Whether a read or accept on the socket would not block.  A socket found
+// idle is remembered as such until one of its events comes in, so repeated
+// polls of a quiet socket don't touch the chip at all.
+STATIC bool wiznet5k_socket_readable(mod_network_socket_obj_t *socket) {
+    if (socket->u_param.domain == 0) {
+        // not opened yet
+        return false;
+    }
+    uint8_t sn = (uint8_t)socket->u_param.fileno;
+    if (wiznet5k_obj.socket_rx_idle & (1 << sn)) {
+        return false;
+    }
+    uint8_t sr = getSn_SR(sn);
+    bool readable;
+    if (wiznet5k_obj.socket_listening & (1 << sn)) {
+        readable = sr != SOCK_LISTEN;
+    } else {
+        // a closed peer reads as EOF, which counts as readable
+        readable = getSn_RX_RSR(sn) != 0 || sr == SOCK_CLOSE_WAIT || sr == SOCK_CLOSED;
+    }
+    if (!readable) {
+        wiznet5k_obj.socket_rx_idle |= 1 << sn;
+    }
+    return readable;
+}
+
+// Block until the socket is readable, running background tasks meanwhile
+// rather than spinning on the chip's status registers.
+STATIC void wiznet5k_socket_wait_readable(mod_network_socket_obj_t *socket) {
+    if (socket->u_param.domain == 0) {
+        return;
+    }
+    for (;;) {
+        wiznet5k_service();
+        if (wiznet5k_socket_readable(socket)) {
+            return;
+        }
+        RUN_BACKGROUND_TASKS;
+        mp_handle_pending();
+    }
+}
+
 int wiznet5k_gethostbyname(mp_obj_t nic, const char *name, mp_uint_t len, uint8_t *out_ip) {
     uint8_t dns_ip[MOD_NETWORK_IPADDR_BUF_SIZE] = {8, 8, 8, 8};
     uint8_t *buf = m_new(uint8_t, MAX_DNS_BUF_SIZE);
@@ -139,6 +266,7 @@ void wiznet5k_socket_close(mod_network_socket_obj_t *socket) {
     uint8_t sn = (uint8_t)socket->u_param.fileno;
     if (sn < _WIZCHIP_SOCK_NUM_) {
         wiznet5k_obj.socket_used &= ~(1 << sn);
+        wiznet5k_socket_irq_disable(sn);
         WIZCHIP_EXPORT(close)(sn);
     }
 }
@@ -154,6 +282,7 @@ int wiznet5k_socket_bind(mod_network_socket_obj_t *socket, byte *ip, mp_uint_t p
 
     // indicate that this socket has been opened
     socket->u_param.domain = 1;
+    wiznet5k_socket_irq_enable(socket->u_param.fileno);
 
     // success
     return 0;
@@ -166,14 +295,18 @@ int wiznet5k_socket_listen(mod_network_socket_obj_t *socket, mp_int_t backlog, i
         *_errno = -ret;
         return -1;
     }
+    wiznet5k_obj.socket_listening |= 1 << socket->u_param.fileno;
     return 0;
 }
 
 int wiznet5k_socket_accept(mod_network_socket_obj_t *socket, mod_network_socket_obj_t *socket2, byte *ip, mp_uint_t *port, int *_errno) {
     for (;;) {
+        wiznet5k_socket_wait_readable(socket);
         int sr = getSn_SR((uint8_t)socket->u_param.fileno);
         if (sr == SOCK_ESTABLISHED) {
             socket2->u_param = socket->u_param;
+            wiznet5k_obj.socket_listening &= ~(1 << socket2->u_param.fileno);
+            wiznet5k_obj.socket_rx_idle &= ~(1 << socket2->u_param.fileno);
             getSn_DIPR((uint8_t)socket2->u_param.fileno, ip);
             *port = getSn_PORT(socket2->u_param.fileno);
 
@@ -228,9 +361,30 @@ int wiznet5k_socket_connect(mod_network_socket_obj_t *socket, byte *ip, mp_uint_
 }
 
 mp_uint_t wiznet5k_socket_send(mod_network_socket_obj_t *socket, const byte *buf, mp_uint_t len, int *_errno) {
-    MP_THREAD_GIL_EXIT();
-    mp_int_t ret = WIZCHIP_EXPORT(send)(socket->u_param.fileno, (byte*)buf, len);
-    MP_THREAD_GIL_ENTER();
+    if (len == 0) {
+        return 0;
+    }
+    // The driver returns SOCK_BUSY (0) while the previous SEND command is
+    // still in flight, even in blocking mode.  Wait it out here so that a
+    // stream write of a large buffer keeps the TX buffer full instead of
+    // seeing a zero-length write and giving up.
+    mp_int_t ret;
+    uint64_t start_ticks = supervisor_ticks_ms64();
+    for (;;) {
+        MP_THREAD_GIL_EXIT();
+        ret = WIZCHIP_EXPORT(send)(socket->u_param.fileno, (byte*)buf, len);
+        MP_THREAD_GIL_ENTER();
+        if (ret != SOCK_BUSY) {
+            break;
+        }
+        if (supervisor_ticks_ms64() - start_ticks >= WIZNET5K_SEND_TIMEOUT_MS) {
+            wiznet5k_socket_close(socket);
+            *_errno = MP_ETIMEDOUT;
+            return -1;
+        }
+        RUN_BACKGROUND_TASKS;
+        mp_handle_pending();
+    }
 
     // TODO convert Wiz errno's to POSIX ones
     if (ret < 0) {
@@ -242,6 +396,7 @@ mp_uint_t wiznet5k_socket_send(mod_network_socket_obj_t *socket, const byte *buf
 }
 
 mp_uint_t wiznet5k_socket_recv(mod_network_socket_obj_t *socket, byte *buf, mp_uint_t len, int *_errno) {
+    wiznet5k_socket_wait_readable(socket);
     MP_THREAD_GIL_EXIT();
     mp_int_t ret = WIZCHIP_EXPORT(recv)(socket->u_param.fileno, buf, len);
     MP_THREAD_GIL_ENTER();
@@ -277,6 +432,7 @@ mp_uint_t wiznet5k_socket_sendto(mod_network_socket_obj_t *socket, const byte *b
 
 mp_uint_t wiznet5k_socket_recvfrom(mod_network_socket_obj_t *socket, byte *buf, mp_uint_t len, byte *ip, mp_uint_t *port, int *_errno) {
     uint16_t port2;
+    wiznet5k_socket_wait_readable(socket);
     MP_THREAD_GIL_EXIT();
     mp_int_t ret = WIZCHIP_EXPORT(recvfrom)(socket->u_param.fileno, buf, len, ip, &port2);
     MP_THREAD_GIL_ENTER();
@@ -311,8 +467,9 @@ int wiznet5k_socket_settimeout(mod_network_socket_obj_t *socket, mp_uint_t timeo
 
 int wiznet5k_socket_ioctl(mod_network_socket_obj_t *socket, mp_uint_t request, mp_uint_t arg, int *_errno) {
     if (request == MP_STREAM_POLL) {
+        wiznet5k_service();
         int ret = 0;
-        if (arg & MP_STREAM_POLL_RD && getSn_RX_RSR(socket->u_param.fileno) != 0) {
+        if (arg & MP_STREAM_POLL_RD && wiznet5k_socket_readable(socket)) {
             ret |= MP_STREAM_POLL_RD;
         }
         if (arg & MP_STREAM_POLL_WR && getSn_TX_FSR(socket->u_param.fileno) != 0) {
@@ -379,13 +536,18 @@ void wiznet5k_socket_deinit(mod_network_socket_obj_t *socket) {
 }
 
 /// Create and return a WIZNET5K object.
-mp_obj_t wiznet5k_create(mp_obj_t spi_in, mp_obj_t cs_in, mp_obj_t rst_in) {
+mp_obj_t wiznet5k_create(mp_obj_t spi_in, mp_obj_t cs_in, mp_obj_t rst_in, mp_obj_t int_in) {
 
     // init the wiznet5k object
     wiznet5k_obj.base.type = (mp_obj_type_t*)&mod_network_nic_type_wiznet5k;
     wiznet5k_obj.cris_state = 0;
     wiznet5k_obj.spi = MP_OBJ_TO_PTR(spi_in);
     wiznet5k_obj.socket_used = 0;
+    wiznet5k_obj.socket_listening = 0;
+    wiznet5k_obj.socket_rx_idle = 0;
+    wiznet5k_obj.socket_timed_out = 0;
+    wiznet5k_obj.poll_interval_ms = WIZNET5K_POLL_MIN_MS;
+    wiznet5k_obj.next_poll_ms = 0;
     wiznet5k_obj.dhcp_socket = -1;
 
     /*!< SPI configuration */
@@ -403,6 +565,12 @@ mp_obj_t wiznet5k_create(mp_obj_t spi_in, mp_obj_t cs_in, mp_obj_t rst_in) {
     common_hal_digitalio_digitalinout_switch_to_output(&wiznet5k_obj.cs, 1, DRIVE_MODE_PUSH_PULL);
 
     if (rst_in) common_hal_digitalio_digitalinout_construct(&wiznet5k_obj.rst, rst_in);
+
+    wiznet5k_obj.intn.pin = NULL;
+    if (int_in) {
+        common_hal_digitalio_digitalinout_construct(&wiznet5k_obj.intn, int_in);
+        common_hal_digitalio_digitalinout_switch_to_input(&wiznet5k_obj.intn, PULL_UP);
+    }
     wiznet5k_reset();
 
     reg_wizchip_cris_cbfunc(wiz_cris_enter, wiz_cris_exit);
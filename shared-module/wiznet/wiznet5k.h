@@ -38,7 +38,13 @@ typedef struct _wiznet5k_obj_t {
     busio_spi_obj_t *spi;
     digitalio_digitalinout_obj_t cs;
     digitalio_digitalinout_obj_t rst;
+    digitalio_digitalinout_obj_t intn; // .pin is NULL when INTn is not wired
     uint8_t socket_used;
+    uint8_t socket_listening; // sockets waiting in LISTEN for accept()
+    uint8_t socket_rx_idle; // sockets last seen with nothing to read
+    uint8_t socket_timed_out; // sockets whose Sn_IR_TIMEOUT has been seen
+    uint8_t poll_interval_ms; // SIR polling interval when INTn is not wired
+    uint32_t next_poll_ms;
     int8_t dhcp_socket; // -1 for DHCP not in use
 } wiznet5k_obj_t;
 
@@ -57,9 +63,10 @@ int wiznet5k_socket_setsockopt(mod_network_socket_obj_t *socket, mp_uint_t level
 int wiznet5k_socket_settimeout(mod_network_socket_obj_t *socket, mp_uint_t timeout_ms, int *_errno);
 int wiznet5k_socket_ioctl(mod_network_socket_obj_t *socket, mp_uint_t request, mp_uint_t arg, int *_errno);
 void wiznet5k_socket_timer_tick(mod_network_socket_obj_t *socket);
+void wiznet5k_poll(mp_obj_t nic);
 void wiznet5k_socket_deinit(mod_network_socket_obj_t *socket);
 mp_obj_t wiznet5k_socket_disconnect(mp_obj_t self_in);
-mp_obj_t wiznet5k_create(mp_obj_t spi_in, mp_obj_t cs_in, mp_obj_t rst_in);
+mp_obj_t wiznet5k_create(mp_obj_t spi_in, mp_obj_t cs_in, mp_obj_t rst_in, mp_obj_t int_in);
 
 int wiznet5k_start_dhcp(void);
 int wiznet5k_stop_dhcp(void);
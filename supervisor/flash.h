@@ -45,6 +45,10 @@ uint32_t supervisor_flash_get_block_count(void);
 mp_uint_t supervisor_flash_read_blocks(uint8_t *dest, uint32_t block_num, uint32_t num_blocks);
 mp_uint_t supervisor_flash_write_blocks(const uint8_t *src, uint32_t block_num, uint32_t num_blocks);
 
+// Returns the address the block can be read from directly, or NULL if the
+// flash isn't memory mapped. The blocks that follow must be mapped after it.
+const uint8_t *supervisor_flash_get_block_address(uint32_t block_num);
+
 struct _fs_user_mount_t;
 void supervisor_flash_init_vfs(struct _fs_user_mount_t *vfs);
 void supervisor_flash_flush(void);
@@ -64,4 +64,8 @@ uint32_t *port_stack_get_top(void);
 void port_set_saved_word(uint32_t);
 uint32_t port_get_saved_word(void);
 
+// Idle the CPU until the next interrupt. The tick interrupt wakes it at least
+// once a millisecond.
+void port_sleep_until_interrupt(void);
+
 #endif  // MICROPY_INCLUDED_SUPERVISOR_PORT_H
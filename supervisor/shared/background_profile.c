@@ -0,0 +1,92 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "supervisor/shared/background_profile.h"
+
+#include <string.h>
+
+#include "py/obj.h"
+#include "py/objtuple.h"
+
+#if CIRCUITPY_BACKGROUND_PROFILE
+
+STATIC background_task_stats_t background_task_stats[BACKGROUND_TASK_COUNT];
+
+STATIC const qstr background_task_names[BACKGROUND_TASK_COUNT] = {
+    [BACKGROUND_TASK_ALL] = MP_QSTR_all,
+    [BACKGROUND_TASK_AUDIO] = MP_QSTR_audio,
+    [BACKGROUND_TASK_DISPLAYIO] = MP_QSTR_displayio,
+    [BACKGROUND_TASK_NETWORK] = MP_QSTR_network,
+    [BACKGROUND_TASK_FILESYSTEM] = MP_QSTR_filesystem,
+    [BACKGROUND_TASK_USB] = MP_QSTR_usb,
+    [BACKGROUND_TASK_BLUETOOTH] = MP_QSTR_bluetooth,
+};
+
+void background_profile_start(background_task_t task) {
+    background_task_stats_t *stats = &background_task_stats[task];
+    uint64_t now = background_profile_ticks_us();
+    if (stats->calls > 0) {
+        uint64_t gap = now - stats->last_start_us;
+        if (gap > stats->max_gap_us) {
+            stats->max_gap_us = gap > UINT32_MAX ? UINT32_MAX : gap;
+        }
+    }
+    stats->last_start_us = now;
+}
+
+void background_profile_end(background_task_t task) {
+    background_task_stats_t *stats = &background_task_stats[task];
+    uint64_t duration = background_profile_ticks_us() - stats->last_start_us;
+    stats->calls += 1;
+    stats->total_us += duration;
+    if (duration > stats->max_us) {
+        stats->max_us = duration > UINT32_MAX ? UINT32_MAX : duration;
+    }
+}
+
+void background_profile_reset(void) {
+    memset(background_task_stats, 0, sizeof(background_task_stats));
+}
+
+mp_obj_t background_profile_stats(void) {
+    mp_obj_t dict = mp_obj_new_dict(0);
+    for (size_t i = 0; i < BACKGROUND_TASK_COUNT; i++) {
+        const background_task_stats_t *stats = &background_task_stats[i];
+        if (stats->calls == 0) {
+            continue;
+        }
+        mp_obj_t items[4] = {
+            mp_obj_new_int_from_uint(stats->calls),
+            mp_obj_new_int_from_ull(stats->total_us),
+            mp_obj_new_int_from_uint(stats->max_us),
+            mp_obj_new_int_from_uint(stats->max_gap_us),
+        };
+        mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(background_task_names[i]), mp_obj_new_tuple(4, items));
+    }
+    return dict;
+}
+
+#endif
@@ -0,0 +1,91 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MICROPY_INCLUDED_SUPERVISOR_SHARED_BACKGROUND_PROFILE_H
+#define MICROPY_INCLUDED_SUPERVISOR_SHARED_BACKGROUND_PROFILE_H
+
+#include <stdint.h>
+
+#include "py/obj.h"
+
+// Records how often and for how long each piece of background work runs so that a subsystem
+// that hogs the background loop can be found from Python with supervisor.background_stats().
+
+#ifndef CIRCUITPY_BACKGROUND_PROFILE
+#define CIRCUITPY_BACKGROUND_PROFILE (0)
+#endif
+
+typedef enum {
+    // The whole of run_background_tasks.
+    BACKGROUND_TASK_ALL,
+    BACKGROUND_TASK_AUDIO,
+    BACKGROUND_TASK_DISPLAYIO,
+    BACKGROUND_TASK_NETWORK,
+    BACKGROUND_TASK_FILESYSTEM,
+    BACKGROUND_TASK_USB,
+    BACKGROUND_TASK_BLUETOOTH,
+    BACKGROUND_TASK_COUNT
+} background_task_t;
+
+typedef struct {
+    uint32_t calls;
+    uint32_t max_us;
+    // Longest time from the start of one run to the start of the next.
+    uint32_t max_gap_us;
+    uint64_t total_us;
+    uint64_t last_start_us;
+} background_task_stats_t;
+
+#if CIRCUITPY_BACKGROUND_PROFILE
+
+// Provided by the port. Only differences between values are used.
+uint64_t background_profile_ticks_us(void);
+
+void background_profile_start(background_task_t task);
+void background_profile_end(background_task_t task);
+void background_profile_reset(void);
+// Returns a dict mapping task name to (calls, total_us, max_us, max_gap_us) for every task that
+// has run since the last reset.
+mp_obj_t background_profile_stats(void);
+
+#define BACKGROUND_TASK_START(task) background_profile_start(task)
+#define BACKGROUND_TASK_END(task) background_profile_end(task)
+
+#else
+
+#define BACKGROUND_TASK_START(task)
+#define BACKGROUND_TASK_END(task)
+
+#endif
+
+// Time a single call in the background loop.
+#define BACKGROUND_TASK(task, call) do { \
+        BACKGROUND_TASK_START(task); \
+        call; \
+        BACKGROUND_TASK_END(task); \
+    } while (0)
+
+#endif  // MICROPY_INCLUDED_SUPERVISOR_SHARED_BACKGROUND_PROFILE_H
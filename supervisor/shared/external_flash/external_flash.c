@@ -40,21 +40,54 @@
 #include "supervisor/memory.h"
 #include "supervisor/shared/rgb_led_status.h"
 
+#if EXTERNAL_FLASH_TRANSLATION_LAYER
+#include "supervisor/shared/flash_translation.h"
+#endif
+
 #define NO_SECTOR_LOADED 0xFFFFFFFF
 
-// The currently cached sector in the cache, ram or flash based.
-static uint32_t current_sector;
+// A sector with blocks in the write cache, ram or flash based.
+typedef struct {
+    uint32_t sector;
+    // Track which blocks (up to 32) in the sector currently live in the cache.
+    uint32_t dirty_mask;
+    // The cache_clock value of the last write, used to evict the least
+    // recently written sector.
+    uint32_t last_use;
+} cached_sector_t;
+
+// The sectors cached in ram. The flash based cache only uses the first one.
+static cached_sector_t cached_sectors[EXTERNAL_FLASH_CACHE_SECTORS];
+
+// The number of cached_sectors that have ram allocated to them.
+static uint8_t ram_cache_sectors;
+
+static uint32_t cache_clock;
 
 const external_flash_device possible_devices[EXTERNAL_FLASH_DEVICE_COUNT] = {EXTERNAL_FLASH_DEVICES};
 
 static const external_flash_device* flash_device = NULL;
 
-// Track which blocks (up to 32) in the current sector currently live in the
-// cache.
-static uint32_t dirty_mask;
-
 static supervisor_allocation* supervisor_cache = NULL;
 
+#if EXTERNAL_FLASH_READ_CACHE_BLOCKS > 0
+// A small LRU cache of recently read blocks. Only single block reads, which
+// are mostly FAT and directory blocks, are added to it. Multi-block reads
+// stream file data and bypass it so they don't evict the metadata.
+#define NO_BLOCK_CACHED 0xFFFFFFFF
+static uint32_t read_cache_block[EXTERNAL_FLASH_READ_CACHE_BLOCKS];
+static uint32_t read_cache_last_use[EXTERNAL_FLASH_READ_CACHE_BLOCKS];
+static uint32_t read_cache_clock;
+static uint8_t read_cache_data[EXTERNAL_FLASH_READ_CACHE_BLOCKS][FILESYSTEM_BLOCK_SIZE];
+#endif
+
+#if EXTERNAL_FLASH_TRANSLATION_LAYER
+static flash_translation_t translation;
+// Block map and sector state. Kept for as long as the flash is in use.
+static supervisor_allocation* translation_ram = NULL;
+static bool translation_mounted = false;
+#endif
+
 // Wait until both the write enable and write in progress bits have cleared.
 static bool wait_for_flash_ready(void) {
     uint8_t read_status_response[1] = {0x00};
@@ -117,30 +150,22 @@ static bool write_flash(uint32_t address, const uint8_t* data, uint32_t data_len
     return true;
 }
 
-static bool page_erased(uint32_t sector_address) {
-    // Check the first few bytes to catch the common case where there is data
-    // without using a bunch of memory.
-    uint8_t short_buffer[4];
-    if (read_flash(sector_address, short_buffer, 4)) {
-        for (uint16_t i = 0; i < 4; i++) {
-            if (short_buffer[i] != 0xff) {
-                return false;
-            }
-        }
-    } else {
+// Checks whether the page of data can be programmed over the flash at address
+// without erasing it first, which is the case when it only clears bits. Sets
+// changed when the data differs from what is already on the flash.
+static bool page_programmable(uint32_t address, const uint8_t* data, bool* changed) {
+    uint8_t buffer[SPI_FLASH_PAGE_SIZE];
+    if (!read_flash(address, buffer, SPI_FLASH_PAGE_SIZE)) {
         return false;
     }
-
-    // Now check the full length.
-    uint8_t full_buffer[FILESYSTEM_BLOCK_SIZE];
-    if (read_flash(sector_address, full_buffer, FILESYSTEM_BLOCK_SIZE)) {
-        for (uint16_t i = 0; i < FILESYSTEM_BLOCK_SIZE; i++) {
-            if (short_buffer[i] != 0xff) {
-                return false;
-            }
+    *changed = false;
+    for (uint16_t i = 0; i < SPI_FLASH_PAGE_SIZE; i++) {
+        if ((buffer[i] & data[i]) != data[i]) {
+            return false;
+        }
+        if (buffer[i] != data[i]) {
+            *changed = true;
         }
-    } else {
-        return false;
     }
     return true;
 }
@@ -158,6 +183,67 @@ static bool erase_sector(uint32_t sector_address) {
     return true;
 }
 
+#if EXTERNAL_FLASH_TRANSLATION_LAYER
+// Programs an arbitrary range that has already been erased, splitting it at
+// page boundaries.
+static bool program_flash(uint32_t address, const uint8_t* data, uint32_t data_length) {
+    if (flash_device == NULL) {
+        return false;
+    }
+    while (data_length > 0) {
+        uint32_t length = SPI_FLASH_PAGE_SIZE - address % SPI_FLASH_PAGE_SIZE;
+        if (length > data_length) {
+            length = data_length;
+        }
+        if (!wait_for_flash_ready() || !write_enable() ||
+            !spi_flash_write_data(address, (uint8_t*) data, length)) {
+            return false;
+        }
+        address += length;
+        data += length;
+        data_length -= length;
+    }
+    return true;
+}
+
+static bool translation_read(flash_translation_t* self, uint32_t address, uint8_t* data, uint32_t length) {
+    return read_flash(address, data, length);
+}
+
+static bool translation_program(flash_translation_t* self, uint32_t address, const uint8_t* data, uint32_t length) {
+    return program_flash(address, data, length);
+}
+
+static bool translation_erase(flash_translation_t* self, uint32_t sector_address) {
+    return erase_sector(sector_address);
+}
+
+static const flash_translation_ops_t translation_ops = {
+    .read = translation_read,
+    .program = translation_program,
+    .erase = translation_erase,
+};
+
+static void translation_init(void) {
+    uint16_t sector_count = flash_device->total_size / FLASH_TRANSLATION_SECTOR_SIZE;
+    if (translation_ram == NULL) {
+        uint32_t length = (flash_translation_ram_size(sector_count) + 3) & ~3;
+        translation_ram = allocate_memory(length, false);
+        if (translation_ram == NULL) {
+            return;
+        }
+    }
+    flash_translation_init(&translation, &translation_ops, sector_count, translation_ram->ptr);
+    translation_mounted = flash_translation_mount(&translation);
+}
+
+void external_flash_background(void) {
+    if (translation_mounted) {
+        flash_translation_background(&translation);
+    }
+}
+#endif
+
 // Sector is really 24 bits.
 static bool copy_block(uint32_t src_address, uint32_t dest_address) {
     // Copy page by page to minimize RAM buffer.
@@ -174,6 +260,50 @@ static bool copy_block(uint32_t src_address, uint32_t dest_address) {
     return true;
 }
 
+#if EXTERNAL_FLASH_READ_CACHE_BLOCKS > 0
+static void read_cache_clear(void) {
+    for (uint8_t i = 0; i < EXTERNAL_FLASH_READ_CACHE_BLOCKS; i++) {
+        read_cache_block[i] = NO_BLOCK_CACHED;
+        read_cache_last_use[i] = 0;
+    }
+    read_cache_clock = 0;
+}
+
+// Returns the cache slot holding block or -1 if it isn't cached.
+static int16_t read_cache_find(uint32_t block) {
+    for (uint8_t i = 0; i < EXTERNAL_FLASH_READ_CACHE_BLOCKS; i++) {
+        if (read_cache_block[i] == block) {
+            read_cache_last_use[i] = ++read_cache_clock;
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Stores data for block in the least recently used slot.
+static void read_cache_insert(uint32_t block, const uint8_t* data) {
+    uint8_t oldest = 0;
+    for (uint8_t i = 1; i < EXTERNAL_FLASH_READ_CACHE_BLOCKS; i++) {
+        if (read_cache_last_use[i] < read_cache_last_use[oldest]) {
+            oldest = i;
+        }
+    }
+    read_cache_block[oldest] = block;
+    read_cache_last_use[oldest] = ++read_cache_clock;
+    memcpy(read_cache_data[oldest], data, FILESYSTEM_BLOCK_SIZE);
+}
+
+// Keeps a cached copy of block in sync with data that is being written.
+static void read_cache_update(uint32_t block, const uint8_t* data) {
+    for (uint8_t i = 0; i < EXTERNAL_FLASH_READ_CACHE_BLOCKS; i++) {
+        if (read_cache_block[i] == block) {
+            memcpy(read_cache_data[i], data, FILESYSTEM_BLOCK_SIZE);
+            return;
+        }
+    }
+}
+#endif
+
 void supervisor_flash_init(void) {
     if (flash_device != NULL) {
         return;
@@ -252,9 +382,19 @@ void supervisor_flash_init(void) {
 
     wait_for_flash_ready();
 
-    current_sector = NO_SECTOR_LOADED;
-    dirty_mask = 0;
+    for (uint8_t i = 0; i < EXTERNAL_FLASH_CACHE_SECTORS; i++) {
+        cached_sectors[i].sector = NO_SECTOR_LOADED;
+        cached_sectors[i].dirty_mask = 0;
+    }
+    ram_cache_sectors = 0;
     MP_STATE_VM(flash_ram_cache) = NULL;
+    #if EXTERNAL_FLASH_READ_CACHE_BLOCKS > 0
+    read_cache_clear();
+    #endif
+
+    #if EXTERNAL_FLASH_TRANSLATION_LAYER
+    translation_init();
+    #endif
 }
 
 // The size of each individual block.
@@ -264,6 +404,12 @@ uint32_t supervisor_flash_get_block_size(void) {
 
 // The total number of available blocks.
 uint32_t supervisor_flash_get_block_count(void) {
+    #if EXTERNAL_FLASH_TRANSLATION_LAYER
+    if (!translation_mounted) {
+        return 0;
+    }
+    return translation.block_count;
+    #endif
     // We subtract one erase sector size because we may use it as a staging area
     // for writes.
     return (flash_device->total_size - SPI_FLASH_ERASE_SIZE) / FILESYSTEM_BLOCK_SIZE;
@@ -271,18 +417,15 @@ uint32_t supervisor_flash_get_block_count(void) {
 
 // Flush the cache that was written to the scratch portion of flash. Only used
 // when ram is tight.
-static bool flush_scratch_flash(void) {
-    if (current_sector == NO_SECTOR_LOADED) {
-        return true;
-    }
+static bool flush_scratch_flash(cached_sector_t* cached) {
     // First, copy out any blocks that we haven't touched from the sector we've
     // cached.
     bool copy_to_scratch_ok = true;
     uint32_t scratch_sector = flash_device->total_size - SPI_FLASH_ERASE_SIZE;
     for (uint8_t i = 0; i < SPI_FLASH_ERASE_SIZE / FILESYSTEM_BLOCK_SIZE; i++) {
-        if ((dirty_mask & (1 << i)) == 0) {
+        if ((cached->dirty_mask & (1 << i)) == 0) {
             copy_to_scratch_ok = copy_to_scratch_ok &&
-                copy_block(current_sector + i * FILESYSTEM_BLOCK_SIZE,
+                copy_block(cached->sector + i * FILESYSTEM_BLOCK_SIZE,
                            scratch_sector + i * FILESYSTEM_BLOCK_SIZE);
         }
     }
@@ -292,79 +435,73 @@ static bool flush_scratch_flash(void) {
         return false;
     }
     // Second, erase the current sector.
-    erase_sector(current_sector);
+    erase_sector(cached->sector);
     // Finally, copy the new version into it.
     for (uint8_t i = 0; i < SPI_FLASH_ERASE_SIZE / FILESYSTEM_BLOCK_SIZE; i++) {
         copy_block(scratch_sector + i * FILESYSTEM_BLOCK_SIZE,
-                   current_sector + i * FILESYSTEM_BLOCK_SIZE);
+                   cached->sector + i * FILESYSTEM_BLOCK_SIZE);
     }
     return true;
 }
 
-// Attempts to allocate a new set of page buffers for caching a full sector in
-// ram. Each page is allocated separately so that the GC doesn't need to provide
-// one huge block. We can free it as we write if we want to also.
+// Attempts to allocate a new set of page buffers for caching up to
+// EXTERNAL_FLASH_CACHE_SECTORS full sectors in ram. Each page is allocated
+// separately so that the GC doesn't need to provide one huge block. When ram
+// is tight we settle for fewer sectors.
 static bool allocate_ram_cache(void) {
     uint8_t blocks_per_sector = SPI_FLASH_ERASE_SIZE / FILESYSTEM_BLOCK_SIZE;
     uint8_t pages_per_block = FILESYSTEM_BLOCK_SIZE / SPI_FLASH_PAGE_SIZE;
+    uint32_t pages_per_sector = blocks_per_sector * pages_per_block;
 
-    uint32_t table_size = blocks_per_sector * pages_per_block * sizeof(uint32_t);
+    uint32_t table_size = EXTERNAL_FLASH_CACHE_SECTORS * pages_per_sector * sizeof(uint8_t*);
     // Attempt to allocate outside the heap first.
-    supervisor_cache = allocate_memory(table_size + SPI_FLASH_ERASE_SIZE, false);
-    if (supervisor_cache != NULL) {
-        MP_STATE_VM(flash_ram_cache) = (uint8_t **) supervisor_cache->ptr;
-        uint8_t* page_start = (uint8_t *) supervisor_cache->ptr + table_size;
-
-        for (uint8_t i = 0; i < blocks_per_sector; i++) {
-            for (uint8_t j = 0; j < pages_per_block; j++) {
-                uint32_t offset = i * pages_per_block + j;
-                MP_STATE_VM(flash_ram_cache)[offset] = page_start + offset * SPI_FLASH_PAGE_SIZE;
+    for (uint8_t sectors = EXTERNAL_FLASH_CACHE_SECTORS; sectors > 0; sectors--) {
+        supervisor_cache = allocate_memory(table_size + sectors * SPI_FLASH_ERASE_SIZE, false);
+        if (supervisor_cache != NULL) {
+            MP_STATE_VM(flash_ram_cache) = (uint8_t **) supervisor_cache->ptr;
+            uint8_t* page_start = (uint8_t *) supervisor_cache->ptr + table_size;
+
+            for (uint32_t i = 0; i < sectors * pages_per_sector; i++) {
+                MP_STATE_VM(flash_ram_cache)[i] = page_start + i * SPI_FLASH_PAGE_SIZE;
             }
+            ram_cache_sectors = sectors;
+            return true;
         }
-        return true;
     }
 
     if (MP_STATE_MEM(gc_pool_start) == 0) {
         return false;
     }
 
-    MP_STATE_VM(flash_ram_cache) = m_malloc_maybe(blocks_per_sector * pages_per_block * sizeof(uint32_t), false);
+    MP_STATE_VM(flash_ram_cache) = m_malloc_maybe(table_size, false);
     if (MP_STATE_VM(flash_ram_cache) == NULL) {
         return false;
     }
-    // Declare i and j outside the loops in case we fail to allocate everything
-    // we need. In that case we'll give it back.
-    uint8_t i = 0;
-    uint8_t j = 0;
-    bool success = true;
-    for (i = 0; i < blocks_per_sector; i++) {
-        for (j = 0; j < pages_per_block; j++) {
-            uint8_t *page_cache = m_malloc_maybe(SPI_FLASH_PAGE_SIZE, false);
-            if (page_cache == NULL) {
-                success = false;
+    ram_cache_sectors = 0;
+    while (ram_cache_sectors < EXTERNAL_FLASH_CACHE_SECTORS) {
+        uint8_t** sector_pages = MP_STATE_VM(flash_ram_cache) + ram_cache_sectors * pages_per_sector;
+        uint32_t i;
+        for (i = 0; i < pages_per_sector; i++) {
+            sector_pages[i] = m_malloc_maybe(SPI_FLASH_PAGE_SIZE, false);
+            if (sector_pages[i] == NULL) {
                 break;
             }
-            MP_STATE_VM(flash_ram_cache)[i * pages_per_block + j] = page_cache;
         }
-        if (!success) {
+        // We couldn't allocate the whole sector so give back what we got.
+        if (i < pages_per_sector) {
+            for (; i > 0; i--) {
+                m_free(sector_pages[i - 1]);
+            }
             break;
         }
+        ram_cache_sectors++;
     }
-    // We couldn't allocate enough so give back what we got.
-    if (!success) {
-        // We add 1 so that we delete 0 when i is 1. Going to zero (i >= 0)
-        // would never stop because i is unsigned.
-        i++;
-        for (; i > 0; i--) {
-            for (; j > 0; j--) {
-                m_free(MP_STATE_VM(flash_ram_cache)[(i - 1) * pages_per_block + (j - 1)]);
-            }
-            j = pages_per_block;
-        }
+    if (ram_cache_sectors == 0) {
         m_free(MP_STATE_VM(flash_ram_cache));
         MP_STATE_VM(flash_ram_cache) = NULL;
+        return false;
     }
-    return success;
+    return true;
 }
 
 static void release_ram_cache(void) {
@@ -372,85 +509,122 @@ static void release_ram_cache(void) {
         free_memory(supervisor_cache);
         supervisor_cache = NULL;
     } else if (MP_STATE_MEM(gc_pool_start)) {
+        uint32_t pages_per_sector = SPI_FLASH_ERASE_SIZE / SPI_FLASH_PAGE_SIZE;
+        for (uint32_t i = 0; i < ram_cache_sectors * pages_per_sector; i++) {
+            m_free(MP_STATE_VM(flash_ram_cache)[i]);
+        }
         m_free(MP_STATE_VM(flash_ram_cache));
     }
     MP_STATE_VM(flash_ram_cache) = NULL;
+    ram_cache_sectors = 0;
+}
+
+// Returns the ram cache page holding the given page of a block of a cached sector.
+static inline uint8_t* ram_cache_page(cached_sector_t* cached, uint8_t block_index, uint8_t page) {
+    uint8_t pages_per_block = FILESYSTEM_BLOCK_SIZE / SPI_FLASH_PAGE_SIZE;
+    uint32_t pages_per_sector = SPI_FLASH_ERASE_SIZE / SPI_FLASH_PAGE_SIZE;
+    return MP_STATE_VM(flash_ram_cache)[(cached - cached_sectors) * pages_per_sector +
+                                        block_index * pages_per_block + page];
 }
 
-// Flush the cached sector from ram onto the flash. We'll free the cache unless
-// keep_cache is true.
-static bool flush_ram_cache(bool keep_cache) {
-    if (current_sector == NO_SECTOR_LOADED) {
-        if (!keep_cache) {
-            release_ram_cache();
+// Flush a cached sector from ram onto the flash.
+static bool flush_ram_cache(cached_sector_t* cached) {
+    uint8_t blocks_per_sector = SPI_FLASH_ERASE_SIZE / FILESYSTEM_BLOCK_SIZE;
+    uint8_t pages_per_block = FILESYSTEM_BLOCK_SIZE / SPI_FLASH_PAGE_SIZE;
+    // First, check whether the cached blocks only clear bits that are set on
+    // the flash. In that case we can program them in place and skip the erase.
+    bool needs_erase = false;
+    uint32_t changed_pages = 0;
+    for (uint8_t i = 0; i < blocks_per_sector && !needs_erase; i++) {
+        if ((cached->dirty_mask & (1 << i)) == 0) {
+            continue;
+        }
+        for (uint8_t j = 0; j < pages_per_block; j++) {
+            bool changed;
+            if (!page_programmable(cached->sector + (i * pages_per_block + j) * SPI_FLASH_PAGE_SIZE,
+                                   ram_cache_page(cached, i, j), &changed)) {
+                needs_erase = true;
+                break;
+            }
+            if (changed) {
+                changed_pages |= 1 << (i * pages_per_block + j);
+            }
+        }
+    }
+    if (!needs_erase) {
+        for (uint8_t i = 0; i < blocks_per_sector * pages_per_block; i++) {
+            if ((changed_pages & (1 << i)) != 0 &&
+                !write_flash(cached->sector + i * SPI_FLASH_PAGE_SIZE,
+                             ram_cache_page(cached, i / pages_per_block, i % pages_per_block),
+                             SPI_FLASH_PAGE_SIZE)) {
+                return false;
+            }
         }
         return true;
     }
-    // First, copy out any blocks that we haven't touched from the sector
+
+    // Otherwise, copy out any blocks that we haven't touched from the sector
     // we've cached. If we don't do this we'll erase the data during the sector
     // erase below.
-    bool copy_to_ram_ok = true;
-    uint8_t pages_per_block = FILESYSTEM_BLOCK_SIZE / SPI_FLASH_PAGE_SIZE;
-    for (uint8_t i = 0; i < SPI_FLASH_ERASE_SIZE / FILESYSTEM_BLOCK_SIZE; i++) {
-        if ((dirty_mask & (1 << i)) == 0) {
+    for (uint8_t i = 0; i < blocks_per_sector; i++) {
+        if ((cached->dirty_mask & (1 << i)) == 0) {
             for (uint8_t j = 0; j < pages_per_block; j++) {
-                copy_to_ram_ok = read_flash(
-                    current_sector + (i * pages_per_block + j) * SPI_FLASH_PAGE_SIZE,
-                    MP_STATE_VM(flash_ram_cache)[i * pages_per_block + j],
-                    SPI_FLASH_PAGE_SIZE);
-                if (!copy_to_ram_ok) {
-                    break;
+                if (!read_flash(cached->sector + (i * pages_per_block + j) * SPI_FLASH_PAGE_SIZE,
+                                ram_cache_page(cached, i, j),
+                                SPI_FLASH_PAGE_SIZE)) {
+                    return false;
                 }
             }
         }
-        if (!copy_to_ram_ok) {
-            break;
-        }
-    }
-
-    if (!copy_to_ram_ok) {
-        return false;
     }
     // Second, erase the current sector.
-    erase_sector(current_sector);
+    erase_sector(cached->sector);
     // Lastly, write all the data in ram that we've cached.
-    for (uint8_t i = 0; i < SPI_FLASH_ERASE_SIZE / FILESYSTEM_BLOCK_SIZE; i++) {
+    for (uint8_t i = 0; i < blocks_per_sector; i++) {
         for (uint8_t j = 0; j < pages_per_block; j++) {
-            write_flash(current_sector + (i * pages_per_block + j) * SPI_FLASH_PAGE_SIZE,
-                        MP_STATE_VM(flash_ram_cache)[i * pages_per_block + j],
+            write_flash(cached->sector + (i * pages_per_block + j) * SPI_FLASH_PAGE_SIZE,
+                        ram_cache_page(cached, i, j),
                         SPI_FLASH_PAGE_SIZE);
-            if (!keep_cache && supervisor_cache == NULL && MP_STATE_MEM(gc_pool_start)) {
-                m_free(MP_STATE_VM(flash_ram_cache)[i * pages_per_block + j]);
-            }
         }
     }
-    // We're done with the cache for now so give it back.
-    if (!keep_cache) {
-        release_ram_cache();
-    }
     return true;
 }
 
-// Delegates to the correct flash flush method depending on the existing cache.
-// TODO Don't blink the status indicator if we don't actually do any writing (hard to tell right now).
-static void spi_flash_flush_keep_cache(bool keep_cache) {
+// Writes a cached sector back to the flash using the cache it lives in.
+static void flush_cached_sector(cached_sector_t* cached) {
+    if (cached->sector == NO_SECTOR_LOADED) {
+        return;
+    }
     #ifdef MICROPY_HW_LED_MSC
         port_pin_set_output_level(MICROPY_HW_LED_MSC, true);
     #endif
     temp_status_color(ACTIVE_WRITE);
     // If we've cached to the flash itself flush from there.
     if (MP_STATE_VM(flash_ram_cache) == NULL) {
-        flush_scratch_flash();
+        flush_scratch_flash(cached);
     } else {
-        flush_ram_cache(keep_cache);
+        flush_ram_cache(cached);
     }
-    current_sector = NO_SECTOR_LOADED;
+    cached->sector = NO_SECTOR_LOADED;
+    cached->dirty_mask = 0;
     clear_temp_status();
     #ifdef MICROPY_HW_LED_MSC
         port_pin_set_output_level(MICROPY_HW_LED_MSC, false);
     #endif
 }
 
+// Flushes every cached sector. We'll free the ram cache unless keep_cache is
+// true.
+static void spi_flash_flush_keep_cache(bool keep_cache) {
+    for (uint8_t i = 0; i < EXTERNAL_FLASH_CACHE_SECTORS; i++) {
+        flush_cached_sector(&cached_sectors[i]);
+    }
+    // We're done with the cache for now so give it back.
+    if (!keep_cache && MP_STATE_VM(flash_ram_cache) != NULL) {
+        release_ram_cache();
+    }
+}
+
 void supervisor_flash_flush(void) {
     spi_flash_flush_keep_cache(true);
 }
@@ -468,6 +642,31 @@ static int32_t convert_block_to_flash_addr(uint32_t block) {
     return -1;
 }
 
+// Returns the cache entry for the sector at sector_address or NULL if it isn't
+// cached.
+static cached_sector_t* find_cached_sector(uint32_t sector_address) {
+    for (uint8_t i = 0; i < EXTERNAL_FLASH_CACHE_SECTORS; i++) {
+        if (cached_sectors[i].sector == sector_address) {
+            return &cached_sectors[i];
+        }
+    }
+    return NULL;
+}
+
+// Returns the cached sector holding the block at address if the block has been
+// written to the cache but not yet flushed to the flash. Sets block_index to
+// its index in the sector.
+static cached_sector_t* block_in_write_cache(uint32_t address, uint8_t* block_index) {
+    // Mask out the lower bits that designate the address within the sector.
+    uint32_t this_sector = address & (~(SPI_FLASH_ERASE_SIZE - 1));
+    *block_index = (address / FILESYSTEM_BLOCK_SIZE) % (SPI_FLASH_ERASE_SIZE / FILESYSTEM_BLOCK_SIZE);
+    cached_sector_t* cached = find_cached_sector(this_sector);
+    if (cached != NULL && (cached->dirty_mask & (1 << *block_index)) > 0) {
+        return cached;
+    }
+    return NULL;
+}
+
 bool external_flash_read_block(uint8_t *dest, uint32_t block) {
     int32_t address = convert_block_to_flash_addr(block);
     if (address == -1) {
@@ -475,17 +674,15 @@ bool external_flash_read_block(uint8_t *dest, uint32_t block) {
         return false;
     }
 
-    // Mask out the lower bits that designate the address within the sector.
-    uint32_t this_sector = address & (~(SPI_FLASH_ERASE_SIZE - 1));
-    uint8_t block_index = (address / FILESYSTEM_BLOCK_SIZE) % (SPI_FLASH_ERASE_SIZE / FILESYSTEM_BLOCK_SIZE);
-    uint8_t mask = 1 << (block_index);
-    // We're reading from the currently cached sector.
-    if (current_sector == this_sector && (mask & dirty_mask) > 0) {
+    uint8_t block_index;
+    cached_sector_t* cached = block_in_write_cache(address, &block_index);
+    // We're reading from a cached sector.
+    if (cached != NULL) {
         if (MP_STATE_VM(flash_ram_cache) != NULL) {
             uint8_t pages_per_block = FILESYSTEM_BLOCK_SIZE / SPI_FLASH_PAGE_SIZE;
             for (int i = 0; i < pages_per_block; i++) {
                 memcpy(dest + i * SPI_FLASH_PAGE_SIZE,
-                       MP_STATE_VM(flash_ram_cache)[block_index * pages_per_block + i],
+                       ram_cache_page(cached, block_index, i),
                        SPI_FLASH_PAGE_SIZE);
             }
             return true;
@@ -494,7 +691,20 @@ bool external_flash_read_block(uint8_t *dest, uint32_t block) {
             return read_flash(scratch_address, dest, FILESYSTEM_BLOCK_SIZE);
         }
     }
+    #if EXTERNAL_FLASH_READ_CACHE_BLOCKS > 0
+    int16_t slot = read_cache_find(block);
+    if (slot >= 0) {
+        memcpy(dest, read_cache_data[slot], FILESYSTEM_BLOCK_SIZE);
+        return true;
+    }
+    if (!read_flash(address, dest, FILESYSTEM_BLOCK_SIZE)) {
+        return false;
+    }
+    read_cache_insert(block, dest);
+    return true;
+    #else
     return read_flash(address, dest, FILESYSTEM_BLOCK_SIZE);
+    #endif
 }
 
 bool external_flash_write_block(const uint8_t *data, uint32_t block) {
@@ -504,36 +714,75 @@ bool external_flash_write_block(const uint8_t *data, uint32_t block) {
         // bad block number
         return false;
     }
+    #if EXTERNAL_FLASH_READ_CACHE_BLOCKS > 0
+    read_cache_update(block, data);
+    #endif
     // Wait for any previous writes to finish.
     wait_for_flash_ready();
     // Mask out the lower bits that designate the address within the sector.
     uint32_t this_sector = address & (~(SPI_FLASH_ERASE_SIZE - 1));
     uint8_t block_index = (address / FILESYSTEM_BLOCK_SIZE) % (SPI_FLASH_ERASE_SIZE / FILESYSTEM_BLOCK_SIZE);
-    uint8_t mask = 1 << (block_index);
-    // Flush the cache if we're moving onto a sector or we're writing the
-    // same block again.
-    if (current_sector != this_sector || (mask & dirty_mask) > 0) {
-        // Check to see if we'd write to an erased page. In that case we
-        // can write directly.
-        if (page_erased(address)) {
-            return write_flash(address, data, FILESYSTEM_BLOCK_SIZE);
-        }
-        if (current_sector != NO_SECTOR_LOADED) {
-            supervisor_flash_flush();
-        }
-        if (MP_STATE_VM(flash_ram_cache) == NULL && !allocate_ram_cache()) {
+    uint32_t mask = 1 << (block_index);
+    uint8_t pages_per_block = FILESYSTEM_BLOCK_SIZE / SPI_FLASH_PAGE_SIZE;
+    cached_sector_t* cached = find_cached_sector(this_sector);
+    bool block_cached = cached != NULL && (mask & cached->dirty_mask) > 0;
+    if (!block_cached) {
+        // Check to see if the new data only clears bits of what's on the flash,
+        // for example because it's erased. In that case we can write directly.
+        bool programmable = true;
+        uint8_t changed_pages = 0;
+        for (uint8_t i = 0; i < pages_per_block && programmable; i++) {
+            bool changed;
+            programmable = page_programmable(address + i * SPI_FLASH_PAGE_SIZE,
+                                             data + i * SPI_FLASH_PAGE_SIZE, &changed);
+            if (changed) {
+                changed_pages |= 1 << i;
+            }
+        }
+        if (programmable) {
+            for (uint8_t i = 0; i < pages_per_block; i++) {
+                if ((changed_pages & (1 << i)) != 0 &&
+                    !write_flash(address + i * SPI_FLASH_PAGE_SIZE, data + i * SPI_FLASH_PAGE_SIZE,
+                                 SPI_FLASH_PAGE_SIZE)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+    // Blocks in the flash based cache can't be rewritten so flush it when we
+    // move onto another sector or write the same block again.
+    if (MP_STATE_VM(flash_ram_cache) == NULL && (cached == NULL || block_cached)) {
+        flush_cached_sector(&cached_sectors[0]);
+        cached = NULL;
+        if (!allocate_ram_cache()) {
             erase_sector(flash_device->total_size - SPI_FLASH_ERASE_SIZE);
             wait_for_flash_ready();
         }
-        current_sector = this_sector;
-        dirty_mask = 0;
     }
-    dirty_mask |= mask;
+    if (cached == NULL) {
+        // Use a free sector of the cache or evict the least recently written one.
+        uint8_t cache_size = MP_STATE_VM(flash_ram_cache) == NULL ? 1 : ram_cache_sectors;
+        cached = &cached_sectors[0];
+        for (uint8_t i = 0; i < cache_size; i++) {
+            if (cached_sectors[i].sector == NO_SECTOR_LOADED) {
+                cached = &cached_sectors[i];
+                break;
+            }
+            if (cached_sectors[i].last_use < cached->last_use) {
+                cached = &cached_sectors[i];
+            }
+        }
+        flush_cached_sector(cached);
+        cached->sector = this_sector;
+        cached->dirty_mask = 0;
+    }
+    cached->dirty_mask |= mask;
+    cached->last_use = ++cache_clock;
     // Copy the block to the appropriate cache.
     if (MP_STATE_VM(flash_ram_cache) != NULL) {
-        uint8_t pages_per_block = FILESYSTEM_BLOCK_SIZE / SPI_FLASH_PAGE_SIZE;
         for (int i = 0; i < pages_per_block; i++) {
-            memcpy(MP_STATE_VM(flash_ram_cache)[block_index * pages_per_block + i],
+            memcpy(ram_cache_page(cached, block_index, i),
                    data + i * SPI_FLASH_PAGE_SIZE,
                    SPI_FLASH_PAGE_SIZE);
         }
@@ -544,20 +793,134 @@ bool external_flash_write_block(const uint8_t *data, uint32_t block) {
     }
 }
 
+// Writes a whole erase sector's worth of blocks starting at the sector aligned
+// block. Nothing in the sector survives so it goes straight to the flash
+// without passing through the write cache or reading anything back. The last
+// page program is left running so the caller can get on with the next request.
+static bool write_sector(const uint8_t *data, uint32_t block) {
+    uint8_t blocks_per_sector = SPI_FLASH_ERASE_SIZE / FILESYSTEM_BLOCK_SIZE;
+    int32_t address = convert_block_to_flash_addr(block);
+    if (address == -1 || convert_block_to_flash_addr(block + blocks_per_sector - 1) == -1) {
+        // bad block number
+        return false;
+    }
+    #if EXTERNAL_FLASH_READ_CACHE_BLOCKS > 0
+    for (uint8_t i = 0; i < blocks_per_sector; i++) {
+        read_cache_update(block + i, data + i * FILESYSTEM_BLOCK_SIZE);
+    }
+    #endif
+    // Any cached writes to the sector are superseded.
+    cached_sector_t* cached = find_cached_sector(address);
+    if (cached != NULL) {
+        cached->sector = NO_SECTOR_LOADED;
+        cached->dirty_mask = 0;
+    }
+    // Skip the erase when the new data only clears bits, for example because
+    // the sector is already erased. Unchanged pages aren't programmed at all.
+    uint32_t pages_per_sector = SPI_FLASH_ERASE_SIZE / SPI_FLASH_PAGE_SIZE;
+    uint32_t changed_pages = 0;
+    bool needs_erase = false;
+    for (uint32_t i = 0; i < pages_per_sector; i++) {
+        bool changed;
+        if (!page_programmable(address + i * SPI_FLASH_PAGE_SIZE, data + i * SPI_FLASH_PAGE_SIZE,
+                               &changed)) {
+            needs_erase = true;
+            break;
+        }
+        if (changed) {
+            changed_pages |= 1 << i;
+        }
+    }
+    if (needs_erase) {
+        if (!erase_sector(address)) {
+            return false;
+        }
+        changed_pages = 0xffffffff;
+    }
+    for (uint32_t i = 0; i < pages_per_sector; i++) {
+        if ((changed_pages & (1 << i)) != 0 &&
+            !write_flash(address + i * SPI_FLASH_PAGE_SIZE, data + i * SPI_FLASH_PAGE_SIZE,
+                         SPI_FLASH_PAGE_SIZE)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 mp_uint_t supervisor_flash_read_blocks(uint8_t *dest, uint32_t block_num, uint32_t num_blocks) {
-    for (size_t i = 0; i < num_blocks; i++) {
-        if (!external_flash_read_block(dest + i * FILESYSTEM_BLOCK_SIZE, block_num + i)) {
+    #if EXTERNAL_FLASH_TRANSLATION_LAYER
+    if (!translation_mounted) {
+        return 1; // error
+    }
+    return flash_translation_read_blocks(&translation, dest, block_num, num_blocks) ? 0 : 1;
+    #endif
+    if (num_blocks == 1) {
+        return external_flash_read_block(dest, block_num) ? 0 : 1;
+    }
+    if (convert_block_to_flash_addr(block_num + num_blocks - 1) == -1) {
+        // bad block number
+        return 1; // error
+    }
+    // Read runs of adjacent blocks with a single read command. Only blocks with
+    // unflushed writes have to be read individually from the write cache.
+    uint32_t i = 0;
+    while (i < num_blocks) {
+        uint32_t address = convert_block_to_flash_addr(block_num + i);
+        uint8_t block_index;
+        uint32_t run = 0;
+        while (i + run < num_blocks &&
+               !block_in_write_cache(address + run * FILESYSTEM_BLOCK_SIZE, &block_index)) {
+            run++;
+        }
+        if (run == 0) {
+            if (!external_flash_read_block(dest + i * FILESYSTEM_BLOCK_SIZE, block_num + i)) {
+                return 1; // error
+            }
+            i++;
+            continue;
+        }
+        if (!read_flash(address, dest + i * FILESYSTEM_BLOCK_SIZE, run * FILESYSTEM_BLOCK_SIZE)) {
             return 1; // error
         }
+        i += run;
     }
     return 0; // success
 }
 
 mp_uint_t supervisor_flash_write_blocks(const uint8_t *src, uint32_t block_num, uint32_t num_blocks) {
-    for (size_t i = 0; i < num_blocks; i++) {
-        if (!external_flash_write_block(src + i * FILESYSTEM_BLOCK_SIZE, block_num + i)) {
+    #if EXTERNAL_FLASH_TRANSLATION_LAYER
+    if (!translation_mounted) {
+        return 1; // error
+    }
+    #ifdef MICROPY_HW_LED_MSC
+        port_pin_set_output_level(MICROPY_HW_LED_MSC, true);
+    #endif
+    temp_status_color(ACTIVE_WRITE);
+    bool ok = flash_translation_write_blocks(&translation, src, block_num, num_blocks);
+    clear_temp_status();
+    #ifdef MICROPY_HW_LED_MSC
+        port_pin_set_output_level(MICROPY_HW_LED_MSC, false);
+    #endif
+    return ok ? 0 : 1;
+    #endif
+    // Whole sectors go straight to the flash. Partial sectors at either end of
+    // the request are merged with the rest of their sector in the cache.
+    uint8_t blocks_per_sector = SPI_FLASH_ERASE_SIZE / FILESYSTEM_BLOCK_SIZE;
+    size_t i = 0;
+    while (i < num_blocks) {
+        uint32_t block = block_num + i;
+        const uint8_t* data = src + i * FILESYSTEM_BLOCK_SIZE;
+        if (block % blocks_per_sector == 0 && num_blocks - i >= blocks_per_sector) {
+            if (!write_sector(data, block)) {
+                return 1; // error
+            }
+            i += blocks_per_sector;
+            continue;
+        }
+        if (!external_flash_write_block(data, block)) {
             return 1; // error
         }
+        i++;
     }
     return 0; // success
 }
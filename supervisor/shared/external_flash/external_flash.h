@@ -45,4 +45,29 @@
 #define SPI_FLASH_MAX_BAUDRATE 8000000
 #endif
 
+// Number of erase sectors that the write-back cache can hold in RAM. Each one
+// costs SPI_FLASH_ERASE_SIZE bytes of RAM while the cache is in use. Fewer are
+// used when there isn't enough RAM available.
+#ifndef EXTERNAL_FLASH_CACHE_SECTORS
+#define EXTERNAL_FLASH_CACHE_SECTORS 1
+#endif
+
+// Number of recently read blocks to keep in RAM. Each one costs
+// FILESYSTEM_BLOCK_SIZE bytes of RAM. 0 disables the read cache.
+#ifndef EXTERNAL_FLASH_READ_CACHE_BLOCKS
+#define EXTERNAL_FLASH_READ_CACHE_BLOCKS 0
+#endif
+
+// Store the filesystem through the wear leveling flash translation layer in
+// supervisor/shared/flash_translation.c instead of mapping blocks directly onto
+// the flash. Switching this on or off loses the existing filesystem.
+#ifndef EXTERNAL_FLASH_TRANSLATION_LAYER
+#define EXTERNAL_FLASH_TRANSLATION_LAYER 0
+#endif
+
+#if EXTERNAL_FLASH_TRANSLATION_LAYER
+// Reclaims space and levels wear a little at a time while idle.
+void external_flash_background(void);
+#endif
+
 #endif  // MICROPY_INCLUDED_SUPERVISOR_SHARED_EXTERNAL_FLASH_EXTERNAL_FLASH_H
@@ -45,6 +45,9 @@ void filesystem_background(void) {
         filesystem_flush_interval_ms = CIRCUITPY_FILESYSTEM_FLUSH_INTERVAL_MS;
         // Flush but keep caches
         supervisor_flash_flush();
+        #if defined(EXTERNAL_FLASH_DEVICE_COUNT) && EXTERNAL_FLASH_TRANSLATION_LAYER
+        external_flash_background();
+        #endif
         filesystem_flush_requested = false;
     }
 }
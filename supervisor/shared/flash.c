@@ -87,9 +87,6 @@ static void build_partition(uint8_t *buf, int boot, int type, uint32_t start_blo
 
 mp_uint_t flash_read_blocks(uint8_t *dest, uint32_t block_num, uint32_t num_blocks) {
     if (block_num == 0) {
-        if (block_num > 1) {
-            return 1; // error
-        }
         // fake the MBR so we can decide on our own partition table
 
         for (int i = 0; i < 446; i++) {
@@ -104,22 +101,48 @@ mp_uint_t flash_read_blocks(uint8_t *dest, uint32_t block_num, uint32_t num_bloc
         dest[510] = 0x55;
         dest[511] = 0xaa;
 
-        return 0; // ok
-
+        if (num_blocks == 1) {
+            return 0; // ok
+        }
+        // Read the rest of a multi-block request from the partition.
+        dest += FILESYSTEM_BLOCK_SIZE;
+        block_num++;
+        num_blocks--;
     }
     return supervisor_flash_read_blocks(dest, block_num - PART1_START_BLOCK, num_blocks);
 }
 
 mp_uint_t flash_write_blocks(const uint8_t *src, uint32_t block_num, uint32_t num_blocks) {
     if (block_num == 0) {
-        if (num_blocks > 1) {
-            return 1; // error
-        }
         // can't write MBR, but pretend we did
-        return 0;
-    } else {
-        return supervisor_flash_write_blocks(src, block_num - PART1_START_BLOCK, num_blocks);
+        if (num_blocks == 1) {
+            return 0;
+        }
+        src += FILESYSTEM_BLOCK_SIZE;
+        block_num++;
+        num_blocks--;
+    }
+    return supervisor_flash_write_blocks(src, block_num - PART1_START_BLOCK, num_blocks);
+}
+
+MP_WEAK const uint8_t *supervisor_flash_get_block_address(uint32_t block_num) {
+    return NULL;
+}
+
+// Returns a read-only view of the flash from the given block to the end of the
+// partition, so that files stored in it can be used in place.
+STATIC mp_obj_t flash_get_buffer(uint32_t block_num) {
+    if (block_num < PART1_START_BLOCK || block_num >= flash_get_block_count()) {
+        // the MBR only exists when it is read
+        return mp_const_none;
+    }
+    block_num -= PART1_START_BLOCK;
+    const uint8_t *addr = supervisor_flash_get_block_address(block_num);
+    if (addr == NULL) {
+        return mp_const_none;
     }
+    size_t len = (supervisor_flash_get_block_count() - block_num) * FILESYSTEM_BLOCK_SIZE;
+    return mp_obj_new_memoryview('B', len, (void*)addr);
 }
 
 STATIC mp_obj_t supervisor_flash_obj_readblocks(mp_obj_t self, mp_obj_t block_num, mp_obj_t buf) {
@@ -146,6 +169,7 @@ STATIC mp_obj_t supervisor_flash_obj_ioctl(mp_obj_t self, mp_obj_t cmd_in, mp_ob
         case BP_IOCTL_SYNC: supervisor_flash_flush(); return MP_OBJ_NEW_SMALL_INT(0);
         case BP_IOCTL_SEC_COUNT: return MP_OBJ_NEW_SMALL_INT(flash_get_block_count());
         case BP_IOCTL_SEC_SIZE: return MP_OBJ_NEW_SMALL_INT(supervisor_flash_get_block_size());
+        case BP_IOCTL_BUFFER: return flash_get_buffer(mp_obj_get_int(arg_in));
         default: return mp_const_none;
     }
 }
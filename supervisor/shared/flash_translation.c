@@ -0,0 +1,495 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "supervisor/shared/flash_translation.h"
+
+#include <string.h>
+
+#define FTL_MAGIC 0x4c544643 // "CFTL"
+#define NO_SLOT 0xffff
+#define NO_SECTOR 0xffff
+#define UNPROGRAMMED 0xffffffff
+
+// Set on sectors whose metadata is unreadable, usually because an erase was
+// interrupted. They are erased during mount.
+#define SECTOR_NEEDS_ERASE 0x01
+
+typedef struct {
+    uint32_t magic;
+    uint32_t erase_count;
+    uint32_t reserved[2];
+} sector_header_t;
+
+typedef struct {
+    uint32_t block;
+    uint32_t sequence;
+    uint32_t check;
+    // Programmed to zero once the data and the fields above are on the flash.
+    uint32_t commit;
+} slot_entry_t;
+
+typedef struct {
+    sector_header_t header;
+    slot_entry_t entries[FLASH_TRANSLATION_SLOTS_PER_SECTOR];
+} sector_metadata_t;
+
+// Slots are numbered across the whole region, sector by sector. The map stores
+// them as 16 bit values so the region size is limited accordingly.
+#define MAX_SECTORS ((NO_SLOT - 1) / FLASH_TRANSLATION_SLOTS_PER_SECTOR)
+
+static inline uint32_t sector_address(uint16_t sector) {
+    return sector * FLASH_TRANSLATION_SECTOR_SIZE;
+}
+
+static inline uint16_t slot_sector(uint16_t slot) {
+    return slot / FLASH_TRANSLATION_SLOTS_PER_SECTOR;
+}
+
+static inline uint32_t slot_address(uint16_t slot) {
+    return sector_address(slot_sector(slot)) +
+        (slot % FLASH_TRANSLATION_SLOTS_PER_SECTOR + 1) * FLASH_TRANSLATION_BLOCK_SIZE;
+}
+
+static inline uint32_t entry_address(uint16_t slot) {
+    return sector_address(slot_sector(slot)) + offsetof(sector_metadata_t, entries) +
+        (slot % FLASH_TRANSLATION_SLOTS_PER_SECTOR) * sizeof(slot_entry_t);
+}
+
+static inline uint32_t entry_check(uint32_t block, uint32_t sequence) {
+    return block ^ sequence ^ FTL_MAGIC;
+}
+
+static bool entry_committed(flash_translation_t* self, const slot_entry_t* entry) {
+    return entry->commit == 0 && entry->check == entry_check(entry->block, entry->sequence) &&
+        entry->block < self->block_count;
+}
+
+static bool entry_blank(const slot_entry_t* entry) {
+    return entry->block == UNPROGRAMMED && entry->sequence == UNPROGRAMMED &&
+        entry->check == UNPROGRAMMED && entry->commit == UNPROGRAMMED;
+}
+
+static inline bool sector_free(flash_translation_t* self, uint16_t sector) {
+    const flash_translation_sector_t* info = &self->sectors[sector];
+    return sector != self->active && info->write_index == 0 && info->flags == 0;
+}
+
+static inline uint8_t active_room(flash_translation_t* self) {
+    if (self->active == NO_SECTOR) {
+        return 0;
+    }
+    return FLASH_TRANSLATION_SLOTS_PER_SECTOR - self->sectors[self->active].write_index;
+}
+
+// Sectors kept back from the logical capacity. More of them means less data to
+// move during garbage collection. At least three are needed: one being written,
+// one free for collection to move data into and one spare for recovering from
+// a collection that was interrupted by power loss.
+static uint16_t sectors_reserved(uint16_t sector_count) {
+    return 3 + sector_count / 16;
+}
+
+size_t flash_translation_ram_size(uint16_t sector_count) {
+    if (sector_count > MAX_SECTORS) {
+        sector_count = MAX_SECTORS;
+    }
+    size_t blocks = 0;
+    if (sector_count > sectors_reserved(sector_count)) {
+        blocks = (sector_count - sectors_reserved(sector_count)) * FLASH_TRANSLATION_SLOTS_PER_SECTOR;
+    }
+    return sector_count * sizeof(flash_translation_sector_t) + blocks * sizeof(uint16_t);
+}
+
+void flash_translation_init(flash_translation_t* self, const flash_translation_ops_t* ops,
+    uint16_t sector_count, void* ram) {
+    if (sector_count > MAX_SECTORS) {
+        sector_count = MAX_SECTORS;
+    }
+    self->ops = ops;
+    self->sector_count = sector_count;
+    self->reserve = sectors_reserved(sector_count);
+    self->block_count = 0;
+    if (sector_count > self->reserve) {
+        self->block_count = (sector_count - self->reserve) * FLASH_TRANSLATION_SLOTS_PER_SECTOR;
+    }
+    self->sectors = ram;
+    self->map = (uint16_t*) (self->sectors + sector_count);
+    self->next_sequence = 0;
+    self->free_count = 0;
+    self->active = NO_SECTOR;
+    memset(&self->stats, 0, sizeof(self->stats));
+}
+
+// Erases the sector and writes a fresh header to it. The sector becomes free.
+static bool erase_sector(flash_translation_t* self, uint16_t sector) {
+    flash_translation_sector_t* info = &self->sectors[sector];
+    sector_header_t header;
+    memset(&header, 0xff, sizeof(header));
+    header.magic = FTL_MAGIC;
+    header.erase_count = info->erase_count + 1;
+    if (!self->ops->erase(self, sector_address(sector))) {
+        return false;
+    }
+    self->stats.erases++;
+    info->erase_count = header.erase_count;
+    info->valid = 0;
+    info->write_index = 0;
+    info->flags = 0;
+    if (sector == self->active) {
+        self->active = NO_SECTOR;
+    }
+    self->free_count++;
+    return self->ops->program(self, sector_address(sector), (const uint8_t*) &header, sizeof(header));
+}
+
+// Makes the least worn free sector the one new blocks are written to.
+static bool open_active(flash_translation_t* self) {
+    uint16_t best = NO_SECTOR;
+    for (uint16_t i = 0; i < self->sector_count; i++) {
+        if (sector_free(self, i) &&
+            (best == NO_SECTOR || self->sectors[i].erase_count < self->sectors[best].erase_count)) {
+            best = i;
+        }
+    }
+    if (best == NO_SECTOR) {
+        return false;
+    }
+    self->active = best;
+    self->free_count--;
+    return true;
+}
+
+// Writes data for block into the next slot of the active sector and maps it.
+// The slot is used up even if programming fails part way so it is never
+// programmed twice.
+static bool program_slot(flash_translation_t* self, uint32_t block, const uint8_t* data) {
+    flash_translation_sector_t* info = &self->sectors[self->active];
+    uint16_t slot = self->active * FLASH_TRANSLATION_SLOTS_PER_SECTOR + info->write_index;
+    info->write_index++;
+
+    slot_entry_t entry;
+    entry.block = block;
+    entry.sequence = self->next_sequence++;
+    entry.check = entry_check(entry.block, entry.sequence);
+    uint32_t commit = 0;
+    if (!self->ops->program(self, slot_address(slot), data, FLASH_TRANSLATION_BLOCK_SIZE) ||
+        !self->ops->program(self, entry_address(slot), (const uint8_t*) &entry,
+                            offsetof(slot_entry_t, commit)) ||
+        !self->ops->program(self, entry_address(slot) + offsetof(slot_entry_t, commit),
+                            (const uint8_t*) &commit, sizeof(commit))) {
+        return false;
+    }
+    self->stats.programs++;
+
+    uint16_t old = self->map[block];
+    if (old != NO_SLOT) {
+        self->sectors[slot_sector(old)].valid--;
+    }
+    self->map[block] = slot;
+    info->valid++;
+    return true;
+}
+
+// Moves the live blocks out of the sector and erases it. The active sector must
+// have room for all of them. The copies are committed before the erase so a
+// power loss in between leaves both, and the newer sequence number wins.
+static bool collect_sector(flash_translation_t* self, uint16_t sector) {
+    sector_metadata_t metadata;
+    if (!self->ops->read(self, sector_address(sector), (uint8_t*) &metadata, sizeof(metadata))) {
+        return false;
+    }
+    uint8_t buffer[FLASH_TRANSLATION_BLOCK_SIZE];
+    for (uint8_t i = 0; i < self->sectors[sector].write_index && self->sectors[sector].valid > 0; i++) {
+        const slot_entry_t* entry = &metadata.entries[i];
+        uint16_t slot = sector * FLASH_TRANSLATION_SLOTS_PER_SECTOR + i;
+        if (!entry_committed(self, entry) || self->map[entry->block] != slot) {
+            continue;
+        }
+        if (!self->ops->read(self, slot_address(slot), buffer, FLASH_TRANSLATION_BLOCK_SIZE) ||
+            !program_slot(self, entry->block, buffer)) {
+            return false;
+        }
+        self->stats.relocations++;
+    }
+    return erase_sector(self, sector);
+}
+
+// Finds the sector that frees the most slots when collected, out of those with
+// no more than max_valid live blocks.
+static uint16_t pick_victim(flash_translation_t* self, uint8_t max_valid) {
+    uint16_t best = NO_SECTOR;
+    for (uint16_t i = 0; i < self->sector_count; i++) {
+        const flash_translation_sector_t* info = &self->sectors[i];
+        if (i == self->active || info->write_index == 0 || info->valid == info->write_index ||
+            info->valid > max_valid) {
+            continue;
+        }
+        if (best == NO_SECTOR || info->valid < self->sectors[best].valid ||
+            (info->valid == self->sectors[best].valid &&
+             info->erase_count < self->sectors[best].erase_count)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+// Makes sure the active sector can take another block. Two free sectors are
+// kept so that there is always somewhere to move data to, even when a previous
+// collection was cut short and used up some of the room it was counting on.
+static bool make_room(flash_translation_t* self) {
+    while (active_room(self) == 0 || self->free_count < 2) {
+        uint8_t room = active_room(self);
+        if (room > 0) {
+            uint16_t victim = pick_victim(self, room);
+            if (victim != NO_SECTOR) {
+                if (!collect_sector(self, victim)) {
+                    return false;
+                }
+                continue;
+            }
+            // Nothing fits. Carry on with the room that is left rather than
+            // giving up on a sector nothing has been written to.
+            if (self->free_count == 0 || room == FLASH_TRANSLATION_SLOTS_PER_SECTOR) {
+                return true;
+            }
+        }
+        if (!open_active(self)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool flash_translation_mount(flash_translation_t* self) {
+    memset(self->map, 0xff, self->block_count * sizeof(uint16_t));
+    self->next_sequence = 0;
+    self->free_count = 0;
+    self->active = NO_SECTOR;
+
+    sector_metadata_t metadata;
+    uint8_t buffer[FLASH_TRANSLATION_BLOCK_SIZE];
+    uint32_t max_erase_count = 0;
+    for (uint16_t sector = 0; sector < self->sector_count; sector++) {
+        flash_translation_sector_t* info = &self->sectors[sector];
+        if (!self->ops->read(self, sector_address(sector), (uint8_t*) &metadata, sizeof(metadata))) {
+            return false;
+        }
+        info->valid = 0;
+        info->write_index = 0;
+        info->flags = 0;
+        if (metadata.header.magic != FTL_MAGIC) {
+            info->erase_count = 0;
+            info->flags = SECTOR_NEEDS_ERASE;
+            continue;
+        }
+        info->erase_count = metadata.header.erase_count;
+        if (info->erase_count > max_erase_count) {
+            max_erase_count = info->erase_count;
+        }
+        for (uint8_t i = 0; i < FLASH_TRANSLATION_SLOTS_PER_SECTOR; i++) {
+            const slot_entry_t* entry = &metadata.entries[i];
+            // A slot whose data was torn has a blank entry, so keep looking
+            // past blank entries for slots written after it.
+            if (entry_blank(entry)) {
+                continue;
+            }
+            info->write_index = i + 1;
+            if (!entry_committed(self, entry)) {
+                continue;
+            }
+            if (entry->sequence >= self->next_sequence) {
+                self->next_sequence = entry->sequence + 1;
+            }
+            uint16_t slot = sector * FLASH_TRANSLATION_SLOTS_PER_SECTOR + i;
+            uint16_t current = self->map[entry->block];
+            if (current != NO_SLOT) {
+                slot_entry_t current_entry;
+                if (!self->ops->read(self, entry_address(current), (uint8_t*) &current_entry,
+                                     sizeof(current_entry))) {
+                    return false;
+                }
+                if (current_entry.sequence > entry->sequence) {
+                    continue;
+                }
+            }
+            self->map[entry->block] = slot;
+        }
+        // Data may have been programmed into slots after the last entry
+        // before power was lost, once for each time it was. Skip over them.
+        while (info->write_index < FLASH_TRANSLATION_SLOTS_PER_SECTOR) {
+            uint16_t slot = sector * FLASH_TRANSLATION_SLOTS_PER_SECTOR + info->write_index;
+            if (!self->ops->read(self, slot_address(slot), buffer, FLASH_TRANSLATION_BLOCK_SIZE)) {
+                return false;
+            }
+            bool blank = true;
+            for (uint16_t j = 0; j < FLASH_TRANSLATION_BLOCK_SIZE; j++) {
+                if (buffer[j] != 0xff) {
+                    blank = false;
+                    break;
+                }
+            }
+            if (blank) {
+                break;
+            }
+            info->write_index++;
+        }
+    }
+
+    for (uint32_t block = 0; block < self->block_count; block++) {
+        if (self->map[block] != NO_SLOT) {
+            self->sectors[slot_sector(self->map[block])].valid++;
+        }
+    }
+
+    for (uint16_t sector = 0; sector < self->sector_count; sector++) {
+        flash_translation_sector_t* info = &self->sectors[sector];
+        if ((info->flags & SECTOR_NEEDS_ERASE) != 0) {
+            // The erase count was lost so assume the worst.
+            info->erase_count = max_erase_count;
+            if (!erase_sector(self, sector)) {
+                return false;
+            }
+        } else if (info->write_index == 0) {
+            self->free_count++;
+        } else if (info->write_index < FLASH_TRANSLATION_SLOTS_PER_SECTOR &&
+                   (self->active == NO_SECTOR ||
+                    info->write_index < self->sectors[self->active].write_index)) {
+            self->active = sector;
+        }
+    }
+    // Keep writing to the partially filled sector with the most room. Any
+    // others are left as they are until they get collected.
+    for (uint16_t sector = 0; sector < self->sector_count; sector++) {
+        flash_translation_sector_t* info = &self->sectors[sector];
+        if (sector != self->active && info->write_index > 0) {
+            info->write_index = FLASH_TRANSLATION_SLOTS_PER_SECTOR;
+        }
+    }
+    return true;
+}
+
+bool flash_translation_read_blocks(flash_translation_t* self, uint8_t* dest, uint32_t block, uint32_t count) {
+    if (block + count > self->block_count || block + count < block) {
+        return false;
+    }
+    uint32_t i = 0;
+    while (i < count) {
+        uint16_t slot = self->map[block + i];
+        if (slot == NO_SLOT) {
+            memset(dest + i * FLASH_TRANSLATION_BLOCK_SIZE, 0xff, FLASH_TRANSLATION_BLOCK_SIZE);
+            i++;
+            continue;
+        }
+        // Blocks written one after another usually sit in adjacent slots so
+        // read them together.
+        uint32_t run = 1;
+        while (i + run < count && self->map[block + i + run] == slot + run &&
+               slot_sector(slot + run) == slot_sector(slot)) {
+            run++;
+        }
+        if (!self->ops->read(self, slot_address(slot), dest + i * FLASH_TRANSLATION_BLOCK_SIZE,
+                             run * FLASH_TRANSLATION_BLOCK_SIZE)) {
+            return false;
+        }
+        i += run;
+    }
+    return true;
+}
+
+bool flash_translation_write_blocks(flash_translation_t* self, const uint8_t* src, uint32_t block, uint32_t count) {
+    if (block + count > self->block_count || block + count < block) {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        self->stats.host_writes++;
+        if (!make_room(self) ||
+            !program_slot(self, block + i, src + i * FLASH_TRANSLATION_BLOCK_SIZE)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Collects sector if the active sector has room for its live blocks, opening a
+// new one when that leaves a free sector for make_room to collect into.
+static bool background_collect(flash_translation_t* self, uint16_t sector) {
+    if (active_room(self) < self->sectors[sector].valid) {
+        if (self->free_count < 2 || !open_active(self)) {
+            return false;
+        }
+    }
+    return collect_sector(self, sector);
+}
+
+bool flash_translation_background(flash_translation_t* self) {
+    if (self->block_count == 0) {
+        return false;
+    }
+    // Static wear leveling. Data that never changes pins its sectors at a low
+    // erase count, so move it out once they fall too far behind and let the
+    // sector take its share of the writes.
+    uint16_t coldest = NO_SECTOR;
+    uint32_t max_erase_count = 0;
+    for (uint16_t i = 0; i < self->sector_count; i++) {
+        const flash_translation_sector_t* info = &self->sectors[i];
+        if (info->erase_count > max_erase_count) {
+            max_erase_count = info->erase_count;
+        }
+        if (i != self->active && info->write_index > 0 &&
+            (coldest == NO_SECTOR || info->erase_count < self->sectors[coldest].erase_count)) {
+            coldest = i;
+        }
+    }
+    if (coldest != NO_SECTOR &&
+        max_erase_count - self->sectors[coldest].erase_count > FLASH_TRANSLATION_WEAR_LEVEL_THRESHOLD &&
+        background_collect(self, coldest)) {
+        return true;
+    }
+    if (self->free_count < self->reserve) {
+        uint16_t victim = pick_victim(self, FLASH_TRANSLATION_SLOTS_PER_SECTOR);
+        if (victim != NO_SECTOR) {
+            return background_collect(self, victim);
+        }
+    }
+    return false;
+}
+
+void flash_translation_get_stats(flash_translation_t* self, flash_translation_stats_t* stats) {
+    *stats = self->stats;
+    stats->min_erase_count = UNPROGRAMMED;
+    stats->max_erase_count = 0;
+    for (uint16_t i = 0; i < self->sector_count; i++) {
+        uint32_t erase_count = self->sectors[i].erase_count;
+        if (erase_count < stats->min_erase_count) {
+            stats->min_erase_count = erase_count;
+        }
+        if (erase_count > stats->max_erase_count) {
+            stats->max_erase_count = erase_count;
+        }
+    }
+    if (self->sector_count == 0) {
+        stats->min_erase_count = 0;
+    }
+}
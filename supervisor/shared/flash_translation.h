@@ -0,0 +1,121 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MICROPY_INCLUDED_SUPERVISOR_SHARED_FLASH_TRANSLATION_H
+#define MICROPY_INCLUDED_SUPERVISOR_SHARED_FLASH_TRANSLATION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// A log-structured flash translation layer for NOR flash. Logical blocks are
+// never rewritten in place. Each write goes to the next free slot of the active
+// erase sector and the block map is updated to point at it. Stale copies are
+// reclaimed by garbage collection, which moves the live blocks of the sector
+// with the least live data and then erases it. Erases are spread across the
+// device by always opening the least worn free sector and by occasionally
+// moving cold data out of little worn sectors.
+//
+// Each erase sector starts with a metadata slot followed by data slots. The
+// metadata holds the sector's erase count and one entry per data slot naming
+// the logical block stored in it along with a sequence number. Entries are
+// programmed after their data and committed with a separate program, so a slot
+// torn by power loss is never mapped. The map is rebuilt on mount from the
+// newest committed copy of every logical block.
+
+#define FLASH_TRANSLATION_SECTOR_SIZE (4096)
+#define FLASH_TRANSLATION_BLOCK_SIZE (512)
+#define FLASH_TRANSLATION_SLOTS_PER_SECTOR (FLASH_TRANSLATION_SECTOR_SIZE / FLASH_TRANSLATION_BLOCK_SIZE - 1)
+
+// Wear difference between the most and least erased sectors that triggers
+// static wear leveling in the background.
+#ifndef FLASH_TRANSLATION_WEAR_LEVEL_THRESHOLD
+#define FLASH_TRANSLATION_WEAR_LEVEL_THRESHOLD (64)
+#endif
+
+struct _flash_translation_t;
+
+// Access to the physical flash. Addresses are relative to the start of the
+// translated region. program only ever clears bits.
+typedef struct {
+    bool (*read)(struct _flash_translation_t* self, uint32_t address, uint8_t* data, uint32_t length);
+    bool (*program)(struct _flash_translation_t* self, uint32_t address, const uint8_t* data, uint32_t length);
+    bool (*erase)(struct _flash_translation_t* self, uint32_t sector_address);
+} flash_translation_ops_t;
+
+typedef struct {
+    uint32_t erase_count;
+    uint8_t valid;
+    uint8_t write_index;
+    uint8_t flags;
+} flash_translation_sector_t;
+
+typedef struct {
+    // Logical blocks written by the filesystem.
+    uint32_t host_writes;
+    // Data slots programmed, including ones moved by garbage collection.
+    uint32_t programs;
+    uint32_t erases;
+    uint32_t relocations;
+    uint32_t min_erase_count;
+    uint32_t max_erase_count;
+} flash_translation_stats_t;
+
+typedef struct _flash_translation_t {
+    const flash_translation_ops_t* ops;
+    uint16_t* map;
+    flash_translation_sector_t* sectors;
+    uint32_t block_count;
+    uint32_t next_sequence;
+    uint16_t sector_count;
+    uint16_t reserve;
+    uint16_t free_count;
+    uint16_t active;
+    flash_translation_stats_t stats;
+} flash_translation_t;
+
+// RAM needed by flash_translation_init for a region of sector_count sectors.
+size_t flash_translation_ram_size(uint16_t sector_count);
+
+// Sets up self for a region of sector_count erase sectors. ram must be at least
+// flash_translation_ram_size(sector_count) bytes and stays in use until the
+// layer is no longer needed.
+void flash_translation_init(flash_translation_t* self, const flash_translation_ops_t* ops,
+    uint16_t sector_count, void* ram);
+
+// Rebuilds the block map from flash. Sectors without valid metadata, such as
+// on a fresh device, are erased. Returns false if the flash couldn't be read.
+bool flash_translation_mount(flash_translation_t* self);
+
+bool flash_translation_read_blocks(flash_translation_t* self, uint8_t* dest, uint32_t block, uint32_t count);
+bool flash_translation_write_blocks(flash_translation_t* self, const uint8_t* src, uint32_t block, uint32_t count);
+
+// Does at most one sector's worth of garbage collection or wear leveling so it
+// can be called while idle. Returns true if there was work to do.
+bool flash_translation_background(flash_translation_t* self);
+
+void flash_translation_get_stats(flash_translation_t* self, flash_translation_stats_t* stats);
+
+#endif  // MICROPY_INCLUDED_SUPERVISOR_SHARED_FLASH_TRANSLATION_H
@@ -39,6 +39,10 @@ static volatile uint32_t background_ticks_ms32;
 #include "shared-module/gamepadshift/__init__.h"
 #endif
 
+#if MICROPY_PY_UPROFILE
+#include "extmod/moduprofile.h"
+#endif
+
 #include "shared-bindings/microcontroller/__init__.h"
 
 void supervisor_tick(void) {
@@ -61,6 +65,9 @@ void supervisor_tick(void) {
         #endif
     }
 #endif
+#if MICROPY_PY_UPROFILE
+    uprofile_tick();
+#endif
 }
 
 uint64_t supervisor_ticks_ms64() {
@@ -30,6 +30,18 @@
 #include <stdint.h>
 #include <string.h>
 
+// Look up the first TRANSLATE_DECODE_TABLE_BITS bits of each code in decode_table and only walk
+// the code a bit at a time when it is longer than that. Must match DECODE_TABLE_BITS in
+// py/makeqstrdata.py.
+#ifndef CIRCUITPY_TRANSLATE_DECODE_TABLE
+#define CIRCUITPY_TRANSLATE_DECODE_TABLE (1)
+#endif
+#if CIRCUITPY_TRANSLATE_DECODE_TABLE
+#define TRANSLATE_DECODE_TABLE_BITS (8)
+#else
+#define TRANSLATE_DECODE_TABLE_BITS (0)
+#endif
+
 #ifndef NO_QSTR
 #include "genhdr/compression.generated.h"
 #endif
@@ -58,37 +70,43 @@ STATIC int put_utf8(char *buf, int u) {
     }
 }
 
+// Returns the index into values of the code starting at bit_pos and advances bit_pos past it.
+STATIC uint16_t decode_code(const uint8_t* data, uint32_t* bit_pos) {
+    uint32_t pos = *bit_pos;
+    #if TRANSLATE_DECODE_TABLE_BITS > 0
+    // The codes are packed MSB first. This may read a byte past the end but those bits are never
+    // part of a code.
+    uint32_t window = (data[pos >> 3] << 8) | data[(pos >> 3) + 1];
+    window = (window >> (16 - TRANSLATE_DECODE_TABLE_BITS - (pos & 7))) & ((1 << TRANSLATE_DECODE_TABLE_BITS) - 1);
+    uint16_t entry = decode_table[window];
+    if (entry != 0) {
+        *bit_pos = pos + (entry >> 12);
+        return entry & 0xfff;
+    }
+    #endif
+    uint32_t bits = 0;
+    uint8_t bit_length = 0;
+    uint32_t max_code = lengths[0];
+    uint32_t searched_length = lengths[0];
+    while (true) {
+        bits = (bits << 1) | ((data[pos >> 3] >> (7 - (pos & 7))) & 1);
+        pos += 1;
+        bit_length += 1;
+        if (max_code > 0 && bits < max_code) {
+            break;
+        }
+        max_code = (max_code << 1) + lengths[bit_length];
+        searched_length += lengths[bit_length];
+    }
+    *bit_pos = pos;
+    return searched_length + bits - max_code;
+}
+
 char* decompress(const compressed_string_t* compressed, char* decompressed) {
-    uint8_t this_byte = 0;
-    uint8_t this_bit = 7;
-    uint8_t b = compressed->data[this_byte];
+    uint32_t bit_pos = 0;
     // Stop one early because the last byte is always NULL.
     for (uint16_t i = 0; i < compressed->length - 1;) {
-        uint32_t bits = 0;
-        uint8_t bit_length = 0;
-        uint32_t max_code = lengths[0];
-        uint32_t searched_length = lengths[0];
-        while (true) {
-            bits <<= 1;
-            if ((0x80 & b) != 0) {
-                bits |= 1;
-            }
-            b <<= 1;
-            bit_length += 1;
-            if (this_bit == 0) {
-                this_bit = 7;
-                this_byte += 1;
-                b = compressed->data[this_byte]; // This may read past the end but its never used.
-            } else {
-                this_bit -= 1;
-            }
-            if (max_code > 0 && bits < max_code) {
-                break;
-            }
-            max_code = (max_code << 1) + lengths[bit_length];
-            searched_length += lengths[bit_length];
-        }
-        i += put_utf8(decompressed + i, values[searched_length + bits - max_code]);
+        i += put_utf8(decompressed + i, values[decode_code(compressed->data, &bit_pos)]);
     }
 
     decompressed[compressed->length-1] = '\0';
@@ -97,6 +97,11 @@
 // Number of Blocks
 #define CFG_TUD_MSC_BLOCK_NUM       (256*1024)/512
 
+// Buffer for READ10 and WRITE10 data. Each callback gets up to this much at once.
+#ifndef CFG_TUD_MSC_BUFSIZE
+#define CFG_TUD_MSC_BUFSIZE         4096
+#endif
+
 
 
 // Product revision string included in Inquiry response, max 4 bytes
@@ -78,6 +78,9 @@ void usb_background(void) {
     if (usb_enabled()) {
         tud_task();
         tud_cdc_write_flush();
+#if CIRCUITPY_USB_MIDI
+        usb_midi_background();
+#endif
     }
 }
 
@@ -134,8 +134,11 @@ int32_t tud_msc_read10_cb (uint8_t lun, uint32_t lba, uint32_t offset, void* buf
 
     const uint32_t block_count = bufsize / MSC_FLASH_BLOCK_SIZE;
 
+    // The whole transfer goes to the flash driver as one multi-block read.
     fs_user_mount_t * vfs = get_vfs(lun);
-    disk_read(vfs, buffer, lba, block_count);
+    if (disk_read(vfs, buffer, lba, block_count) != RES_OK) {
+        return -1;
+    }
 
     return block_count * MSC_FLASH_BLOCK_SIZE;
 }
@@ -148,10 +151,15 @@ int32_t tud_msc_write10_cb (uint8_t lun, uint32_t lba, uint32_t offset, uint8_t*
 
     const uint32_t block_count = bufsize / MSC_FLASH_BLOCK_SIZE;
 
+    // The whole transfer goes to the flash driver as one multi-block write.
+    // Flash programs aren't waited on once started so tinyusb can receive
+    // the next transfer while the last one is still being programmed.
     fs_user_mount_t * vfs = get_vfs(lun);
-    disk_write(vfs, buffer, lba, block_count);
+    if (disk_write(vfs, buffer, lba, block_count) != RES_OK) {
+        return -1;
+    }
     // Since by getting here we assume the mount is read-only to
-    // MicroPython let's update the cached FatFs sector if it's the one
+    // MicroPython let's update the cached FatFs sector if it's one
     // we just wrote.
     #if _MAX_SS != _MIN_SS
     if (vfs->ssize == MSC_FLASH_BLOCK_SIZE) {
@@ -159,7 +167,8 @@ int32_t tud_msc_write10_cb (uint8_t lun, uint32_t lba, uint32_t offset, uint8_t*
     // The compiler can optimize this away.
     if (_MAX_SS == FILESYSTEM_BLOCK_SIZE) {
     #endif
-        if (lba == vfs->fatfs.winsect && lba > 0) {
+        if (vfs->fatfs.winsect >= lba && vfs->fatfs.winsect < lba + block_count &&
+            vfs->fatfs.winsect > 0) {
             memcpy(vfs->fatfs.win,
                    buffer + MSC_FLASH_BLOCK_SIZE * (vfs->fatfs.winsect - lba),
                    MSC_FLASH_BLOCK_SIZE);
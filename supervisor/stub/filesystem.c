@@ -39,6 +39,11 @@ bool filesystem_is_writable_by_python(fs_user_mount_t *vfs) {
     return true;
 }
 
+bool filesystem_is_writable_by_usb(fs_user_mount_t *vfs) {
+    (void) vfs;
+    return false;
+}
+
 bool filesystem_present(void) {
     return false;
 }
@@ -32,10 +32,21 @@ SPI_FLASH_FILESYSTEM = 0
 endif
 CFLAGS += -DSPI_FLASH_FILESYSTEM=$(SPI_FLASH_FILESYSTEM)
 
+# Size of the buffer that tinyusb hands to the MSC read and write callbacks. A
+# whole erase sector lets large USB transfers reach the flash in one request.
+ifndef USB_MSC_BUFSIZE
+USB_MSC_BUFSIZE = 4096
+endif
+CFLAGS += -DCFG_TUD_MSC_BUFSIZE=$(USB_MSC_BUFSIZE)
+
 ifeq ($(CIRCUITPY_BLEIO),1)
 	SRC_SUPERVISOR += supervisor/shared/bluetooth.c
 endif
 
+ifeq ($(CIRCUITPY_BACKGROUND_PROFILE),1)
+	SRC_SUPERVISOR += supervisor/shared/background_profile.c
+endif
+
 # Choose which flash filesystem impl to use.
 # (Right now INTERNAL_FLASH_FILESYSTEM and (Q)SPI_FLASH_FILESYSTEM are mutually exclusive.
 # But that might not be true in the future.)
@@ -44,6 +55,10 @@ ifdef EXTERNAL_FLASH_DEVICES
 				-DEXTERNAL_FLASH_DEVICE_COUNT=$(EXTERNAL_FLASH_DEVICE_COUNT)
 
 	SRC_SUPERVISOR += supervisor/shared/external_flash/external_flash.c
+	ifeq ($(EXTERNAL_FLASH_TRANSLATION_LAYER),1)
+		CFLAGS += -DEXTERNAL_FLASH_TRANSLATION_LAYER=1
+		SRC_SUPERVISOR += supervisor/shared/flash_translation.c
+	endif
 	ifeq ($(SPI_FLASH_FILESYSTEM),1)
 		SRC_SUPERVISOR += supervisor/shared/external_flash/spi_flash.c
 	else
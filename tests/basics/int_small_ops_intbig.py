@@ -0,0 +1,32 @@
+# test binary ops on small ints, including results that overflow to big ints
+
+def ops(a, b):
+    return (a + b, a - b, a * b, a & b, a | b, a ^ b,
+        a < b, a <= b, a > b, a >= b, a == b, a != b)
+
+for a in (0, 1, -1, 7, -100, 12345):
+    for b in (0, 1, -1, 3, -7, 1000):
+        print(a, b, ops(a, b))
+
+# results just outside the small-int range on 32 and 64 bit targets
+for n in (30, 31, 46, 47, 62, 63):
+    x = (1 << n) - 1
+    print(n, x + 1, -x - 2, x * 3, (x >> 1) * 2 + 2)
+
+# shifts
+for a in (1, -1, 12345, -12345):
+    for s in (0, 1, 13, 31, 32, 63, 64, 100):
+        print(a, s, a >> s)
+try:
+    1 >> -1
+except ValueError:
+    print("ValueError")
+
+# in-place forms in a loop
+i = 0
+t = 1
+while i < 70:
+    t *= 3
+    t -= 1
+    i += 1
+print(i, t)
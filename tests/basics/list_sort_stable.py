@@ -0,0 +1,57 @@
+# test that list.sort and sorted are stable and call the key function once per item
+
+# items that compare equal keep their order, also when reversed
+l = [(i % 5, i) for i in range(40)]
+print(sorted(l, key=lambda x: x[0]))
+print(sorted(l, key=lambda x: x[0], reverse=True))
+
+class A:
+    def __init__(self, k, v):
+        self.k = k
+        self.v = v
+    def __lt__(self, other):
+        return self.k < other.k
+    def __repr__(self):
+        return '%d:%d' % (self.k, self.v)
+l = [A((i * 7) % 4, i) for i in range(30)]
+l.sort()
+print(l)
+
+# long runs, in order and reversed, with a few items out of place
+for n in (10, 100, 300):
+    l = list(range(n)) + list(range(n, 0, -1)) + list(range(n))
+    l[n // 2] = -1
+    l2 = l[:]
+    l2.sort()
+    print(l2 == sorted(l), l2[:3], l2[-3:])
+
+# merging runs of many different lengths
+l = [(i * 7919) % 1009 for i in range(1009)]
+l.sort()
+print(l == list(range(1009)))
+
+# the key function is called exactly once per item
+calls = 0
+def key(x):
+    global calls
+    calls += 1
+    return -x
+l = list(range(200))
+print(sorted(l, key=key)[:5], calls)
+
+# an exception from a comparison leaves all the items in the list
+class B:
+    n = 0
+    def __init__(self, v):
+        self.v = v
+    def __lt__(self, other):
+        B.n += 1
+        if B.n == 1000:
+            raise ValueError
+        return self.v < other.v
+l = [B((i * 31) % 97) for i in range(300)]
+try:
+    l.sort()
+except ValueError:
+    print('ValueError')
+print(len(l), sorted(b.v for b in l) == sorted((i * 31) % 97 for i in range(300)))
@@ -0,0 +1,19 @@
+import array
+import bench
+import audiocore
+import audiomixer
+import audiosim
+
+# Pull buffers from a Mixer the way audio output does while one looping
+# sample plays.
+tone = audiocore.RawSample(array.array('h', [(i * 2731) % 16384 - 8192 for i in range(256)]), sample_rate=22050)
+mixer = audiomixer.Mixer(voice_count=1, sample_rate=22050, channel_count=1, bits_per_sample=16, samples_signed=True)
+audiosim.reset(mixer)
+mixer.voice[0].play(tone, loop=True)
+
+
+def test(num):
+    for i in range(num // 200):
+        audiosim.read(mixer)
+
+bench.run(test)
@@ -0,0 +1,20 @@
+import array
+import bench
+import audiocore
+import audiomixer
+import audiosim
+
+# Four looping samples at different levels, so every word is mixed and scaled.
+mixer = audiomixer.Mixer(voice_count=4, sample_rate=22050, channel_count=1, bits_per_sample=16, samples_signed=True)
+audiosim.reset(mixer)
+for v in range(4):
+    tone = audiocore.RawSample(array.array('h', [(i * (v + 3) * 911) % 16384 - 8192 for i in range(256)]), sample_rate=22050)
+    mixer.voice[v].level = 0.25 * (v + 1)
+    mixer.voice[v].play(tone, loop=True)
+
+
+def test(num):
+    for i in range(num // 200):
+        audiosim.read(mixer)
+
+bench.run(test)
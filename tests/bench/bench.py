@@ -1,4 +1,7 @@
-import time
+try:
+    import utime as time
+except ImportError:
+    import time
 
 
 ITERS = 20000000
@@ -0,0 +1,22 @@
+import bench
+
+
+# Shift bytes out MSB first through a port register, as a bit-banged SPI does.
+def shift_out(port, data, n):
+    for i in range(n):
+        b = data[i]
+        mask = 0x80
+        while mask:
+            port[0] = 1 if b & mask else 0
+            port[1] = 1
+            port[1] = 0
+            mask >>= 1
+
+
+def test(num):
+    port = bytearray(2)
+    data = bytearray(range(64))
+    for i in range(num // 10000):
+        shift_out(port, data, 64)
+
+bench.run(test)
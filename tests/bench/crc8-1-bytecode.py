@@ -0,0 +1,23 @@
+import bench
+
+
+# CRC-8 with polynomial 0x31, as used by many I2C sensors, computed bitwise.
+def crc8(data, n):
+    crc = 0xff
+    for i in range(n):
+        crc ^= data[i]
+        for bit in range(8):
+            if crc & 0x80:
+                crc = (crc << 1) ^ 0x31
+            else:
+                crc <<= 1
+        crc &= 0xff
+    return crc
+
+
+def test(num):
+    data = bytearray(range(64))
+    for i in range(num // 2000):
+        crc8(data, 64)
+
+bench.run(test)
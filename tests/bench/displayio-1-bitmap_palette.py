@@ -0,0 +1,25 @@
+import bench
+import displayio
+import displaysim
+
+# One full screen TileGrid, as used to show a sprite sheet or a background.
+WIDTH = 240
+HEIGHT = 135
+
+bitmap = displayio.Bitmap(WIDTH, HEIGHT, 16)
+for y in range(HEIGHT):
+    for x in range(WIDTH):
+        bitmap[x, y] = (x // 8 + y // 8) % 16
+palette = displayio.Palette(16)
+for i in range(16):
+    palette[i] = i * 0x101010
+group = displayio.Group()
+group.append(displayio.TileGrid(bitmap, pixel_shader=palette))
+buf = bytearray(WIDTH * HEIGHT * 2)
+
+
+def test(num):
+    for i in range(num // 20000):
+        displaysim.refresh(group, buf, WIDTH, HEIGHT)
+
+bench.run(test)
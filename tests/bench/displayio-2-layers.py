@@ -0,0 +1,43 @@
+import bench
+import displayio
+import displaysim
+
+# A scaled background under a layer of transparent tiles and a Shape, the
+# way a simple game or label screen is built.
+WIDTH = 240
+HEIGHT = 135
+
+background = displayio.Bitmap(WIDTH // 2, HEIGHT // 2 + 1, 4)
+for y in range(HEIGHT // 2 + 1):
+    for x in range(WIDTH // 2):
+        background[x, y] = (x + y) % 4
+palette = displayio.Palette(4)
+for i in range(4):
+    palette[i] = i * 0x3f3f3f
+
+sprites = displayio.Bitmap(32, 16, 2)
+for y in range(16):
+    for x in range(32):
+        sprites[x, y] = (x ^ y) & 1
+sprite_palette = displayio.Palette(2)
+sprite_palette[1] = 0xff8000
+sprite_palette.make_transparent(0)
+
+shape = displayio.Shape(40, 40)
+for y in range(40):
+    shape.set_boundary(y, 20 - min(y, 39 - y) // 2, 20 + min(y, 39 - y) // 2)
+
+root = displayio.Group(max_size=3)
+scaled = displayio.Group(scale=2)
+scaled.append(displayio.TileGrid(background, pixel_shader=palette))
+root.append(scaled)
+root.append(displayio.TileGrid(sprites, pixel_shader=sprite_palette, width=14, height=8, tile_width=16, tile_height=16))
+root.append(displayio.TileGrid(shape, pixel_shader=sprite_palette, x=100, y=50))
+buf = bytearray(WIDTH * HEIGHT * 2)
+
+
+def test(num):
+    for i in range(num // 20000):
+        displaysim.refresh(root, buf, WIDTH, HEIGHT)
+
+bench.run(test)
@@ -0,0 +1,16 @@
+import bench
+
+
+# Each raise builds its message from a compressed translate() string.
+def test(num):
+    for i in range(num // 200):
+        try:
+            int("not a number")
+        except ValueError:
+            pass
+        try:
+            [].pop()
+        except IndexError:
+            pass
+
+bench.run(test)
@@ -0,0 +1,18 @@
+import bench
+
+# Short lived objects of mixed sizes, so the heap keeps filling up and
+# collections happen as a side effect of allocation.
+class Point:
+    def __init__(self, x, y):
+        self.x = x
+        self.y = y
+
+
+def test(num):
+    for i in range(num // 40):
+        p = Point(i, i + 1)
+        l = [p, p]
+        b = bytearray(i & 63)
+        s = (p, l, b)
+
+bench.run(test)
@@ -0,0 +1,12 @@
+import bench
+import gc
+
+# Explicit collections with a live tree of objects to mark.
+tree = [[(i, j, str(j)) for j in range(20)] for i in range(100)]
+
+
+def test(num):
+    for i in range(num // 20000):
+        gc.collect()
+
+bench.run(test)
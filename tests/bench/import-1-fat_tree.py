@@ -0,0 +1,73 @@
+import bench
+import sys
+import uos
+
+
+class RAMBlockDev:
+    def __init__(self, blocks):
+        self.data = bytearray(blocks * 512)
+
+    def readblocks(self, n, buf):
+        buf[:] = memoryview(self.data)[n * 512:n * 512 + len(buf)]
+
+    def writeblocks(self, n, buf):
+        self.data[n * 512:n * 512 + len(buf)] = buf
+
+    def ioctl(self, op, arg):
+        if op == 4:
+            return len(self.data) // 512
+        if op == 5:
+            return 512
+
+
+# A package of modules like a typical CIRCUITPY library tree: a few long
+# identifiers, docstrings and string constants per function.
+MOD = '''"""Driver module %d for a made up sensor family."""
+
+_REGISTER_CONFIGURATION = const(0x%02x)
+_REGISTER_MEASUREMENT_DATA = const(0x%02x)
+
+class SensorDevice%d:
+    """Reads measurements from the sensor over a shared bus."""
+
+    def __init__(self, i2c_bus, device_address=0x%02x, sample_rate_hz=100):
+        self.i2c_bus = i2c_bus
+        self.device_address = device_address
+        self.sample_rate_hz = sample_rate_hz
+        self.measurement_buffer = bytearray(6)
+        self.status_message = "sensor %d initialised with default configuration"
+
+    def read_measurement(self):
+        """Returns the latest measurement as a tuple of three integers."""
+        buffer = self.measurement_buffer
+        self.i2c_bus.readfrom_mem_into(self.device_address, _REGISTER_MEASUREMENT_DATA, buffer)
+        return (buffer[0] << 8 | buffer[1], buffer[2] << 8 | buffer[3], buffer[4] << 8 | buffer[5])
+
+    def configure(self, sample_rate_hz, averaging_window):
+        """Applies a new sample rate and averaging window to the device."""
+        self.sample_rate_hz = sample_rate_hz
+        configuration_value = (sample_rate_hz // 10) & 0x0f | (averaging_window & 0x07) << 4
+        self.i2c_bus.writeto_mem(self.device_address, _REGISTER_CONFIGURATION, bytes([configuration_value]))
+'''
+
+NUM_MODS = 12
+
+bdev = RAMBlockDev(256)
+uos.VfsFat.mkfs(bdev)
+vfs = uos.VfsFat(bdev)
+vfs.mkdir('/lib')
+for i in range(NUM_MODS):
+    with vfs.open('/lib/sensor%d.py' % i, 'w') as f:
+        f.write(MOD % (i, i, i + 1, i, i + 0x40, i))
+uos.mount(vfs, '/fat')
+sys.path.insert(0, '/fat/lib')
+
+
+def test(num):
+    for i in range(num // 400000):
+        for j in range(NUM_MODS):
+            name = 'sensor%d' % j
+            __import__(name)
+            del sys.modules[name]
+
+bench.run(test)
@@ -0,0 +1,18 @@
+import bench
+import ujson
+
+# A settings style document with nesting, strings, ints and floats.
+DOC = {
+    'name': 'sensor node',
+    'interval': 30,
+    'enabled': True,
+    'calibration': [1.0, 0.98, 1.02, 0.5],
+    'channels': [{'id': i, 'label': 'channel %d' % i, 'gain': i * 0.5, 'tags': ['a', 'b']} for i in range(8)],
+}
+
+
+def test(num):
+    for i in range(num // 2000):
+        ujson.dumps(DOC)
+
+bench.run(test)
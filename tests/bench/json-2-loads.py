@@ -0,0 +1,18 @@
+import bench
+import ujson
+
+# The same document as json-1, parsed back from text.
+DOC = ujson.dumps({
+    'name': 'sensor node',
+    'interval': 30,
+    'enabled': True,
+    'calibration': [1.0, 0.98, 1.02, 0.5],
+    'channels': [{'id': i, 'label': 'channel %d' % i, 'gain': i * 0.5, 'tags': ['a', 'b']} for i in range(8)],
+})
+
+
+def test(num):
+    for i in range(num // 2000):
+        ujson.loads(DOC)
+
+bench.run(test)
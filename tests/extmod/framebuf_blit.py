@@ -0,0 +1,70 @@
+try:
+    import framebuf
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+def printbuf(fb, w, h):
+    print("--8<--")
+    for y in range(h):
+        print([fb.pixel(x, y) for x in range(w)])
+    print("-->8--")
+
+# 1-bit horizontal source converted to RGB565 through a palette
+src = framebuf.FrameBuffer(bytearray(2 * 3), 10, 3, framebuf.MONO_HLSB)
+for i in range(10):
+    src.pixel(i, i % 3, 1)
+pal = framebuf.FrameBuffer(bytearray(2 * 2), 2, 1, framebuf.RGB565)
+pal.pixel(0, 0, 0x1234)
+pal.pixel(1, 0, 0xf800)
+dst = framebuf.FrameBuffer(bytearray(12 * 4 * 2), 12, 4, framebuf.RGB565)
+dst.fill(0xffff)
+dst.blit(src, 1, 1, -1, pal)
+printbuf(dst, 12, 4)
+
+# transparent key is compared against the palette colour
+dst.fill(0)
+dst.blit(src, -2, 0, 0x1234, pal)
+printbuf(dst, 12, 4)
+
+# 4-bit greyscale source converted to RGB565, with and without palette
+src = framebuf.FrameBuffer(bytearray(4 * 2), 7, 2, framebuf.GS4_HMSB)
+for i in range(7):
+    src.pixel(i, 0, i)
+    src.pixel(i, 1, 15 - i)
+pal = framebuf.FrameBuffer(bytearray(16 * 2), 16, 1, framebuf.RGB565)
+for i in range(16):
+    pal.pixel(i, 0, i * 0x111)
+dst.fill(0)
+dst.blit(src, 3, 1)
+printbuf(dst, 12, 4)
+dst.fill(0)
+dst.blit(src, -1, 2, -1, pal)
+printbuf(dst, 12, 4)
+
+# same format blit at unaligned offsets
+for fmt, w, bpp in ((framebuf.MONO_HLSB, 13, 1), (framebuf.GS2_HMSB, 11, 2), (framebuf.GS4_HMSB, 9, 4)):
+    src = framebuf.FrameBuffer(bytearray(16 * 3), w, 3, fmt)
+    for y in range(3):
+        for x in range(w):
+            src.pixel(x, y, (x + y) % (1 << bpp))
+    dst = framebuf.FrameBuffer(bytearray(16 * 4), w + 3, 4, fmt)
+    dst.blit(src, 3, 1)
+    printbuf(dst, w + 3, 4)
+    dst.fill(0)
+    dst.blit(src, 0, 0)
+    dst.blit(src, -5, 2)
+    printbuf(dst, w + 3, 4)
+
+# scroll with fill, for packed and byte-aligned formats
+for fmt, w in ((framebuf.MONO_HLSB, 10), (framebuf.GS8, 5), (framebuf.MONO_VLSB, 5)):
+    fb = framebuf.FrameBuffer(bytearray(32), w, 4, fmt)
+    for y in range(4):
+        for x in range(w):
+            fb.pixel(x, y, (x ^ y) & 1)
+    fb.scroll(3, 1, 1)
+    printbuf(fb, w, 4)
+    fb.scroll(-2, -2, 0)
+    printbuf(fb, w, 4)
+    fb.scroll(w, 0, 1)
+    printbuf(fb, w, 4)
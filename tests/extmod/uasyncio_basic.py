@@ -0,0 +1,73 @@
+# test the native uasyncio event loop: tasks, sleeping and callbacks
+
+try:
+    import uasyncio as asyncio
+except ImportError:
+    print('SKIP')
+    raise SystemExit
+
+async def worker(name, n, ms):
+    for i in range(n):
+        print(name, i)
+        await asyncio.sleep_ms(ms)
+    return name
+
+async def main():
+    loop = asyncio.get_event_loop()
+    loop.create_task(worker('a', 3, 20))
+    loop.create_task(worker('b', 2, 30))
+    # awaiting a coroutine runs it inline and gives its return value
+    print('returned', await worker('c', 1, 0))
+    await asyncio.sleep(0.1)
+    return 42
+
+print(asyncio.run(main()))
+
+# a bare yield lets other tasks run
+def ping(name):
+    for i in range(2):
+        print(name, i)
+        yield
+
+loop = asyncio.get_event_loop()
+loop.create_task(ping('x'))
+loop.create_task(ping('y'))
+loop.run_forever()
+
+# plain callbacks, run in time order
+def cb(*args):
+    print('cb', args)
+
+loop.call_later_ms(20, cb, 'later')
+loop.call_later(0.01, cb, 'sooner')
+loop.call_soon(cb, 1, 2)
+loop.run_forever()
+
+# stop() from a task ends run_forever() even with timers pending
+async def stopper():
+    await asyncio.sleep_ms(0)
+    loop.stop()
+
+loop.call_later_ms(10, cb, 'after restart')
+loop.create_task(stopper())
+loop.run_forever()
+print('stopped')
+loop.run_forever()
+
+# exceptions propagate out of the loop
+async def fail():
+    await asyncio.sleep_ms(0)
+    raise ValueError('boom')
+
+try:
+    asyncio.run(fail())
+except ValueError as e:
+    print('ValueError', e)
+
+async def bad_yield():
+    yield 5
+
+try:
+    asyncio.run(bad_yield())
+except TypeError:
+    print('TypeError')
@@ -0,0 +1,37 @@
+# test the native uasyncio streams
+
+import sys
+try:
+    import uasyncio as asyncio
+    import uselect
+except ImportError:
+    print('SKIP')
+    raise SystemExit
+
+async def reader():
+    s = asyncio.StreamReader(open('io/data/file1', 'rb'))
+    print(await s.readline())
+    print(await s.read(5))
+    print(await s.read())
+    print(await s.read())
+    await s.aclose()
+
+asyncio.run(reader())
+
+async def writer():
+    w = asyncio.StreamWriter(sys.stdout)
+    await w.awrite('hello world\n')
+    await w.awrite('xxworld\n', 2)
+    await w.awrite('done!!!\n', 0, 4)
+    await w.awrite('\n')
+
+asyncio.run(writer())
+
+# waiting explicitly for readiness
+async def wait():
+    f = open('io/data/file1', 'rb')
+    await asyncio.IORead(f)
+    print(f.read(6))
+    f.close()
+
+asyncio.run(wait())
@@ -0,0 +1,105 @@
+# test that read-only .mpy files stored contiguously on FAT are used in place
+
+try:
+    import uerrno
+    import uos
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+try:
+    uos.VfsFat
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+import sys
+
+
+class RAMFS:
+
+    SEC_SIZE = 512
+
+    def __init__(self, blocks):
+        self.data = bytearray(blocks * self.SEC_SIZE)
+
+    def readblocks(self, n, buf):
+        for i in range(len(buf)):
+            buf[i] = self.data[n * self.SEC_SIZE + i]
+        return 0
+
+    def writeblocks(self, n, buf):
+        for i in range(len(buf)):
+            self.data[n * self.SEC_SIZE + i] = buf[i]
+        return 0
+
+    def ioctl(self, op, arg):
+        if op == 4:  # BP_IOCTL_SEC_COUNT
+            return len(self.data) // self.SEC_SIZE
+        if op == 5:  # BP_IOCTL_SEC_SIZE
+            return self.SEC_SIZE
+        if op == 6:  # BP_IOCTL_BUFFER
+            print("buffer", arg)
+            return memoryview(self.data)[arg * self.SEC_SIZE:]
+
+
+try:
+    bdev = RAMFS(50)
+except MemoryError:
+    print("SKIP")
+    raise SystemExit
+
+# compiled from a module with functions f, g and big, where big is 60 lines of
+# "a += 2; a += 3; ...; a += 9" so that it has a lot of bytecode
+mpy = (
+    b'M\x03\x03\x1f#\x01\x00\x00\x00\x00\x00\x0b6\x00\x17\x01f e@\x00\x00\xff`\x00$\x18\x01`\x01$\x1b\x01`\x02$ \x01\x11['
+    + b'\x08<module>\txipmod.py\x01f\x01g\x03big\x00\x03&\x06\x00\x00\x01\x00\x00\t\x18\x01\x17'
+    + b'\x01!*\x00\x00\xff\xb0\xb0\x81\xf1\xb0\x82\xf1Q\x03\xc1\x1c\x06\x01\x00\xb1d\x01\x82\xf3\xb0\xf2[\x01f\txipmod.py'
+    + b'\x03sum\x00\x00\x01x(\x05\x00\x00\x01\x00\x00\n\x1b\x01\x17\x01c@F\x00\x00\x00\x01\xff\xb0b\x01\x01#\x01\xb1b\x02\x01\x1c\xe8'
+    + b'\x00\x00\x1a\x00d\x01d\x01[\x01g\txipmod.py\x05range\x00\x02\x01n\x15\x04\x00\x00\x02\x00\x00\t\x1d'
+    + b'\x01\x17\x01a`\x00\x00\xff\xb1\x1a\x00\xf3[\x01h\txipmod.py\x00\x00\x01*\x01a#\n\x00\x00\x02\x00\x00\t8'
+    + b'\x00\x17\x01\x89\x07\x00\x00\xffQ\x00\xb1GC\x0b\x00\xc2\x1a\x00\xb2d\x01W\x145\xf2\x7f[\n<listcomp>\tx'
+    + b'ipmod.py\x00\x00\x01*\x01*'
+    + b'\x90\r\x03\x00\x00\x00\x00\x00\x81\x02 \x01\x17\x01\x81\n"' + b'\x1f!' * 60 + b'\x00\xff\x81'
+    + b'\xc0\xb0\x82\xe5\xc0\xb0\x83\xe5\xc0\xb0\x84\xe5\xc0\xb0\x85\xe5\xc0\xb0\x86\xe5\xc0\xb0\x87\xe5\xc0\xb0\x88\xe5\xc0\xb0\x89\xe5' * 60
+    + b'\xc0\xb0[\x03big\txipmod.py\x00\x00'
+)
+
+uos.VfsFat.mkfs(bdev)
+uos.mount(uos.VfsFat(bdev), "/ramdisk")
+for name in ("xip_rw.mpy", "xip_ro.mpy"):
+    with open("/ramdisk/" + name, "wb") as f:
+        f.write(mpy)
+
+# mark xip_ro.mpy read-only in its directory entry and remount to see it
+uos.umount("/ramdisk")
+entry = bytes(bdev.data).find(b"XIP_RO  MPY")
+bdev.data[entry + 11] |= 0x01  # AM_RDO
+uos.mount(uos.VfsFat(bdev), "/ramdisk")
+sys.path.append("/ramdisk")
+
+# a writable file is read into memory
+try:
+    import xip_rw
+except ValueError:
+    # the .mpy doesn't match this build
+    print("SKIP")
+    raise SystemExit
+print(xip_rw.f(3), xip_rw.g(3), xip_rw.big())
+
+# a read-only one is used from the block device's buffer
+import xip_ro
+print(xip_ro.f(3), xip_ro.g(3), xip_ro.big())
+
+# and FatFs won't let it be changed
+try:
+    open("/ramdisk/xip_ro.mpy", "wb")
+except OSError as e:
+    print(e.args[0] == uerrno.EACCES)
+try:
+    uos.remove("/ramdisk/xip_ro.mpy")
+except OSError as e:
+    print(e.args[0] == uerrno.EACCES)
+
+sys.path.pop()
+uos.umount("/ramdisk")
@@ -0,0 +1,28 @@
+# test binary ops on floats, and on floats mixed with small ints
+
+def ops(a, b):
+    return (a + b, a - b, a * b, a < b, a <= b, a > b, a >= b, a == b, a != b)
+
+for a in (0.0, 1.5, -2.25, 3):
+    for b in (0.5, -4.0, 2, 0):
+        print(a, b, ops(a, b))
+
+print(3.0 / 2, 3 / 2.0, -1.0 / 8)
+for a, b in ((1.0, 0.0), (1.0, 0), (1, 0.0), (0.0, 0.0)):
+    try:
+        a / b
+    except ZeroDivisionError:
+        print("ZeroDivisionError")
+
+inf = float("inf")
+nan = float("nan")
+print(inf + 1, inf - inf, inf * 0 != inf * 0, -inf < 1)
+print(nan < 1.0, nan > 1.0, nan <= nan, nan >= nan, nan == nan, nan != nan)
+
+# a simple low-pass filter
+y = 0.0
+x = 1.0
+for i in range(20):
+    y = y * 0.5 + x * 0.5
+    x = -x
+print("%.4f" % y)
@@ -0,0 +1,75 @@
+# test the bytecode cache for imported .py files
+
+import sys
+try:
+    import uos as os
+    os.mkdir, os.remove, os.rmdir
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+
+def rm(path):
+    try:
+        os.remove(path)
+    except OSError:
+        pass
+
+
+def load():
+    sys.modules.pop("cache_mod", None)
+    import cache_mod
+    return cache_mod.value
+
+
+def run(source):
+    with open("cache_mod.py", "w") as f:
+        f.write(source)
+    return load()
+
+
+cached = ".mpycache/cache_mod.mpy"
+rm(cached)
+try:
+    os.rmdir(".mpycache")
+except OSError:
+    pass
+os.mkdir(".mpycache")
+
+# the first import compiles and caches the module
+value = run("value = 'aaaa'\n")
+try:
+    with open(cached, "rb") as f:
+        data = f.read()
+except OSError:
+    # caching isn't supported
+    rm("cache_mod.py")
+    os.rmdir(".mpycache")
+    print("SKIP")
+    raise SystemExit
+print(value)
+print(os.listdir(".mpycache"))
+
+# later imports load the cache
+with open(cached, "wb") as f:
+    f.write(data.replace(b"aaaa", b"cccc"))
+print(load())
+
+# an edit that keeps the size is seen even within the mtime's resolution
+print(run("value = 'dddd'\n"))
+
+# a changed source is compiled again
+print(run("value = [i * 2 for i in range(4)]\n"))
+
+# a corrupt cache file is replaced
+with open(cached, "rb") as f:
+    data = f.read()
+with open(cached, "wb") as f:
+    f.write(data[:12])
+print(load())
+with open(cached, "rb") as f:
+    print(f.read() == data)
+
+rm(cached)
+rm("cache_mod.py")
+os.rmdir(".mpycache")
@@ -0,0 +1,105 @@
+import uio as io
+
+try:
+    io.BytesIO
+    io.BufferedReader
+    io.IOBase
+except AttributeError:
+    print('SKIP')
+    raise SystemExit
+
+# a raw stream that hands out data in fixed chunks and counts reads;
+# None in the chunk list means "would block"
+class Raw(io.IOBase):
+    def __init__(self, chunks):
+        self.chunks = list(chunks)
+        self.reads = 0
+
+    def readinto(self, buf):
+        self.reads += 1
+        if not self.chunks:
+            return 0
+        c = self.chunks[0]
+        if c is None:
+            self.chunks.pop(0)
+            return None
+        n = min(len(buf), len(c))
+        buf[:n] = c[:n]
+        if n == len(c):
+            self.chunks.pop(0)
+        else:
+            self.chunks[0] = c[n:]
+        return n
+
+    def ioctl(self, req, arg):
+        return 0
+
+# line protocol: one read of the raw stream per buffer, not per byte
+raw = Raw([b'HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nhello'])
+r = io.BufferedReader(raw, 64)
+print(r.readline())
+print(r.readline())
+print(r.readline())
+print(r.read(5))
+print(r.read(5))
+print(raw.reads)
+
+# lines split over several raw reads, and a line longer than the buffer
+raw = Raw([b'ab', b'c\nde', b'fghijklmnop\n', b'tail'])
+r = io.BufferedReader(raw, 4)
+print(r.readline())
+print(r.readline())
+print(r.readline())
+print(r.readline())
+
+# readline with a size limit
+r = io.BufferedReader(io.BytesIO(b'abcdef\nxyz'), 8)
+print(r.readline(3), r.readline(10), r.readline(), r.readline())
+
+# peek doesn't consume
+r = io.BufferedReader(io.BytesIO(b'peekaboo'), 4)
+print(r.peek(), r.read(2), r.peek(1), r.read())
+
+# readinto
+r = io.BufferedReader(io.BytesIO(b'0123456789'), 4)
+b = bytearray(6)
+print(r.readinto(b), b)
+print(r.readinto(b), b)
+
+# a read at least as big as the buffer bypasses it when it's empty
+raw = Raw([b'0123456789'])
+r = io.BufferedReader(raw, 4)
+print(r.read(8), raw.reads)
+
+# non-blocking: a partial line stays buffered until the newline comes
+raw = Raw([b'par', None, b'tial\nnext', None])
+r = io.BufferedReader(raw, 16)
+print(r.readline())
+print(r.readline())
+print(r.readline())
+print(r.peek())
+
+# iteration yields lines
+print(list(io.BufferedReader(io.BytesIO(b'a\nb\nc'), 2)))
+
+# seek accounts for buffered data
+r = io.BufferedReader(io.BytesIO(b'0123456789'), 4)
+print(r.read(1), r.seek(0, 1), r.read(2), r.seek(8), r.read())
+
+# context manager closes the stream
+bts = io.BytesIO(b'x')
+with io.BufferedReader(bts) as r:
+    print(r.read())
+try:
+    bts.read()
+except ValueError:
+    print('closed')
+
+try:
+    io.BufferedReader(1)
+except OSError:
+    print('OSError')
+try:
+    io.BufferedReader(io.BytesIO(), 0)
+except ValueError:
+    print('ValueError')
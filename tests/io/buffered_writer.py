@@ -25,3 +25,46 @@ bts = io.BytesIO()
 buf = io.BufferedWriter(bts, 1)
 buf.write(b"foo")
 print(bts.getvalue())
+
+# default buffer size, and flushing on close
+bts = io.BytesIO()
+buf = io.BufferedWriter(bts)
+buf.write(b"abc")
+print(bts.getvalue())
+buf.flush()
+print(bts.getvalue())
+
+# a non-blocking stream that takes only part of a flush keeps the rest buffered
+try:
+    io.IOBase
+except AttributeError:
+    raise SystemExit
+
+class Raw(io.IOBase):
+    def __init__(self):
+        self.data = b""
+        self.room = 0
+
+    def write(self, buf):
+        if self.room == 0:
+            return None
+        n = min(self.room, len(buf))
+        self.data += bytes(buf[:n])
+        self.room -= n
+        return n
+
+    def ioctl(self, req, arg):
+        return 0
+
+raw = Raw()
+raw.room = 3
+buf = io.BufferedWriter(raw, 4)
+print(buf.write(b"abcdef"), raw.data)
+print(buf.write(b"gh"), raw.data)
+try:
+    buf.flush()
+except OSError as e:
+    print("OSError", e.args[0] == 11, raw.data)
+raw.room = 100
+buf.flush()
+print(raw.data)
@@ -0,0 +1,79 @@
+# test code patterns that the bytecode emitter may fuse into superinstructions
+
+# load local, binary op with small int, store back to a local
+def count(n):
+    i = 0
+    total = 0
+    while i < n:
+        total += i
+        i += 1
+    return total
+
+print(count(10), count(0))
+
+# compare and branch in both directions
+def classify(x, y):
+    if x < y:
+        return -1
+    if not x != y:
+        return 0
+    return 1
+
+print(classify(1, 2), classify(2, 2), classify(3, 2))
+
+# two locals loaded back to back
+def mix(a, b, c):
+    return a + b, b * c, c - a
+
+print(mix(2, 3, 5))
+
+# immediate values at the edges of the signed byte range
+def edges(x):
+    return x + 127, x - 128, x * -1, x << 7, x & 255
+
+print(edges(3))
+
+# operands that are not small ints fall through to the generic path
+print(count(2.0), mix(1.5, 2, 3), edges(2 ** 70)[0])
+
+# locals numbered above 15 cannot share a byte
+def many():
+    l0 = l1 = l2 = l3 = l4 = l5 = l6 = l7 = 0
+    l8 = l9 = l10 = l11 = l12 = l13 = l14 = l15 = 0
+    l16 = 16
+    l17 = 17
+    l16 += 1
+    return l16 + l17, l15 + l16
+
+print(many())
+
+# an unbound local still raises the right error
+def unbound():
+    if 0:
+        x = 1
+    return x + 1
+
+try:
+    unbound()
+except NameError:
+    print("NameError")
+
+def unbound_jump():
+    if 0:
+        x = 1
+    while x < 3:
+        pass
+
+try:
+    unbound_jump()
+except NameError:
+    print("NameError")
+
+# an exception from the fused binary op
+def bad(x):
+    return x + 1
+
+try:
+    bad(None)
+except TypeError:
+    print("TypeError")
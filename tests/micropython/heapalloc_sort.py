@@ -0,0 +1,19 @@
+# test that list.sort still works when the heap is locked and it can't get a merge buffer
+
+import micropython
+
+try:
+    micropython.heap_lock
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+l = [(i * 7919) % 1009 for i in range(500)]
+l2 = l[:]
+micropython.heap_lock()
+l.sort()
+l2.sort(reverse=True)
+micropython.heap_unlock()
+print(l[:5], l[-5:])
+print(l2 == l[::-1])
+print(all(l[i] < l[i + 1] for i in range(len(l) - 1)))
@@ -0,0 +1,76 @@
+# test micropython.schedule() priorities and deadlines
+
+import micropython
+
+try:
+    micropython.schedule_stats
+except AttributeError:
+    print('SKIP')
+    raise SystemExit
+
+def cb(arg):
+    global done
+    print(arg)
+    done += 1
+
+# Schedule from within a callback so that the scheduler is locked and all
+# the callbacks are queued before any of them run.
+
+def fill(arg):
+    micropython.schedule(cb, 'normal 1')
+    micropython.schedule(cb, 'normal 2')
+    micropython.schedule(cb, 'urgent', 10)
+    micropython.schedule(cb, 'normal deadline', 0, 1000000)
+
+done = 0
+micropython.schedule(fill, None)
+while done != 4:
+    pass
+
+# earliest deadline first within a priority, then higher priority overall
+
+def fill(arg):
+    micropython.schedule(cb, 'late', 1, 2000000)
+    micropython.schedule(cb, 'soon', 1, 1000000)
+    micropython.schedule(cb, 'none', 1, None)
+    micropython.schedule(cb, 'high', 200)
+
+done = 0
+micropython.schedule(fill, None)
+while done != 4:
+    pass
+
+# priority is clamped to the 0-255 range
+def fill(arg):
+    micropython.schedule(cb, 'low', -5)
+    micropython.schedule(cb, 'max', 1000)
+
+done = 0
+micropython.schedule(fill, None)
+while done != 2:
+    pass
+
+# queue statistics: pending, max pending, dropped, max latency in us
+micropython.schedule_stats(True)
+print(micropython.schedule_stats())
+
+def flood(arg):
+    global done
+    try:
+        for i in range(100):
+            micropython.schedule(lambda x: x, None)
+    except RuntimeError:
+        print('RuntimeError')
+    done = True
+
+done = False
+micropython.schedule(flood, None)
+while not done:
+    pass
+while micropython.schedule_stats()[0]:
+    pass
+
+pending, max_pending, dropped, latency = micropython.schedule_stats()
+print(pending, max_pending > 1, dropped, latency >= 0)
+micropython.schedule_stats(True)
+print(micropython.schedule_stats()[1:3])
@@ -0,0 +1,65 @@
+# uheap.sites(): allocations attributed to the line and type that made them
+
+try:
+    import uheap
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+import gc
+
+
+class Point:
+    def __init__(self, x, y):
+        self.x = x
+        self.y = y
+
+
+def make(n):
+    return [Point(i, i) for i in range(n)]
+
+
+def churn(n):
+    for i in range(n):
+        b = bytearray(64)
+
+
+def find(sites, function, type_name):
+    return [s for s in sites if s[5] == function and s[6] == type_name]
+
+
+# nothing to report before tracing has started
+try:
+    uheap.sites()
+except RuntimeError:
+    print("not started")
+
+# with the default period every allocation is a sample
+uheap.start()
+make(10)
+churn(20)
+uheap.stop()
+allocs, samples, dropped = uheap.info()
+print("all sampled:", allocs == samples, dropped)
+sites = uheap.sites()
+for count, n_bytes, collects, file, line, function, type_name in find(sites, "churn", "bytearray"):
+    print("churn:", count, collects, line)
+print("points:", [s[0] for s in find(sites, "<listcomp>", "Point")])
+print("by bytes:", sorted(sites, key=lambda s: -s[1]) == sites)
+
+# a coarse period still counts every collection
+gc.collect()
+gc.threshold(2048)
+uheap.start(period=10)
+churn(1000)
+uheap.stop()
+gc.threshold(-1)
+allocs, samples, dropped = uheap.info()
+print("every 10th:", samples == allocs // 10)
+print("collected:", sum(s[2] for s in find(uheap.sites(), "churn", "bytearray")) > 0)
+
+for period in (0, -1):
+    try:
+        uheap.start(period=period)
+    except ValueError:
+        print("bad period", period)
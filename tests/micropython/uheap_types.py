@@ -0,0 +1,24 @@
+# uheap.types() counts what is live on the heap and works without tracing
+
+try:
+    import uheap
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+
+class Node:
+    def __init__(self, next):
+        self.next = next
+
+
+head = None
+for i in range(40):
+    head = Node(head)
+blobs = [bytearray(100) for i in range(5)]
+
+types = uheap.types()
+count, n_bytes = types["Node"]
+print(count >= 40, n_bytes >= 40 * 16)
+count, n_bytes = types["bytearray"]
+print(count >= 5)
@@ -0,0 +1,44 @@
+# test the uprofile sampling profiler
+
+try:
+    import uprofile
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+try:
+    uprofile.info()
+except RuntimeError:
+    print("RuntimeError")
+
+def busy(n):
+    x = 0
+    for i in range(n):
+        x = x + i * i
+    return x
+
+uprofile.start()
+# run until a few ticks of CPU time have been sampled
+while uprofile.info()[0] < 5:
+    busy(2000)
+uprofile.stop()
+
+samples, idle, dropped = uprofile.info()
+print(samples > 0, dropped)
+
+# the hottest line is in busy() and the results are sorted by count
+results = uprofile.results()
+print(results[0][3] == "busy")
+print(all(results[i][0] >= results[i + 1][0] for i in range(len(results) - 1)))
+print(sum(r[0] for r in results) + idle == samples)
+
+# dump() writes a header and one line per result
+import uio
+s = uio.StringIO()
+uprofile.dump(s)
+print(len(s.getvalue().split("\n")) == len(results) + 2)
+
+try:
+    uprofile.start(period=0)
+except ValueError:
+    print("ValueError")
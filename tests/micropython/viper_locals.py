@@ -0,0 +1,91 @@
+# test viper functions with more locals than registers, where the locals
+# that are kept in registers and those that share them depend on their use
+
+# args not used in the loop, loop counter and accumulator used a lot
+@micropython.viper
+def sum_bytes(buf:ptr8, n:int, scale:int, offset:int) -> int:
+    s = 0
+    for i in range(n):
+        s += buf[i]
+    return s * scale + offset
+
+print(sum_bytes(bytearray(b'1234'), 4, 2, 1))
+
+# locals with separate live ranges can share a register
+@micropython.viper
+def phases(n:int) -> int:
+    a = n * 2
+    b = a + 1
+    c = b * 3
+    d = 0
+    i = 0
+    while i < c:
+        d += i
+        i += 1
+    e = d - 1
+    f = e * 2
+    g = f + a
+    return g
+
+print(phases(3))
+
+# a value carried around a loop must survive the whole loop
+@micropython.viper
+def carried(n:int) -> int:
+    prev = 0
+    cur = 1
+    total = 0
+    for i in range(n):
+        nxt = prev + cur
+        prev = cur
+        cur = nxt
+        total += prev
+    return total
+
+print(carried(10))
+
+# nested loops with the outer counter used only after the inner loop
+@micropython.viper
+def nested(n:int, m:int) -> int:
+    x = 0
+    for i in range(n):
+        for j in range(m):
+            x += j
+        x += i * 100
+    return x
+
+print(nested(3, 4))
+
+# bit-banging a byte out through a ptr8 "port", as in a software SPI
+@micropython.viper
+def shift_out(port:ptr8, data:ptr8, n:int) -> int:
+    k = 0
+    for i in range(n):
+        b = data[i]
+        mask = 0x80
+        while mask:
+            port[k] = 1 if b & mask else 0
+            k += 1
+            mask >>= 1
+    return k
+
+out = bytearray(16)
+print(shift_out(out, bytearray(b'\xa5\x0f'), 2), list(out))
+
+# many locals of different types
+@micropython.viper
+def mixed(buf:ptr16, n:int) -> int:
+    lo = 0xffff
+    hi = 0
+    acc = 0
+    for i in range(n):
+        v = buf[i]
+        if v < lo:
+            lo = v
+        if v > hi:
+            hi = v
+        acc += v
+    o = (lo, hi)
+    return acc + int(len(o))
+
+print(mixed(bytearray(b'\x01\x00\x09\x00\x05\x00'), 3))
@@ -0,0 +1,26 @@
+# test pulling mixed buffers with audiosim
+try:
+    import array, audiocore, audiomixer, audiosim
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+a = audiocore.RawSample(array.array('h', [1000, -1000, 2000, -2000]), sample_rate=8000)
+b = audiocore.RawSample(array.array('h', [100, 200, 300, 400]), sample_rate=8000)
+
+# a sample on its own
+audiosim.reset(a)
+buf, more = audiosim.read(a)
+print(bytes(buf), more)
+
+mixer = audiomixer.Mixer(voice_count=2, sample_rate=8000, channel_count=1, bits_per_sample=16, samples_signed=True, buffer_size=16)
+audiosim.reset(mixer)
+buf, more = audiosim.read(mixer)
+print(bytes(buf), more)
+mixer.voice[0].play(a, loop=True)
+buf, more = audiosim.read(mixer)
+print(bytes(buf), more)
+mixer.voice[1].level = 0.5
+mixer.voice[1].play(b, loop=True)
+buf, more = audiosim.read(mixer)
+print(bytes(buf), more)
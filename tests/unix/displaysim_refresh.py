@@ -0,0 +1,37 @@
+# test rendering a Group with displaysim
+try:
+    import displayio, displaysim
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+bitmap = displayio.Bitmap(4, 2, 4)
+bitmap[1, 0] = 1
+bitmap[3, 1] = 3
+palette = displayio.Palette(4)
+palette[1] = 0xff0000
+palette[3] = 0x0000ff
+group = displayio.Group()
+group.append(displayio.TileGrid(bitmap, pixel_shader=palette))
+
+# 16 bit color, with a blank column to the right of the bitmap
+buf = bytearray(5 * 2 * 2)
+displaysim.refresh(group, buf, 5, 2)
+print(buf)
+
+# 8 bit grayscale
+buf = bytearray(4 * 2)
+displaysim.refresh(group, buf, 4, 2, depth=8)
+print(buf)
+
+# a transparent color lets the layer below show through
+palette.make_transparent(0)
+group.insert(0, displayio.TileGrid(displayio.Shape(4, 2), pixel_shader=palette))
+buf = bytearray(4 * 2 * 2)
+displaysim.refresh(group, buf, 4, 2)
+print(buf)
+
+try:
+    displaysim.refresh(group, bytearray(4), 4, 2)
+except ValueError:
+    print("ValueError")
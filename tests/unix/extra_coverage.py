@@ -45,6 +45,13 @@ print(stream2.read(1)) # read 1 byte encounters non-blocking error with textio s
 stream.set_error(uerrno.EAGAIN)
 buf = uio.BufferedWriter(stream, 8)
 print(buf.write(bytearray(16)))
+stream.set_error(uerrno.EIO)
+buf = uio.BufferedWriter(stream, 8)
+try:
+    buf.write(bytearray(16))
+except OSError as er:
+    print('OSError', er.args[0] == uerrno.EIO)
+print(buf.flush()) # the failed write left nothing buffered
 
 # test basic import of frozen scripts
 import frzstr1
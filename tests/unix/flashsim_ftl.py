@@ -0,0 +1,104 @@
+# test the flash translation layer on a simulated NOR flash
+
+try:
+    import flashsim
+    import uos
+    uos.VfsFat
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+seed = 1
+def rnd(n):
+    global seed
+    seed = (seed * 1103515245 + 12345) & 0x7fffffff
+    return (seed >> 8) % n
+
+def block(tag, n):
+    b = bytearray(512)
+    b[0] = tag & 0xff
+    b[1] = tag >> 8
+    b[511] = n
+    return b
+
+# capacity and the block device protocol
+f = flashsim.FlashSim(16)
+print(f.ioctl(4, 0), f.ioctl(5, 0))
+buf = bytearray(512)
+f.readblocks(3, buf)
+print(buf == b'\xff' * 512)
+f.writeblocks(3, block(1, 3))
+f.readblocks(3, buf)
+print(buf == block(1, 3))
+try:
+    f.writeblocks(f.ioctl(4, 0), buf)
+except OSError:
+    print('OSError')
+
+# random writes, losing power part way through some of them
+f = flashsim.FlashSim(8)
+n = f.ioctl(4, 0)
+ref = [b'\xff' * 512] * n
+ok = True
+for op in range(1500):
+    if rnd(4) == 0:
+        f.cut_power(1 + rnd(30))
+    b = rnd(n)
+    data = block(op, b)
+    try:
+        f.writeblocks(b, data)
+        ref[b] = data
+    except OSError:
+        f.power_cycle()
+        f.readblocks(b, buf)
+        # An interrupted write leaves either the old or the new data.
+        if buf == data:
+            ref[b] = data
+    if rnd(30) == 0:
+        while f.background():
+            pass
+    if rnd(50) == 0:
+        f.power_cycle()
+f.power_cycle()
+for b in range(n):
+    f.readblocks(b, buf)
+    ok = ok and buf == ref[b]
+print(ok)
+
+# rewriting a small file, as when saving code.py over and over
+def rewrite(bdev):
+    uos.VfsFat.mkfs(bdev)
+    vfs = uos.VfsFat(bdev)
+    for i in range(100):
+        with vfs.open('code.py', 'w') as fh:
+            fh.write('print(%d)\n' % i * 20)
+    return vfs
+
+raw = flashsim.FlashSim(64, translate=False)
+rewrite(raw)
+ftl = flashsim.FlashSim(64)
+rewrite(ftl)
+ftl.power_cycle()
+with uos.VfsFat(ftl).open('code.py', 'r') as fh:
+    print(fh.read() == 'print(99)\n' * 20)
+raw_stats = raw.stats()
+ftl_stats = ftl.stats()
+print(raw_stats['host_writes'] == ftl_stats['host_writes'])
+print(ftl_stats['erases'] * 3 < raw_stats['erases'])
+print(ftl_stats['max_erase'] * 4 < raw_stats['max_erase'])
+
+# static data doesn't keep its sectors from wearing
+f = flashsim.FlashSim(16)
+n = f.ioctl(4, 0)
+for b in range(n):
+    f.writeblocks(b, block(0, b))
+for op in range(12000):
+    f.writeblocks(op % 4, block(op, op % 4))
+    if op % 8 == 0:
+        f.background()
+s = f.stats()
+print(s['max_erase'] - s['min_erase'] < 80)
+for b in range(4, n):
+    f.readblocks(b, buf)
+    ok = ok and buf == block(0, b)
+print(ok)
@@ -0,0 +1,97 @@
+# test executing .mpy files in place from a memory mapped file
+
+import gc, sys
+try:
+    import uio as io
+    import uos as os
+    io.IOBase
+    os.mount
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+# compiled from a module with functions f, g and big, where big is 60 lines of
+# "a += 2; a += 3; ...; a += 9" so that it has a lot of bytecode
+mpy = (
+    b'M\x03\x03\x1f#\x01\x00\x00\x00\x00\x00\x0b6\x00\x17\x01f e@\x00\x00\xff`\x00$\x18\x01`\x01$\x1b\x01`\x02$ \x01\x11['
+    + b'\x08<module>\txipmod.py\x01f\x01g\x03big\x00\x03&\x06\x00\x00\x01\x00\x00\t\x18\x01\x17'
+    + b'\x01!*\x00\x00\xff\xb0\xb0\x81\xf1\xb0\x82\xf1Q\x03\xc1\x1c\x06\x01\x00\xb1d\x01\x82\xf3\xb0\xf2[\x01f\txipmod.py'
+    + b'\x03sum\x00\x00\x01x(\x05\x00\x00\x01\x00\x00\n\x1b\x01\x17\x01c@F\x00\x00\x00\x01\xff\xb0b\x01\x01#\x01\xb1b\x02\x01\x1c\xe8'
+    + b'\x00\x00\x1a\x00d\x01d\x01[\x01g\txipmod.py\x05range\x00\x02\x01n\x15\x04\x00\x00\x02\x00\x00\t\x1d'
+    + b'\x01\x17\x01a`\x00\x00\xff\xb1\x1a\x00\xf3[\x01h\txipmod.py\x00\x00\x01*\x01a#\n\x00\x00\x02\x00\x00\t8'
+    + b'\x00\x17\x01\x89\x07\x00\x00\xffQ\x00\xb1GC\x0b\x00\xc2\x1a\x00\xb2d\x01W\x145\xf2\x7f[\n<listcomp>\tx'
+    + b'ipmod.py\x00\x00\x01*\x01*'
+    + b'\x90\r\x03\x00\x00\x00\x00\x00\x81\x02 \x01\x17\x01\x81\n"' + b'\x1f!' * 60 + b'\x00\xff\x81'
+    + b'\xc0\xb0\x82\xe5\xc0\xb0\x83\xe5\xc0\xb0\x84\xe5\xc0\xb0\x85\xe5\xc0\xb0\x86\xe5\xc0\xb0\x87\xe5\xc0\xb0\x88\xe5\xc0\xb0\x89\xe5' * 60
+    + b'\xc0\xb0[\x03big\txipmod.py\x00\x00'
+)
+
+
+
+# a filesystem whose files can't be mapped, so that the same image is loaded
+# the ordinary way for comparison
+class UserFile(io.IOBase):
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+    def readinto(self, buf):
+        n = min(len(buf), len(self.data) - self.pos)
+        buf[:n] = self.data[self.pos:self.pos + n]
+        self.pos += n
+        return n
+    def ioctl(self, req, arg):
+        return 0
+
+
+class UserFS:
+    def mount(self, readonly, mkfs):
+        pass
+    def umount(self):
+        pass
+    def stat(self, path):
+        if path == "/mpy_xip_copy.mpy":
+            return (32768, 0, 0, 0, 0, 0, 0, 0, 0, 0)
+        raise OSError
+    def open(self, path, mode):
+        return UserFile(mpy)
+
+
+def heap_used_by_import(name):
+    gc.collect()
+    before = gc.mem_alloc()
+    __import__(name)
+    gc.collect()
+    return gc.mem_alloc() - before
+
+
+with open("mpy_xip_mod.mpy", "wb") as f:
+    f.write(mpy)
+os.mount(UserFS(), "/userfs")
+sys.path.append("/userfs")
+
+try:
+    used_copy = heap_used_by_import("mpy_xip_copy")
+except ValueError:
+    # the .mpy doesn't match this build
+    os.unlink("mpy_xip_mod.mpy")
+    print("SKIP")
+    raise SystemExit
+finally:
+    sys.path.pop()
+    os.umount("/userfs")
+
+used_xip = heap_used_by_import("mpy_xip_mod")
+import mpy_xip_mod
+print(mpy_xip_mod.f(3), mpy_xip_mod.g(3), mpy_xip_mod.big())
+
+# the bytecode stays in the file rather than being copied to the heap, so
+# the import uses at least the size of big's bytecode less than a copy does
+print(used_copy - used_xip > 60 * 24)
+
+# the code runs from a copy taken at import, so rewriting the file doesn't
+# change it and removing the file doesn't free it
+with open("mpy_xip_mod.mpy", "r+b") as f:
+    f.write(bytes(len(mpy)))
+print(mpy_xip_mod.f(4), mpy_xip_mod.big())
+os.unlink("mpy_xip_mod.mpy")
+print(mpy_xip_mod.f(5), mpy_xip_mod.big())
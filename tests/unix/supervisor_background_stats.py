@@ -0,0 +1,26 @@
+# test timing of background work reported by supervisor.background_stats
+
+try:
+    import flashsim
+    import supervisor
+    supervisor.background_stats
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+supervisor.reset_background_stats()
+print(supervisor.background_stats())
+
+f = flashsim.FlashSim(16)
+for i in range(5):
+    f.background()
+
+stats = supervisor.background_stats()
+print(list(stats.keys()))
+calls, total_us, max_us, max_gap_us = stats["filesystem"]
+print(calls)
+print(0 <= max_us <= total_us)
+print(max_gap_us >= 0)
+
+supervisor.reset_background_stats()
+print(supervisor.background_stats())
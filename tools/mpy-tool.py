@@ -77,6 +77,14 @@ MP_BC_LOAD_NAME = 0x1c
 MP_BC_LOAD_GLOBAL = 0x1d
 MP_BC_LOAD_ATTR = 0x1e
 MP_BC_STORE_ATTR = 0x26
+# superinstructions, with a fixed number of extra bytes:
+MP_BC_SUPERINSTRUCTION_EXTRA_BYTES = {
+    0x48: 1, # LOAD_FAST_LOAD_FAST
+    0x49: 3, # BINARY_OP_FAST_IMM
+    0x4a: 4, # BINARY_OP_FAST_IMM_STORE
+    0x4b: 1, # BINARY_OP_POP_JUMP_IF_FALSE
+    0x4c: 1, # BINARY_OP_POP_JUMP_IF_TRUE
+}
 
 # load opcode names
 opcode_names = {}
@@ -118,8 +126,8 @@ def make_opcode_format():
     OC4(U, O, B, O), # 0x3c-0x3f
     OC4(O, B, B, O), # 0x40-0x43
     OC4(B, B, O, B), # 0x44-0x47
-    OC4(U, U, U, U), # 0x48-0x4b
-    OC4(U, U, U, U), # 0x4c-0x4f
+    OC4(B, B, B, O), # 0x48-0x4b
+    OC4(O, U, U, U), # 0x4c-0x4f
     OC4(V, V, U, V), # 0x50-0x53
     OC4(B, U, V, V), # 0x54-0x57
     OC4(V, V, V, B), # 0x58-0x5b
@@ -191,6 +199,7 @@ def mp_opcode_format(bytecode, ip, opcode_format=make_opcode_format()):
                 or opcode == MP_BC_STORE_ATTR
             )
         )
+        extra_byte = MP_BC_SUPERINSTRUCTION_EXTRA_BYTES.get(opcode, extra_byte)
         ip += 1
         if f == MP_OPCODE_VAR_UINT:
             while bytecode[ip] & 0x80 != 0:
@@ -489,6 +498,7 @@ def read_mpy(filename):
         feature_flags = header[2]
         config.MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE = (feature_flags & 1) != 0
         config.MICROPY_PY_BUILTINS_STR_UNICODE = (feature_flags & 2) != 0
+        config.MICROPY_OPT_SUPERINSTRUCTIONS = (feature_flags & 4) != 0
         config.mp_small_int_bits = header[3]
         return read_raw_code(f)
 
@@ -518,6 +528,12 @@ def freeze_mpy(base_qstrs, raw_codes):
     print('#endif')
     print()
 
+    if config.MICROPY_OPT_SUPERINSTRUCTIONS:
+        print('#if !MICROPY_OPT_SUPERINSTRUCTIONS')
+        print('#error "frozen bytecode needs MICROPY_OPT_SUPERINSTRUCTIONS"')
+        print('#endif')
+        print()
+
     print('#if MICROPY_LONGINT_IMPL != %u' % config.MICROPY_LONGINT_IMPL)
     print('#error "incompatible MICROPY_LONGINT_IMPL"')
     print('#endif')